@@ -0,0 +1,203 @@
+#include "AMG.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace Eigen;
+
+AMGPreconditioner::AMGPreconditioner() : _strength(0.08), _coarseSize(200), _maxLevels(12) {}
+
+void AMGPreconditioner::setNearNullspace(const vector<int>& dofNode, const MatrixXd& B) {
+    _dofNode = dofNode;
+    _nullspace = B;
+}
+
+int AMGPreconditioner::aggregate(const RowMatrix& A, const vector<int>& dofNode, int nbNodes,
+                                 vector<int>& aggregateOf) const {
+    // Graphe nodal : norme de Frobenius des blocs 2x2 couplant deux noeuds
+    vector<Triplet<double>> triplets;
+    triplets.reserve(A.nonZeros());
+    for (int i = 0; i < A.outerSize(); i++) {
+        for (RowMatrix::InnerIterator it(A, i); it; ++it) {
+            triplets.push_back(Triplet<double>(dofNode[i], dofNode[it.col()], it.value() * it.value()));
+        }
+    }
+    RowMatrix G(nbNodes, nbNodes);
+    G.setFromTriplets(triplets.begin(), triplets.end());
+
+    VectorXd diag = VectorXd::Zero(nbNodes);
+    for (int I = 0; I < nbNodes; I++) {
+        for (RowMatrix::InnerIterator it(G, I); it; ++it) {
+            if (it.col() == I) diag(I) = sqrt(it.value());
+        }
+    }
+
+    // Couplages forts : ||A_IJ|| >= theta sqrt(||A_II|| ||A_JJ||)
+    vector<int> strongStart(nbNodes + 1, 0), strong;
+    strong.reserve(G.nonZeros());
+    for (int I = 0; I < nbNodes; I++) {
+        for (RowMatrix::InnerIterator it(G, I); it; ++it) {
+            int J = it.col();
+            if (J != I && sqrt(it.value()) >= _strength * sqrt(diag(I) * diag(J))) strong.push_back(J);
+        }
+        strongStart[I + 1] = strong.size();
+    }
+
+    // Passe 1 : un noeud dont aucun voisin fort n'est agrégé démarre un agrégat
+    // (noeuds isolés, par exemple entièrement bloqués, laissés hors agrégat)
+    aggregateOf.assign(nbNodes, -1);
+    int nbAggregates = 0;
+    for (int I = 0; I < nbNodes; I++) {
+        if (aggregateOf[I] >= 0 || strongStart[I] == strongStart[I + 1]) continue;
+        bool free = true;
+        for (int k = strongStart[I]; k < strongStart[I + 1]; k++) {
+            if (aggregateOf[strong[k]] >= 0) { free = false; break; }
+        }
+        if (!free) continue;
+        aggregateOf[I] = nbAggregates;
+        for (int k = strongStart[I]; k < strongStart[I + 1]; k++) aggregateOf[strong[k]] = nbAggregates;
+        nbAggregates++;
+    }
+
+    // Passe 2 : rattacher les noeuds restants à un agrégat voisin
+    vector<int> pass1 = aggregateOf;
+    for (int I = 0; I < nbNodes; I++) {
+        if (aggregateOf[I] >= 0) continue;
+        for (int k = strongStart[I]; k < strongStart[I + 1]; k++) {
+            if (pass1[strong[k]] >= 0) {
+                aggregateOf[I] = pass1[strong[k]];
+                break;
+            }
+        }
+    }
+
+    // Passe 3 : les noeuds encore libres forment des agrégats avec leurs voisins libres
+    for (int I = 0; I < nbNodes; I++) {
+        if (aggregateOf[I] >= 0 || strongStart[I] == strongStart[I + 1]) continue;
+        aggregateOf[I] = nbAggregates;
+        for (int k = strongStart[I]; k < strongStart[I + 1]; k++) {
+            if (aggregateOf[strong[k]] < 0) aggregateOf[strong[k]] = nbAggregates;
+        }
+        nbAggregates++;
+    }
+
+    return nbAggregates;
+}
+
+void AMGPreconditioner::tentativeProlongation(const vector<int>& dofNode, const vector<int>& aggregateOf,
+                                              int nbAggregates, const MatrixXd& B, const vector<char>& isolated,
+                                              RowMatrix& P, MatrixXd& coarseB, vector<int>& coarseDofNode) const {
+    int n = dofNode.size();
+    int k0 = B.cols();
+
+    // DDL de chaque agrégat
+    vector<vector<int>> dofs(nbAggregates);
+    for (int i = 0; i < n; i++) {
+        int a = aggregateOf[dofNode[i]];
+        if (a >= 0 && !isolated[i]) dofs[a].push_back(i);
+    }
+
+    // QR locale des modes rigides : P_tent = Q (orthonormé), B_coarse = R
+    vector<int> offset(nbAggregates + 1, 0);
+    for (int a = 0; a < nbAggregates; a++) offset[a + 1] = offset[a] + min(k0, (int)dofs[a].size());
+    int nc = offset[nbAggregates];
+
+    coarseB.setZero(nc, k0);
+    coarseDofNode.resize(nc);
+    vector<Triplet<double>> triplets;
+    triplets.reserve((size_t)n * k0);
+
+    for (int a = 0; a < nbAggregates; a++) {
+        int nd = dofs[a].size();
+        int k = offset[a + 1] - offset[a];
+        if (k == 0) continue;
+
+        MatrixXd Ba(nd, k0);
+        for (int r = 0; r < nd; r++) Ba.row(r) = B.row(dofs[a][r]);
+
+        HouseholderQR<MatrixXd> qr(Ba);
+        MatrixXd Q = qr.householderQ() * MatrixXd::Identity(nd, k);
+        MatrixXd R = qr.matrixQR().topRows(k).triangularView<Upper>();
+
+        for (int r = 0; r < nd; r++) {
+            for (int c = 0; c < k; c++) {
+                if (Q(r, c) != 0.0) triplets.push_back(Triplet<double>(dofs[a][r], offset[a] + c, Q(r, c)));
+            }
+        }
+        coarseB.middleRows(offset[a], k) = R;
+        for (int c = 0; c < k; c++) coarseDofNode[offset[a] + c] = a;
+    }
+
+    P.resize(n, nc);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void AMGPreconditioner::setup(const RowMatrix& A) {
+    _levels.clear();
+    _info = Success;
+
+    int n = A.rows();
+    vector<int> dofNode = _dofNode;
+    MatrixXd B = _nullspace;
+    if ((int)dofNode.size() != n || B.rows() != n) {
+        // Sans information géométrique : blocs scalaires et mode constant
+        dofNode.resize(n);
+        for (int i = 0; i < n; i++) dofNode[i] = i;
+        B = MatrixXd::Ones(n, 1);
+    }
+
+    RowMatrix current = A;
+    while (true) {
+        Level L = makeLevel(current);
+
+        int nl = L.A.rows();
+        if (nl <= _coarseSize || (int)_levels.size() + 1 >= _maxLevels) {
+            _levels.push_back(L);
+            break;
+        }
+
+        // DDL isolés (lignes identité des DDL bloqués) : exclus de la hiérarchie
+        vector<char> isolated(nl, 1);
+        for (int i = 0; i < nl; i++) {
+            for (RowMatrix::InnerIterator it(L.A, i); it; ++it) {
+                if (it.col() != i && it.value() != 0.0) { isolated[i] = 0; break; }
+            }
+        }
+
+        int nbNodes = 0;
+        for (int I : dofNode) nbNodes = max(nbNodes, I + 1);
+
+        vector<int> aggregateOf;
+        int nbAggregates = aggregate(L.A, dofNode, nbNodes, aggregateOf);
+
+        RowMatrix Ptent;
+        MatrixXd coarseB;
+        vector<int> coarseDofNode;
+        tentativeProlongation(dofNode, aggregateOf, nbAggregates, B, isolated, Ptent, coarseB, coarseDofNode);
+
+        int nc = Ptent.cols();
+        if (nc == 0 || nc > 0.8 * nl) {
+            // Le grossissement stagne : ce niveau devient le plus grossier
+            _levels.push_back(L);
+            break;
+        }
+
+        // Lissage du prolongement : P = (I - omega D^-1 A) P_tent
+        double omega = 4.0 / (3.0 * L.lambdaMax);
+        RowMatrix DAP = L.invDiag.asDiagonal() * (L.A * Ptent);
+        L.P = Ptent - omega * DAP;
+        L.R = L.P.transpose();
+
+        // Opérateur grossier de Galerkin
+        RowMatrix coarse = L.R * (L.A * L.P);
+        coarse.prune(1e-14 * coarse.norm() / sqrt((double)coarse.rows()));
+        current = coarse;
+
+        _levels.push_back(L);
+        dofNode.swap(coarseDofNode);
+        B.swap(coarseB);
+    }
+
+    factorCoarsest("AMG");
+}
@@ -0,0 +1,47 @@
+#ifndef AMG_H
+#define AMG_H
+
+#include "Multigrid.h"
+#include <vector>
+
+class AMGPreconditioner : public MultigridPreconditioner {
+    // Préconditionneur multigrille algébrique par agrégation lissée (smoothed aggregation)
+    // pour l'élasticité 2D. Les noeuds sont regroupés en agrégats à partir du graphe des
+    // couplages forts, le prolongement provisoire reproduit exactement les modes rigides
+    // (2 translations + 1 rotation) sur chaque agrégat, puis il est lissé par Jacobi.
+
+    private:
+        // Modes rigides et noeud de chaque DDL du niveau fin
+        std::vector<int> _dofNode;
+        Eigen::MatrixXd _nullspace;
+
+        double _strength;               // seuil des couplages forts
+        int _coarseSize;                // taille sous laquelle on résout directement
+        int _maxLevels;
+
+        void setup(const RowMatrix& A);
+        int aggregate(const RowMatrix& A, const std::vector<int>& dofNode, int nbNodes,
+                      std::vector<int>& aggregateOf) const;
+        void tentativeProlongation(const std::vector<int>& dofNode, const std::vector<int>& aggregateOf,
+                                   int nbAggregates, const Eigen::MatrixXd& B, const std::vector<char>& isolated,
+                                   RowMatrix& P, Eigen::MatrixXd& coarseB, std::vector<int>& coarseDofNode) const;
+
+    public:
+        AMGPreconditioner();
+
+        // À appeler avant compute() : noeud de chaque DDL et modes rigides (une ligne par DDL)
+        void setNearNullspace(const std::vector<int>& dofNode, const Eigen::MatrixXd& B);
+
+        // Interface préconditionneur Eigen
+        template <typename MatType>
+        AMGPreconditioner& analyzePattern(const MatType&) { return *this; }
+        template <typename MatType>
+        AMGPreconditioner& factorize(const MatType& mat) {
+            setup(RowMatrix(mat));
+            return *this;
+        }
+        template <typename MatType>
+        AMGPreconditioner& compute(const MatType& mat) { return factorize(mat); }
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "Batch.h"
+#include "Config.h"
+#include "Tests.h"
+#include "MeshCache.h"
+#include "Parallel.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+namespace {
+
+string jsonString(const string& value) {
+    string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    ostringstream s;
+    s << setprecision(12) << value;
+    return s.str();
+}
+
+// Coût estimé d'un job : taille du fichier de maillage, x4 par raffinement, x nombre de points
+double estimatedCost(const Config& config) {
+    ifstream file(config.meshFile, ios::binary | ios::ate);
+    double size = file.is_open() ? (double)file.tellg() : 0.0;
+    return size * pow(4.0, config.refine) * max(1, config.sweepCount);
+}
+
+}
+
+int runBatch(const string& jobsFile, const string& summaryFile) {
+    ifstream list(jobsFile);
+    if (!list.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << jobsFile << endl;
+        return 1;
+    }
+    vector<string> files;
+    string line;
+    while (getline(list, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#') files.push_back(line);
+    }
+    
+    int n = files.size();
+    vector<Config> configs(n);
+    vector<double> cost(n);
+    for (int j = 0; j < n; j++) {
+        configs[j].loadFromFile(files[j]);
+        cost[j] = estimatedCost(configs[j]);
+    }
+    
+    // Les fichiers de sortie ne dépendent que de output_dir et output_prefix : deux jobs qui les
+    // partagent écriraient en même temps dans les mêmes fichiers
+    map<string, int> outputs;
+    int conflicts = 0;
+    for (int j = 0; j < n; j++) {
+        string dir = configs[j].outputDir;
+        while (dir.size() > 1 && dir[dir.size() - 1] == '/') dir.erase(dir.size() - 1);
+        string key = dir + "/" + configs[j].outputFilePrefix;
+        auto inserted = outputs.insert({key, j});
+        if (!inserted.second) {
+            cerr << "Erreur : les jobs " << inserted.first->second << " (" << files[inserted.first->second] << ") et "
+                 << j << " (" << files[j] << ") écrivent dans " << key << "_*, donner à chacun son output_prefix"
+                 << endl;
+            conflicts++;
+        }
+        if (configs[j].numThreads > 0) {
+            cerr << "Attention : num_threads de " << files[j] << " ignoré en mode batch (un thread par job, "
+                 << "nombre total fixé par OMP_NUM_THREADS)" << endl;
+        }
+    }
+    if (conflicts > 0) return conflicts;
+    
+    // Jobs les plus coûteux d'abord : avec la distribution dynamique, les petits jobs
+    // comblent la fin et équilibrent la charge
+    vector<int> order(n);
+    for (int j = 0; j < n; j++) order[j] = j;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] > cost[b]; });
+    
+    cout << "=== Batch : " << n << " jobs sur " << numThreads() << " threads ===" << endl;
+    
+    MeshCache meshes;
+    setMeshCache(&meshes);
+    vector<TestResults> results(n);
+    vector<double> elapsed(n);
+    vector<int> worker(n);
+    
+    typedef chrono::high_resolution_clock Clock;
+    auto t0 = Clock::now();
+    
+    // Chaque job s'exécute entièrement dans un thread ; ses boucles parallèles internes
+    // (imbriquées) n'utilisent alors que ce thread
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < n; k++) {
+        int j = order[k];
+        ostringstream log;
+        setTestOutput(&log);
+        configs[j].print(log);
+        auto t1 = Clock::now();
+        results[j] = runTest(configs[j]);
+        elapsed[j] = chrono::duration<double>(Clock::now() - t1).count();
+        worker[j] = threadId();
+        setTestOutput(nullptr);
+        
+        #pragma omp critical(batchOutput)
+        {
+            cout << "\n=== Job " << j << " : " << files[j] << " (thread " << worker[j] << ", "
+                 << elapsed[j] << " s) ===\n" << log.str() << flush;
+        }
+    }
+    double total = chrono::duration<double>(Clock::now() - t0).count();
+    setMeshCache(nullptr);
+    
+    // Résumé : une ligne JSON par job
+    ofstream summary(summaryFile);
+    if (!summary.is_open()) cerr << "Erreur : impossible d'écrire " << summaryFile << endl;
+    int failures = 0;
+    double sum = 0.0;
+    for (int j = 0; j < n; j++) {
+        bool ok = !results[j].empty();
+        for (const auto& r : results[j]) ok = ok && std::isfinite(r.second);
+        if (!ok) failures++;
+        sum += elapsed[j];
+        
+        summary << "{\"job\": " << j << ", \"config\": " << jsonString(files[j])
+                << ", \"test\": " << jsonString(configs[j].sweepCount > 0 ? "sweep" : configs[j].testType)
+                << ", \"mesh\": " << jsonString(configs[j].meshFile)
+                << ", \"status\": " << jsonString(ok ? "ok" : "echec")
+                << ", \"thread\": " << worker[j] << ", \"time_s\": " << jsonNumber(elapsed[j])
+                << ", \"results\": {";
+        bool first = true;
+        for (const auto& r : results[j]) {
+            summary << (first ? "" : ", ") << jsonString(r.first) << ": " << jsonNumber(r.second);
+            first = false;
+        }
+        summary << "}}\n";
+    }
+    
+    cout << "\n=== Batch terminé ===" << endl;
+    cout << "  " << n << " jobs, " << failures << " en échec, " << total << " s (somme des jobs : " << sum << " s)" << endl;
+    cout << "  Maillages lus : " << meshes.misses() << ", repris du cache : " << meshes.hits() << endl;
+    cout << "  Résumé : " << summaryFile << endl;
+    return failures;
+}
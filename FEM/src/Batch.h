@@ -0,0 +1,17 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+
+// Mode batch : les configurations listées dans jobsFile (un chemin par ligne, lignes vides et
+// commentaires '#' ignorés) sont exécutées dans le même processus, en parallèle sur les threads
+// OpenMP. Chaque maillage (fichier, raffinements) n'est lu qu'une fois grâce au cache partagé.
+// Les messages de chaque job sont affichés d'un bloc à sa fin ; résultats et temps de tous les
+// jobs sont écrits dans summaryFile (une ligne JSON par job, dans l'ordre de jobsFile).
+// Chaque job tourne sur un seul thread : son num_threads est ignoré (avertissement), le
+// nombre de jobs simultanés suit OMP_NUM_THREADS. Des jobs partageant output_dir et
+// output_prefix sont refusés avant tout calcul.
+// Retourne le nombre de jobs en échec (ou de conflits de sortie).
+int runBatch(const std::string& jobsFile, const std::string& summaryFile);
+
+#endif
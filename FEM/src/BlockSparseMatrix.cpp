@@ -0,0 +1,193 @@
+#include "BlockSparseMatrix.h"
+#include <algorithm>
+#include <cmath>
+// Noyau AVX2/FMA compilé par attribut de fonction (option FEM_AVX2, x86 et GCC/Clang) et
+// choisi à l'exécution : le reste du programme ne suppose aucune extension du processeur
+#if defined(FEM_AVX2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FEM_BSR_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace Eigen;
+
+void BlockSparseMatrix::symbolic(const Mesh& mesh) {
+    int nn = mesh.nbNodes();
+    int ne = mesh.nbElements();
+
+    // Voisins de chaque noeud (lui-même compris), triés : une ligne de blocs
+    rowStart.assign(nn + 1, 0);
+    blockCol.clear();
+    blockCol.reserve(7 * nn);
+    vector<int> neighbours;
+    for (int i = 0; i < nn; i++) {
+        neighbours.clear();
+        neighbours.push_back(i);
+        for (int k = mesh.nodeElementStart[i]; k < mesh.nodeElementStart[i + 1]; k++) {
+            const int32_t* n = mesh.elementNodes(mesh.nodeElements[k]);
+            neighbours.insert(neighbours.end(), n, n + 3);
+        }
+        sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        blockCol.insert(blockCol.end(), neighbours.begin(), neighbours.end());
+        rowStart[i + 1] = blockCol.size();
+    }
+    values.assign(4 * blockCol.size(), 0.0);
+
+    scatter.resize(9 * (size_t)ne);
+    for (int e = 0; e < ne; e++) {
+        const int32_t* n = mesh.elementNodes(e);
+        for (int a = 0; a < 3; a++) {
+            const int* first = &blockCol[rowStart[n[a]]];
+            const int* last = &blockCol[rowStart[n[a] + 1]];
+            for (int b = 0; b < 3; b++) {
+                scatter[9*(size_t)e + 3*a + b] = rowStart[n[a]] + (lower_bound(first, last, n[b]) - first);
+            }
+        }
+    }
+}
+
+void BlockSparseMatrix::assemble(const Mesh& mesh) {
+    std::fill(values.begin(), values.end(), 0.0);
+
+    // Même principe que l'assemblage CSR : une couleur à la fois, sans conflit d'écriture
+    for (int c = 0; c < mesh.nbColors(); c++) {
+        #pragma omp parallel for schedule(static)
+        for (int k = mesh.colorStart[c]; k < mesh.colorStart[c + 1]; k++) {
+            int e = mesh.colorElements[k];
+            if (mesh.elementArea[e] < 1e-12) continue;
+
+            ElementMatrix Ke;
+            mesh.elementStiffness(e, Ke);
+
+            const int* blocks = &scatter[9*(size_t)e];
+            for (int a = 0; a < 3; a++) {
+                for (int b = 0; b < 3; b++) {
+                    double* v = &values[4 * (size_t)blocks[3*a + b]];
+                    v[0] += Ke(2*a, 2*b);
+                    v[1] += Ke(2*a, 2*b + 1);
+                    v[2] += Ke(2*a + 1, 2*b);
+                    v[3] += Ke(2*a + 1, 2*b + 1);
+                }
+            }
+        }
+    }
+}
+
+void BlockSparseMatrix::applyConstraints(const vector<char>& constrained) {
+    int nn = rowStart.size() - 1;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < nn; i++) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+            int j = blockCol[k];
+            double* v = &values[4 * (size_t)k];
+            for (int d = 0; d < 2; d++) {
+                for (int c = 0; c < 2; c++) {
+                    if (constrained[2*i + d] || constrained[2*j + c]) {
+                        v[2*d + c] = (i == j && c == d) ? 1.0 : 0.0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int BlockSparseMatrix::diagonalBlock(int node) const {
+    const int* first = &blockCol[rowStart[node]];
+    const int* last = &blockCol[rowStart[node + 1]];
+    return rowStart[node] + (lower_bound(first, last, node) - first);
+}
+
+static void applyScalar(int nn, const int* rowStart, const int* blockCol, const double* vp,
+                        const double* xp, double* yp) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < nn; i++) {
+        double y0 = 0.0, y1 = 0.0;
+        for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+            const double* v = vp + 4 * (size_t)k;
+            double x0 = xp[2 * blockCol[k]], x1 = xp[2 * blockCol[k] + 1];
+            y0 += v[0] * x0 + v[1] * x1;
+            y1 += v[2] * x0 + v[3] * x1;
+        }
+        yp[2 * i] = y0;
+        yp[2 * i + 1] = y1;
+    }
+}
+
+#ifdef FEM_BSR_AVX2
+__attribute__((target("avx2,fma")))
+static void applyAVX2(int nn, const int* rowStart, const int* blockCol, const double* vp,
+                      const double* xp, double* yp) {
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < nn; i++) {
+        // [a00 a01 a10 a11] * [x0 x1 x0 x1], réduction horizontale en fin de ligne
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        int k = rowStart[i];
+        for (; k + 1 < rowStart[i + 1]; k += 2) {
+            __m256d x0 = _mm256_broadcast_pd((const __m128d*)(xp + 2 * blockCol[k]));
+            __m256d x1 = _mm256_broadcast_pd((const __m128d*)(xp + 2 * blockCol[k + 1]));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(vp + 4 * (size_t)k), x0, acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(vp + 4 * (size_t)k + 4), x1, acc1);
+        }
+        if (k < rowStart[i + 1]) {
+            __m256d x0 = _mm256_broadcast_pd((const __m128d*)(xp + 2 * blockCol[k]));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(vp + 4 * (size_t)k), x0, acc0);
+        }
+        __m256d acc = _mm256_add_pd(acc0, acc1);
+        __m128d sum = _mm_hadd_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        _mm_storeu_pd(yp + 2 * i, sum);
+    }
+}
+#endif
+
+bool BlockSparseMatrix::usesAVX2() {
+#ifdef FEM_BSR_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void BlockSparseMatrix::apply(const VectorXd& x, VectorXd& y) const {
+    int nn = rowStart.size() - 1;
+    y.resize(2 * nn);
+#ifdef FEM_BSR_AVX2
+    if (usesAVX2()) {
+        applyAVX2(nn, rowStart.data(), blockCol.data(), values.data(), x.data(), y.data());
+        return;
+    }
+#endif
+    applyScalar(nn, rowStart.data(), blockCol.data(), values.data(), x.data(), y.data());
+}
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(const BlockSparseMatrix& A) {
+    int nn = A.rows() / 2;
+    invBlocks.resize(4 * (size_t)nn);
+    for (int i = 0; i < nn; i++) {
+        const double* v = &A.values[4 * (size_t)A.diagonalBlock(i)];
+        double det = v[0] * v[3] - v[1] * v[2];
+        double* inv = &invBlocks[4 * (size_t)i];
+        if (abs(det) > 0.0) {
+            inv[0] = v[3] / det;   inv[1] = -v[1] / det;
+            inv[2] = -v[2] / det;  inv[3] = v[0] / det;
+        } else {
+            // Bloc singulier (noeud isolé) : identité
+            inv[0] = 1.0;  inv[1] = 0.0;
+            inv[2] = 0.0;  inv[3] = 1.0;
+        }
+    }
+}
+
+void BlockJacobiPreconditioner::apply(const VectorXd& r, VectorXd& z) const {
+    int nn = invBlocks.size() / 4;
+    z.resize(2 * nn);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < nn; i++) {
+        const double* inv = &invBlocks[4 * (size_t)i];
+        double r0 = r(2*i), r1 = r(2*i + 1);
+        z(2*i) = inv[0] * r0 + inv[1] * r1;
+        z(2*i + 1) = inv[2] * r0 + inv[3] * r1;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef BLOCK_SPARSE_MATRIX_H
+#define BLOCK_SPARSE_MATRIX_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include "Mesh.h"
+
+class BlockSparseMatrix {
+    // Matrice creuse par blocs 2x2 (format BSR) : un bloc par couple de noeuds voisins,
+    // donc un seul indice de colonne pour 4 coefficients. Les lignes de blocs suivent les
+    // slots des noeuds et les deux moitiés de la matrice symétrique sont stockées, ce qui
+    // permet un produit matrice-vecteur ligne par ligne, parallèle et sans conflit d'écriture.
+    // Un bloc est rangé par lignes : a00 a01 a10 a11.
+
+    public:
+        std::vector<int> rowStart;      // premier bloc de chaque ligne (nbNodes + 1)
+        std::vector<int> blockCol;      // noeud colonne de chaque bloc
+        std::vector<double> values;     // 4 coefficients par bloc
+        std::vector<int> scatter;       // 9 blocs par élément : indice du bloc (a, b)
+
+        BlockSparseMatrix() {}
+
+        // Structure calculée une fois à partir de la connectivité, puis assemblage des Ke
+        void symbolic(const Mesh& mesh);
+        void assemble(const Mesh& mesh);
+
+        // Lignes et colonnes des DDL imposés remplacées par l'identité
+        void applyConstraints(const std::vector<char>& constrained);
+
+        // y = A x (noyau AVX2/FMA si compilé avec FEM_AVX2 et supporté par le processeur)
+        void apply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+        static bool usesAVX2();
+
+        int rows() const { return rowStart.empty() ? 0 : 2 * ((int)rowStart.size() - 1); }
+        int nbBlocks() const { return blockCol.size(); }
+        int diagonalBlock(int node) const;
+        size_t indexBytes() const { return (rowStart.size() + blockCol.size()) * sizeof(int); }
+        size_t memoryUsage() const { return indexBytes() + values.size() * sizeof(double); }
+};
+
+// Préconditionneur de Jacobi par blocs : inverse des blocs 2x2 diagonaux
+class BlockJacobiPreconditioner {
+public:
+    std::vector<double> invBlocks;
+
+    explicit BlockJacobiPreconditioner(const BlockSparseMatrix& A);
+
+    void apply(const Eigen::VectorXd& r, Eigen::VectorXd& z) const;
+};
+
+#endif
@@ -10,42 +10,56 @@ void BoundaryConditions::addDirichlet(int dof, double value) {
     _dirichletValues.push_back(value);
 }
 
-void BoundaryConditions::fixNode(int nodeId) {
-    int dof_x = 2 * (nodeId - 1);
-    int dof_y = 2 * (nodeId - 1) + 1;
+bool BoundaryConditions::checkNode(int nodeId) const {
+    if (_mesh->hasNode(nodeId)) return true;
+    cerr << "Erreur : noeud " << nodeId << " inexistant, condition aux limites rejetée" << endl;
+    return false;
+}
+
+bool BoundaryConditions::fixNode(int nodeId) {
+    if (!checkNode(nodeId)) return false;
+    int dof_x = _mesh->dof(nodeId, 0);
+    int dof_y = _mesh->dof(nodeId, 1);
     addDirichlet(dof_x, 0.0);
     addDirichlet(dof_y, 0.0);
+    return true;
 }
 
-void BoundaryConditions::fixNodeX(int nodeId) {
-    int dof_x = 2 * (nodeId - 1);
+bool BoundaryConditions::fixNodeX(int nodeId) {
+    if (!checkNode(nodeId)) return false;
+    int dof_x = _mesh->dof(nodeId, 0);
     addDirichlet(dof_x, 0.0);
+    return true;
 }
 
-void BoundaryConditions::fixNodeY(int nodeId) {
-    int dof_y = 2 * (nodeId - 1) + 1;
+bool BoundaryConditions::fixNodeY(int nodeId) {
+    if (!checkNode(nodeId)) return false;
+    int dof_y = _mesh->dof(nodeId, 1);
     addDirichlet(dof_y, 0.0);
+    return true;
 }
 
-void BoundaryConditions::addForce(int nodeId, const Vector2d& force) {
+bool BoundaryConditions::addForce(int nodeId, const Vector2d& force) {
+    if (!checkNode(nodeId)) return false;
     _neumannNodes.push_back(nodeId);
     _neumannForces.push_back(force);
+    return true;
 }
 
-void BoundaryConditions::addForceX(int nodeId, double fx) {
-    addForce(nodeId, Vector2d(fx, 0.0));
+bool BoundaryConditions::addForceX(int nodeId, double fx) {
+    return addForce(nodeId, Vector2d(fx, 0.0));
 }
 
-void BoundaryConditions::addForceY(int nodeId, double fy) {
-    addForce(nodeId, Vector2d(0.0, fy));
+bool BoundaryConditions::addForceY(int nodeId, double fy) {
+    return addForce(nodeId, Vector2d(0.0, fy));
 }
 
 void BoundaryConditions::apply(SparseMatrix<double>& K, VectorXd& F) const {
     // Appliquer les forces (Neumann)
     for (size_t i = 0; i < _neumannNodes.size(); i++) {
         int nodeId = _neumannNodes[i];
-        int dof_x = 2 * (nodeId - 1);
-        int dof_y = 2 * (nodeId - 1) + 1;
+        int dof_x = _mesh->dof(nodeId, 0);
+        int dof_y = _mesh->dof(nodeId, 1);
         
         F(dof_x) += _neumannForces[i].x();
         F(dof_y) += _neumannForces[i].y();
@@ -4,6 +4,7 @@
 #include <vector>
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
+#include "Mesh.h"
 
 using namespace std;
 using namespace Eigen;
@@ -15,6 +16,9 @@ enum class BCType {
 
 class BoundaryConditions {
 private:
+    // Maillage de référence pour convertir les tags de noeuds en DDL
+    const Mesh* _mesh;
+    
     // Conditions de Dirichlet (déplacements imposés)
     vector<int> _dirichletDofs;
     vector<double> _dirichletValues;
@@ -23,23 +27,28 @@ private:
     vector<int> _neumannNodes;
     vector<Vector2d> _neumannForces;
     
+    bool checkNode(int nodeId) const;
+    
 public:
-    BoundaryConditions() = default;
+    explicit BoundaryConditions(const Mesh& mesh) : _mesh(&mesh) {}
     
     // Ajouter une condition de Dirichlet sur un DDL
     void addDirichlet(int dof, double value);
     
+    // Conditions par tag de noeud : retournent false (message sur cerr, condition rejetée)
+    // si le noeud n'existe pas dans le maillage
+    
     // Bloquer complètement un noeud (ux=0, uy=0)
-    void fixNode(int nodeId);
+    bool fixNode(int nodeId);
     
     // Bloquer seulement en X ou Y
-    void fixNodeX(int nodeId);
-    void fixNodeY(int nodeId);
+    bool fixNodeX(int nodeId);
+    bool fixNodeY(int nodeId);
     
     // Ajouter une force sur un noeud
-    void addForce(int nodeId, const Vector2d& force);
-    void addForceX(int nodeId, double fx);
-    void addForceY(int nodeId, double fy);
+    bool addForce(int nodeId, const Vector2d& force);
+    bool addForceX(int nodeId, double fx);
+    bool addForceY(int nodeId, double fy);
     
     // Appliquer les conditions aux limites sur K et F
     void apply(SparseMatrix<double>& K, VectorXd& F) const;
@@ -14,6 +14,53 @@ Config::Config() {
     forceValue = 1000.0;
     outputDir = "../results";
     outputFilePrefix = "test";
+    outputFormat = "vtk";
+    outputPieces = 1;
+    solverMode = "assembled";
+    bcMethod = "lifting";
+    linearSolver = "cg";
+    amgSmoother = "chebyshev";
+    matrixFormat = "csr";
+    precision = "double";
+    cgImplementation = "eigen";
+    refine = 0;
+    elementMatrixCache = false;
+    meshCache = false;
+    meshMargin = 1.0;
+    meshSizeInterface = 0.0;
+    meshSizeMax = 0.0;
+    meshGrading = 0.3;
+    meshMinAngle = 20.0;
+    meshPeriodic = false;
+    detectBlur = 2.0;
+    detectMinRadius = 44;
+    detectMaxRadius = 50;
+    detectMinDist = 100.0;
+    detectEdgeThreshold = 10.0;
+    detectVoteThreshold = 6;
+    detectReference = "";
+    detectMinRecall = 0.8;
+    numThreads = 0;
+    benchmarkRepeat = 10;
+    homogenizationBC = "affine";
+    fftPhases = "geometry";
+    fftResolution = 512;
+    fftThreshold = 0;
+    fftFiberDark = false;
+    fftTolerance = 1e-6;
+    fftMaxIterations = 1000;
+    fftCrossCheck = false;
+    pixelTolerance = 1e-6;
+    pixelMaxIterations = 500;
+    sweepMin = sweepMax = 0.0;
+    sweepCount = 0;
+    fiberFraction = 0.3;
+    fiberRadius = 0.05;
+    fiberGap = 0.005;
+    ensembleMin = 8;
+    ensembleMax = 200;
+    ensembleTolerance = 0.005;
+    ensembleSeed = 1;
 }
 
 void Config::loadFromFile(const string& filename) {
@@ -37,6 +84,131 @@ void Config::loadFromFile(const string& filename) {
     forceValue = getDouble("force_value", 1000.0);
     outputDir = getString("output_dir", "../results");
     outputFilePrefix = getString("output_prefix", "test");
+    outputFormat = getString("output_format", "vtk");
+    outputPieces = (int)getDouble("output_pieces", 1);
+    
+    solverMode = getString("solver_mode", "assembled");
+    bcMethod = getString("bc_method", "lifting");
+    linearSolver = getString("solver", "cg");
+    amgSmoother = getString("amg_smoother", "chebyshev");
+    matrixFormat = getString("matrix_format", "csr");
+    precision = getString("precision", "double");
+    cgImplementation = getString("cg_implementation", "eigen");
+    refine = (int)getDouble("refine", 0);
+    elementMatrixCache = getBool("element_matrix_cache", false);
+    meshCache = getBool("mesh_cache", false);
+    meshCircles = getString("mesh_circles", "");
+    meshMargin = getDouble("mesh_margin", 1.0);
+    meshSizeInterface = getDouble("mesh_size_interface", 0.0);
+    meshSizeMax = getDouble("mesh_size_max", 0.0);
+    meshGrading = getDouble("mesh_grading", 0.3);
+    meshMinAngle = getDouble("mesh_min_angle", 20.0);
+    meshPeriodic = getBool("mesh_periodic", false);
+    if (meshMargin < 0.0) {
+        cerr << "Attention : mesh_margin doit être >= 0, utilisation de 1" << endl;
+        meshMargin = 1.0;
+    }
+    meshImage = getString("mesh_image", "");
+    detectBlur = getDouble("detect_blur", 2.0);
+    detectMinRadius = (int)getDouble("detect_min_radius", 44);
+    detectMaxRadius = (int)getDouble("detect_max_radius", 50);
+    detectMinDist = getDouble("detect_min_dist", 100.0);
+    detectEdgeThreshold = getDouble("detect_edge_threshold", 10.0);
+    detectVoteThreshold = (int)getDouble("detect_vote_threshold", 6);
+    detectReference = getString("detect_reference", "");
+    detectMinRecall = getDouble("detect_min_recall", 0.8);
+    if (detectMinRadius < 1) {
+        cerr << "Attention : detect_min_radius doit être >= 1, utilisation de 1" << endl;
+        detectMinRadius = 1;
+    }
+    if (detectMaxRadius < detectMinRadius) {
+        cerr << "Attention : detect_max_radius < detect_min_radius, utilisation de " << detectMinRadius << endl;
+        detectMaxRadius = detectMinRadius;
+    }
+    if (detectMinRecall < 0.0 || detectMinRecall > 1.0) {
+        cerr << "Attention : detect_min_recall doit être entre 0 et 1, utilisation de 0.8" << endl;
+        detectMinRecall = 0.8;
+    }
+    if (meshGrading <= 0.0) {
+        cerr << "Attention : mesh_grading doit être > 0, utilisation de 0.3" << endl;
+        meshGrading = 0.3;
+    }
+    if (meshMinAngle > 30.0) {
+        cerr << "Attention : mesh_min_angle doit être <= 30 degrés (raffinement sans fin au-delà), utilisation de 20" << endl;
+        meshMinAngle = 20.0;
+    }
+    numThreads = (int)getDouble("num_threads", 0);
+    benchmarkRepeat = (int)getDouble("benchmark_repeat", 10);
+    homogenizationBC = getString("homogenization_bc", "affine");
+    fftPhases = getString("fft_phases", "geometry");
+    fftResolution = (int)getDouble("fft_resolution", 512);
+    fftThreshold = (int)getDouble("fft_threshold", 0);
+    fftFiberDark = getBool("fft_fiber_dark", false);
+    fftTolerance = getDouble("fft_tolerance", 1e-6);
+    fftMaxIterations = (int)getDouble("fft_max_iterations", 1000);
+    fftCrossCheck = getBool("fft_cross_check", false);
+    pixelTolerance = getDouble("pixel_tolerance", 1e-6);
+    pixelMaxIterations = (int)getDouble("pixel_max_iterations", 500);
+    if (fftPhases != "geometry" && fftPhases != "threshold") {
+        cerr << "Attention : fft_phases inconnu '" << fftPhases << "', utilisation de geometry" << endl;
+        fftPhases = "geometry";
+    }
+    if (fftResolution < 8) {
+        cerr << "Attention : fft_resolution doit être >= 8, utilisation de 8" << endl;
+        fftResolution = 8;
+    }
+    if (fftThreshold > 255) {
+        cerr << "Attention : fft_threshold doit être <= 255, utilisation du seuil d'Otsu" << endl;
+        fftThreshold = 0;
+    }
+    fiberFraction = getDouble("fiber_fraction", 0.3);
+    fiberRadius = getDouble("fiber_radius", 0.05);
+    fiberGap = getDouble("fiber_gap", 0.1 * fiberRadius);
+    if (params.find("ensemble_grid") != params.end()) {
+        cerr << "Attention : ensemble_grid n'est plus utilisé (VER maillés par le mailleur, voir mesh_size_*)" << endl;
+    }
+    ensembleMin = (int)getDouble("ensemble_min", 8);
+    ensembleMax = (int)getDouble("ensemble_max", 200);
+    ensembleTolerance = getDouble("ensemble_tolerance", 0.005);
+    ensembleSeed = (int)getDouble("ensemble_seed", 1);
+    ensembleLayouts = getString("ensemble_layouts", "");
+    if (ensembleMin < 2) {
+        cerr << "Attention : ensemble_min doit être >= 2, utilisation de 2" << endl;
+        ensembleMin = 2;
+    }
+    if (ensembleMax < ensembleMin) {
+        cerr << "Attention : ensemble_max < ensemble_min, utilisation de " << ensembleMin << endl;
+        ensembleMax = ensembleMin;
+    }
+    
+    // Balayage : la clé lue est "sweep <paramètre>"
+    for (const auto& p : params) {
+        if (p.first.compare(0, 6, "sweep ") != 0) continue;
+        string name = p.first.substr(6);
+        name.erase(0, name.find_first_not_of(" \t"));
+        if (name != "Young_modulus" && name != "Poisson_ratio" &&
+            name != "Young_modulus_fiber" && name != "Poisson_ratio_fiber") {
+            cerr << "Attention : paramètre de balayage inconnu '" << name << "', ignoré" << endl;
+            continue;
+        }
+        double a, b;
+        int n;
+        char sep1, sep2;
+        istringstream range(p.second);
+        if (!(range >> a >> sep1 >> b >> sep2 >> n) || sep1 != ':' || sep2 != ':' || n < 1) {
+            cerr << "Attention : plage de balayage invalide '" << p.second << "' (attendu min:max:n), ignorée" << endl;
+            continue;
+        }
+        sweepParameter = name;
+        sweepMin = a;
+        sweepMax = b;
+        sweepCount = n;
+    }
+}
+
+double Config::sweepValue(int k) const {
+    if (sweepCount <= 1) return sweepMin;
+    return sweepMin + (sweepMax - sweepMin) * k / (sweepCount - 1);
 }
 
 void Config::parseFile(const string& filename) {
@@ -59,6 +231,10 @@ void Config::parseFile(const string& filename) {
             string key = line.substr(0, pos);
             string value = line.substr(pos + 1);
             
+            // Commentaire en fin de ligne
+            size_t comment = value.find('#');
+            if (comment != string::npos) value.erase(comment);
+            
             // Enlever les espaces
             key.erase(0, key.find_first_not_of(" \t"));
             key.erase(key.find_last_not_of(" \t") + 1);
@@ -92,24 +268,77 @@ string Config::getString(const string& key, const string& defaultValue) const {
     return defaultValue;
 }
 
-void Config::print() const {
-    cout << "=== Configuration ===" << endl;
-    cout << "Type de test: " << testType << endl;
-    cout << "Fichier de maillage: " << meshFile << endl;
-    cout << "\nMatériau 1 (matrice):" << endl;
-    cout << "  Module de Young: " << E << " Pa" << endl;
-    cout << "  Coefficient de Poisson: " << nu << endl;
-    cout << "  Densité: " << rho << " kg/m³" << endl;
+bool Config::getBool(const string& key, bool defaultValue) const {
+    auto it = params.find(key);
+    if (it != params.end()) {
+        const string& v = it->second;
+        return v == "true" || v == "1" || v == "yes" || v == "oui";
+    }
+    return defaultValue;
+}
+
+void Config::print(ostream& out) const {
+    out << "=== Configuration ===" << endl;
+    out << "Type de test: " << testType << endl;
+    if (!meshImage.empty()) {
+        out << "Maillage généré: fibres détectées dans " << meshImage << " (rayons " << detectMinRadius << " à "
+            << detectMaxRadius << " px), marge " << meshMargin << ", gradation " << meshGrading
+            << ", angle minimal " << meshMinAngle << (meshPeriodic ? ", périodique" : "") << endl;
+        if (!detectReference.empty()) {
+            out << "Validation de la détection: " << detectReference << " (rappel minimal " << detectMinRecall << ")" << endl;
+        }
+    } else if (meshCircles.empty()) {
+        out << "Fichier de maillage: " << meshFile << (meshCache ? " (instantané binaire)" : "") << endl;
+    } else {
+        out << "Maillage généré: cercles de " << meshCircles << ", marge " << meshMargin << ", gradation " << meshGrading
+            << ", angle minimal " << meshMinAngle << (meshPeriodic ? ", périodique" : "") << endl;
+    }
+    out << "\nMatériau 1 (matrice):" << endl;
+    out << "  Module de Young: " << E << " Pa" << endl;
+    out << "  Coefficient de Poisson: " << nu << endl;
+    out << "  Densité: " << rho << " kg/m³" << endl;
     
     if (hasFiber) {
-        cout << "\nMatériau 2 (fibre):" << endl;
-        cout << "  Module de Young: " << E_fiber << " Pa" << endl;
-        cout << "  Coefficient de Poisson: " << nu_fiber << endl;
-        cout << "  Densité: " << rho_fiber << " kg/m³" << endl;
+        out << "\nMatériau 2 (fibre):" << endl;
+        out << "  Module de Young: " << E_fiber << " Pa" << endl;
+        out << "  Coefficient de Poisson: " << nu_fiber << endl;
+        out << "  Densité: " << rho_fiber << " kg/m³" << endl;
     }
     
-    cout << "\nForce appliquée: " << forceValue << " N" << endl;
-    cout << "Répertoire de sortie: " << outputDir << endl;
-    cout << "Préfixe de sortie: " << outputFilePrefix << endl;
-    cout << endl;
+    out << "\nForce appliquée: " << forceValue << " N" << endl;
+    out << "Répertoire de sortie: " << outputDir << endl;
+    out << "Préfixe de sortie: " << outputFilePrefix << endl;
+    out << "Format de sortie: " << outputFormat;
+    if (outputFormat == "vtu" && outputPieces > 1) out << " (" << outputPieces << " morceaux)";
+    out << endl;
+    out << "Mode de résolution: " << solverMode << (elementMatrixCache ? " (cache Ke)" : "")
+         << ", solveur " << linearSolver << " (" << matrixFormat << ", " << precision
+         << (cgImplementation != "eigen" ? ", " + cgImplementation : "") << "), CL par " << bcMethod << endl;
+    if (refine > 0) out << "Raffinements uniformes: " << refine << endl;
+    if (testType == "homogenization") out << "CL d'homogénéisation: " << homogenizationBC << endl;
+    if (testType == "fft" || testType == "pixel") {
+        out << (testType == "fft" ? "Homogénéisation FFT: " : "Grille de pixels: ");
+        if (fftPhases == "threshold") {
+            out << "seuillage de " << meshImage << " (";
+            if (fftThreshold > 0) out << "seuil " << fftThreshold;
+            else out << "seuil d'Otsu";
+            out << (fftFiberDark ? ", fibres sombres)" : ", fibres claires)");
+        } else {
+            out << fftResolution << " pixels sur le plus grand côté";
+        }
+        if (testType == "fft") out << ", tolérance " << fftTolerance << (fftCrossCheck ? ", comparaison à l'essai composite" : "") << endl;
+        else out << ", tolérance " << pixelTolerance << endl;
+    }
+    if (testType == "ensemble") {
+        out << "Ensemble: ";
+        if (ensembleLayouts.empty()) out << "fraction de fibre " << fiberFraction << ", rayon " << fiberRadius << ", graine " << ensembleSeed;
+        else out << "arrangements de " << ensembleLayouts;
+        out << ", " << ensembleMin << " à " << ensembleMax
+            << " réalisations, tolérance " << ensembleTolerance << endl;
+    }
+    if (sweepCount > 0) {
+        out << "Balayage: " << sweepParameter << " de " << sweepMin << " à " << sweepMax
+             << " (" << sweepCount << " points)" << endl;
+    }
+    out << endl;
 }
@@ -3,14 +3,36 @@
 
 #include <string>
 #include <map>
+#include <iostream>
 
 class Config {
 public:
     // Type de test
-    std::string testType;  // "traction" ou "flexion"
+    std::string testType;  // "traction", "flexion", "composite", "homogenization", "fft", "pixel", "ensemble" ou "benchmark"
     
     // Fichier de maillage
     std::string meshFile;
+    bool meshCache;        // instantané binaire du maillage lu (<mesh_file>.snap)
+    
+    // Maillage généré en mémoire à partir d'une liste de cercles (remplace mesh_file)
+    std::string meshCircles;     // fichier au format cercles.txt ("x y r", axe y des images)
+    double meshMargin;           // marge entre les cercles et le bord du rectangle
+    double meshSizeInterface;    // longueur des arêtes aux interfaces (0 : automatique)
+    double meshSizeMax;          // taille maximale des éléments (0 : automatique)
+    double meshGrading;          // croissance de la taille avec la distance aux interfaces
+    double meshMinAngle;         // angle minimal des triangles en degrés (0 : pas de raffinement)
+    bool meshPeriodic;           // bords opposés identiques (imposé si homogenization_bc = periodic)
+    
+    // Fibres détectées dans une micrographie (remplace mesh_circles) : transformée de Hough,
+    // paramètres de cv::HoughCircles dans Preprocessing/traitement.py
+    std::string meshImage;       // image PNG ou PGM
+    double detectBlur;           // écart type du flou gaussien (pixels)
+    int detectMinRadius, detectMaxRadius;
+    double detectMinDist;        // distance minimale entre centres
+    double detectEdgeThreshold;  // seuil haut des contours (param1)
+    int detectVoteThreshold;     // votes minimaux d'un centre (param2)
+    std::string detectReference; // cercles de référence de la même image (validation, optionnel)
+    double detectMinRecall;      // fraction minimale de cercles de référence retrouvés
     
     // Propriétés matériau 1 (matrice ou unique)
     double E;      // Module de Young (Pa)
@@ -29,16 +51,65 @@ public:
     // Fichiers de sortie
     std::string outputDir;
     std::string outputFilePrefix;
+    std::string outputFormat;    // "vtk" (ASCII historique, par défaut) ou "vtu" (XML binaire, champs de contrainte)
+    int outputPieces;            // morceaux VTU écrits en parallèle (> 1 : index .pvtu)
+    
+    // Résolution
+    std::string solverMode;      // "assembled" ou "matrix_free"
+    std::string bcMethod;        // "lifting" ou "reduction"
+    std::string linearSolver;    // "cg", "cholesky", "amg" ou "gmg" (mode assemblé)
+    std::string amgSmoother;     // "chebyshev" ou "jacobi" (solver = amg ou gmg)
+    std::string matrixFormat;    // "csr" ou "bsr" (blocs 2x2 nodaux, gradient conjugué)
+    std::string precision;       // "double" ou "mixed" (solver = cg, format csr)
+    std::string cgImplementation; // "eigen", "fused" ou "pipelined" (solver = cg, précision double)
+    int refine;                  // raffinements uniformes du maillage lu (0 = aucun)
+    bool elementMatrixCache;     // conserver les Ke de chaque élément
+    int numThreads;              // 0 = valeur par défaut
+    int benchmarkRepeat;         // répétitions pour test_type = benchmark
+    std::string homogenizationBC; // "affine" (déplacements imposés au contour) ou "periodic"
+    
+    // Homogénéisation sur une image de phases : spectrale (test_type = fft) ou éléments finis
+    // sur la grille de pixels (test_type = pixel). Les clés fft_phases, fft_resolution,
+    // fft_threshold et fft_fiber_dark décrivent l'image des deux modes.
+    std::string fftPhases;       // "geometry" (maillage ou cercles pixellisés) ou "threshold" (mesh_image seuillée)
+    int fftResolution;           // pixels sur le plus grand côté (geometry)
+    int fftThreshold;            // niveau de gris séparant les phases (0 : seuil d'Otsu)
+    bool fftFiberDark;           // fibres plus sombres que la matrice
+    double fftTolerance;         // résidu relatif du gradient conjugué
+    int fftMaxIterations;
+    bool fftCrossCheck;          // comparer E_x à l'essai composite éléments finis
+    double pixelTolerance;       // résidu relatif du gradient conjugué (test_type = pixel)
+    int pixelMaxIterations;
+    
+    // Balayage paramétrique : "sweep <paramètre> = min:max:n", n valeurs régulièrement espacées
+    // d'un paramètre matériau (Young_modulus, Poisson_ratio, Young_modulus_fiber, Poisson_ratio_fiber)
+    std::string sweepParameter;
+    double sweepMin, sweepMax;
+    int sweepCount;              // 0 = pas de balayage
+    
+    double sweepValue(int k) const;
+    
+    // Ensemble de VER aléatoires (test_type = ensemble) : essai composite sur des arrangements
+    // de fibres tirés au hasard (ou lus dans ensembleLayouts), chacun maillé par meshFiberRVE
+    // (tailles meshSizeInterface, meshSizeMax, meshGrading)
+    double fiberFraction;        // fraction volumique de fibre visée
+    double fiberRadius;          // rayon des fibres (VER de côté 1)
+    double fiberGap;             // distance minimale entre fibres et au bord
+    int ensembleMin, ensembleMax; // nombre de réalisations minimal et maximal
+    double ensembleTolerance;    // demi-largeur relative visée de l'intervalle de confiance à 95 %
+    int ensembleSeed;
+    std::string ensembleLayouts; // fichier d'arrangements (format cercles.txt), vide : tirage
     
     Config();
     void loadFromFile(const std::string& filename);
-    void print() const;
+    void print(std::ostream& out = std::cout) const;
 
 private:
     std::map<std::string, std::string> params;
     void parseFile(const std::string& filename);
     double getDouble(const std::string& key, double defaultValue) const;
     std::string getString(const std::string& key, const std::string& defaultValue) const;
+    bool getBool(const std::string& key, bool defaultValue) const;
 };
 
 #endif
@@ -0,0 +1,97 @@
+#include "ElasticityOperator.h"
+#include "Material.h"
+
+using namespace std;
+using namespace Eigen;
+
+ElasticityOperator::ElasticityOperator(const Mesh& mesh) : _mesh(mesh) {
+    _C.resize(_mesh.materials.size(), Matrix3d::Zero());
+    for (size_t m = 0; m < _mesh.materials.size(); m++) {
+        if (_mesh.materials[m] != nullptr) _C[m] = _mesh.materials[m]->getC();
+    }
+}
+
+void ElasticityOperator::applyElements(const VectorXd& x, VectorXd& y) const {
+    y.setZero(x.size());
+
+    // Parcours par couleur : aucun noeud partagé dans une couleur, donc pas de conflit
+    // d'écriture dans y et un résultat indépendant du nombre de threads
+    for (int c = 0; c < _mesh.nbColors(); c++) {
+        #pragma omp parallel for schedule(static)
+        for (int k = _mesh.colorStart[c]; k < _mesh.colorStart[c + 1]; k++) {
+            int e = _mesh.colorElements[k];
+            if (_mesh.elementArea[e] < 1e-12) continue;
+
+            const int32_t* n = _mesh.elementNodes(e);
+            Matrix<double, 6, 1> xe, ye;
+            for (int j = 0; j < 3; j++) {
+                xe(2*j) = x(2*n[j]);
+                xe(2*j+1) = x(2*n[j]+1);
+            }
+
+            if (!_mesh.elementMatrices.empty()) {
+                ElementMatrix Ke;
+                _mesh.elementStiffness(e, Ke);
+                ye.noalias() = Ke * xe;
+            } else {
+                // Ke x = A B^T C B x, sans former Ke
+                ElementB B;
+                _mesh.elementB(e, B);
+                Vector3d strain = B * xe;
+                Vector3d stress = _C[_mesh.elementMaterial[e]] * strain;
+                ye.noalias() = _mesh.elementArea[e] * (B.transpose() * stress);
+            }
+
+            for (int j = 0; j < 3; j++) {
+                y(2*n[j]) += ye(2*j);
+                y(2*n[j]+1) += ye(2*j+1);
+            }
+        }
+    }
+}
+
+void ElasticityOperator::applyFull(const VectorXd& x, VectorXd& y) const {
+    applyElements(x, y);
+}
+
+void ElasticityOperator::apply(const VectorXd& x, VectorXd& y) const {
+    if (_constrained.empty()) {
+        applyElements(x, y);
+        return;
+    }
+
+    _masked = x;
+    for (int i = 0; i < _masked.size(); i++) {
+        if (_constrained[i]) _masked(i) = 0.0;
+    }
+    applyElements(_masked, y);
+    for (int i = 0; i < y.size(); i++) {
+        if (_constrained[i]) y(i) = x(i);
+    }
+}
+
+VectorXd ElasticityOperator::diagonal() const {
+    VectorXd diag = VectorXd::Zero(rows());
+    ElementMatrix Ke;
+
+    for (int e = 0; e < _mesh.nbElements(); e++) {
+        const int32_t* n = _mesh.elementNodes(e);
+        _mesh.elementStiffness(e, Ke);
+        for (int k = 0; k < 3; k++) {
+            diag(2*n[k]) += Ke(2*k, 2*k);
+            diag(2*n[k]+1) += Ke(2*k+1, 2*k+1);
+        }
+    }
+
+    for (int i = 0; i < diag.size(); i++) {
+        if (!_constrained.empty() && _constrained[i]) diag(i) = 1.0;
+    }
+    return diag;
+}
+
+size_t ElasticityOperator::memoryUsage() const {
+    size_t bytes = _C.size() * sizeof(Matrix3d) + rows();
+    bytes += _mesh.elementMatrices.capacity() * sizeof(double);
+    bytes += (size_t)rows() * sizeof(double);  // vecteur masqué
+    return bytes;
+}
@@ -0,0 +1,39 @@
+#ifndef ELASTICITY_OPERATOR_H
+#define ELASTICITY_OPERATOR_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include "Mesh.h"
+
+class ElasticityOperator {
+    // Opérateur de rigidité appliqué sans assembler K : y = K x est calculé élément par élément.
+    // Si le maillage conserve ses matrices Ke (cache compact), elles sont utilisées directement,
+    // sinon chaque contribution est recalculée à partir de la géométrie et de la matrice C.
+    // Les DDL imposés (Dirichlet) sont traités par masquage : lignes et colonnes remplacées par l'identité.
+
+    private:
+        const Mesh& _mesh;
+        std::vector<Eigen::Matrix3d> _C;   // matrice C par matériau
+        std::vector<char> _constrained;    // DDL imposés
+        mutable Eigen::VectorXd _masked;
+
+        void applyElements(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+
+    public:
+        // Le maillage doit être initialisé (aires et coloriage des éléments)
+        ElasticityOperator(const Mesh& mesh);
+
+        void setConstrained(const std::vector<char>& constrained) { _constrained = constrained; }
+
+        // y = K x avec masquage des DDL imposés
+        void apply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+        // y = K x sur le système complet (relèvement des CL, réactions)
+        void applyFull(const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+        // Diagonale du système masqué (préconditionneur de Jacobi)
+        Eigen::VectorXd diagonal() const;
+
+        int rows() const { return _mesh.nbDofs(); }
+        size_t memoryUsage() const;
+};
+
+#endif
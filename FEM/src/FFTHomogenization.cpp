@@ -0,0 +1,212 @@
+#include "FFTHomogenization.h"
+#include "Material.h"
+#include "Parallel.h"
+#include <cmath>
+#include <chrono>
+
+using namespace std;
+
+typedef complex<double> Complex;
+
+FFTHomogenization::FFTHomogenization(const PhaseMap& phases, const vector<Eigen::Matrix3d>& stiffness)
+    : _phases(phases), _nx(phases.width), _ny(phases.height), _nkx(phases.width / 2 + 1),
+      _tolerance(1e-6), _maxIterations(1000), _log(nullptr), _lastIterations(0), _totalIterations(0) {
+    // Notation de Mandel (eps_xy * racine de 2) : produit scalaire euclidien, C symétrique
+    Eigen::Matrix3d D = Eigen::Vector3d(1.0, 1.0, sqrt(2.0)).asDiagonal();
+    _C.resize(9 * stiffness.size());
+    for (size_t p = 0; p < stiffness.size(); p++) {
+        Eigen::Matrix3d CM = D * stiffness[p] * D;
+        for (int a = 0; a < 3; a++)
+            for (int b = 0; b < 3; b++) _C[9 * p + 3 * a + b] = CM(a, b);
+    }
+
+    int threads = numThreads();
+    _fft.resize(threads);
+    for (Eigen::FFT<double>& fft : _fft) fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+    for (int c = 0; c < 3; c++) _spectrum[c].resize((size_t)_ny * _nkx);
+    _columns.resize((size_t)2 * _ny * threads);
+}
+
+void FFTHomogenization::applyC(const vector<double>* eps, vector<double>* sigma) const {
+    const uint8_t* phase = _phases.phase.data();
+    const double* e0 = eps[0].data();
+    const double* e1 = eps[1].data();
+    const double* e2 = eps[2].data();
+    double* s0 = sigma[0].data();
+    double* s1 = sigma[1].data();
+    double* s2 = sigma[2].data();
+    int n = _nx * _ny;
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < n; k++) {
+        const double* C = &_C[9 * phase[k]];
+        double a = e0[k], b = e1[k], c = e2[k];
+        s0[k] = C[0] * a + C[1] * b + C[2] * c;
+        s1[k] = C[3] * a + C[4] * b + C[5] * c;
+        s2[k] = C[6] * a + C[7] * b + C[8] * c;
+    }
+}
+
+// FFT 2D par lignes (réelle, demi-spectre de nx/2 + 1 fréquences) puis par colonnes (complexe)
+void FFTHomogenization::forward(const vector<double>& field, vector<Complex>& spectrum) {
+    #pragma omp parallel
+    {
+        Eigen::FFT<double>& fft = _fft[threadId()];
+        Complex* a = &_columns[(size_t)2 * _ny * threadId()];
+        Complex* b = a + _ny;
+        #pragma omp for schedule(static)
+        for (int j = 0; j < _ny; j++) fft.fwd(&spectrum[(size_t)j * _nkx], &field[(size_t)j * _nx], _nx);
+        #pragma omp for schedule(static)
+        for (int i = 0; i < _nkx; i++) {
+            for (int j = 0; j < _ny; j++) a[j] = spectrum[(size_t)j * _nkx + i];
+            fft.fwd(b, a, _ny);
+            for (int j = 0; j < _ny; j++) spectrum[(size_t)j * _nkx + i] = b[j];
+        }
+    }
+}
+
+void FFTHomogenization::inverse(vector<Complex>& spectrum, vector<double>& field) {
+    #pragma omp parallel
+    {
+        Eigen::FFT<double>& fft = _fft[threadId()];
+        Complex* a = &_columns[(size_t)2 * _ny * threadId()];
+        Complex* b = a + _ny;
+        #pragma omp for schedule(static)
+        for (int i = 0; i < _nkx; i++) {
+            for (int j = 0; j < _ny; j++) a[j] = spectrum[(size_t)j * _nkx + i];
+            fft.inv(b, a, _ny);
+            for (int j = 0; j < _ny; j++) spectrum[(size_t)j * _nkx + i] = b[j];
+        }
+        #pragma omp for schedule(static)
+        for (int j = 0; j < _ny; j++) fft.inv(&field[(size_t)j * _nx], &spectrum[(size_t)j * _nkx], _nx);
+    }
+}
+
+// G(tau) = sym(n ⊗ tau n) * 2 - (n . tau n) n ⊗ n, n = xi / |xi| : projecteur orthogonal sur
+// les déformations compatibles. Fréquence nulle (moyenne) et fréquences de Nyquist annulées.
+void FFTHomogenization::project(vector<double>* field) {
+    for (int c = 0; c < 3; c++) forward(field[c], _spectrum[c]);
+
+    const double r2 = sqrt(2.0);
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < _ny; j++) {
+        int ky = j <= _ny / 2 ? j : j - _ny;
+        bool nyquistY = _ny % 2 == 0 && j == _ny / 2;
+        for (int i = 0; i < _nkx; i++) {
+            size_t k = (size_t)j * _nkx + i;
+            bool nyquistX = _nx % 2 == 0 && i == _nx / 2;
+            if ((i == 0 && ky == 0) || nyquistX || nyquistY) {
+                _spectrum[0][k] = _spectrum[1][k] = _spectrum[2][k] = 0.0;
+                continue;
+            }
+            double xi = i / _phases.lx, eta = ky / _phases.ly;
+            double norm = sqrt(xi * xi + eta * eta);
+            double nx = xi / norm, ny = eta / norm;
+            Complex txx = _spectrum[0][k], tyy = _spectrum[1][k], txy = _spectrum[2][k] / r2;
+            Complex tx = txx * nx + txy * ny;   // tau n
+            Complex ty = txy * nx + tyy * ny;
+            Complex s = nx * tx + ny * ty;      // n . tau n
+            _spectrum[0][k] = 2.0 * nx * tx - s * nx * nx;
+            _spectrum[1][k] = 2.0 * ny * ty - s * ny * ny;
+            _spectrum[2][k] = r2 * (nx * ty + ny * tx - s * nx * ny);
+        }
+    }
+
+    for (int c = 0; c < 3; c++) inverse(_spectrum[c], field[c]);
+}
+
+static double dot(const vector<double>* a, const vector<double>* b) {
+    double s = 0.0;
+    int n = a[0].size();
+    for (int c = 0; c < 3; c++) {
+        const double* x = a[c].data();
+        const double* y = b[c].data();
+        #pragma omp parallel for reduction(+:s) schedule(static)
+        for (int k = 0; k < n; k++) s += x[k] * y[k];
+    }
+    return s;
+}
+
+Eigen::Vector3d FFTHomogenization::solve(const Eigen::Vector3d& E) {
+    auto t0 = chrono::high_resolution_clock::now();
+    int n = _nx * _ny;
+    const double r2 = sqrt(2.0);
+    double EM[3] = {E(0), E(1), E(2) / r2};
+
+    // Second membre b = -G[C : E], fluctuation x = 0
+    vector<double> eps[3], x[3], r[3], p[3], q[3];
+    for (int c = 0; c < 3; c++) {
+        eps[c].assign(n, EM[c]);
+        x[c].assign(n, 0.0);
+        r[c].resize(n);
+        q[c].resize(n);
+    }
+    applyC(eps, r);
+    project(r);
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < n; k++) r[c][k] = -r[c][k];
+        p[c] = r[c];
+    }
+
+    // Gradient conjugué sur les champs compatibles : A x = G[C : x]
+    double rr = dot(r, r);
+    double bnorm = sqrt(rr), residual = bnorm > 0.0 ? 1.0 : 0.0;
+    int it = 0;
+    while (residual > _tolerance && it < _maxIterations) {
+        applyC(p, q);
+        project(q);
+        double alpha = rr / dot(p, q);
+        for (int c = 0; c < 3; c++) {
+            double* xc = x[c].data();
+            double* rc = r[c].data();
+            const double* pc = p[c].data();
+            const double* qc = q[c].data();
+            #pragma omp parallel for schedule(static)
+            for (int k = 0; k < n; k++) {
+                xc[k] += alpha * pc[k];
+                rc[k] -= alpha * qc[k];
+            }
+        }
+        double rrNew = dot(r, r);
+        double beta = rrNew / rr;
+        rr = rrNew;
+        residual = sqrt(rr) / bnorm;
+        for (int c = 0; c < 3; c++) {
+            double* pc = p[c].data();
+            const double* rc = r[c].data();
+            #pragma omp parallel for schedule(static)
+            for (int k = 0; k < n; k++) pc[k] = rc[k] + beta * pc[k];
+        }
+        it++;
+    }
+    _lastIterations = it;
+    _totalIterations += it;
+    if (residual > _tolerance) {
+        cerr << "Attention : FFT non convergée en " << it << " itérations (résidu " << residual << ")" << endl;
+    }
+
+    // Contrainte moyenne pour eps = E + x
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < n; k++) eps[c][k] += x[c][k];
+    }
+    applyC(eps, q);
+    Eigen::Vector3d sigma;
+    for (int c = 0; c < 3; c++) {
+        double s = 0.0;
+        const double* qc = q[c].data();
+        #pragma omp parallel for reduction(+:s) schedule(static)
+        for (int k = 0; k < n; k++) s += qc[k];
+        sigma(c) = s / n;
+    }
+    sigma(2) /= r2;
+
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    log() << "Lippmann-Schwinger (FFT, gradient conjugué): itérations = " << it << ", erreur = " << residual
+          << ", temps = " << elapsed.count() << " s" << endl;
+    return sigma;
+}
+
+Eigen::Matrix3d FFTHomogenization::effectiveStiffness() {
+    Eigen::Matrix3d C;
+    for (int k = 0; k < 3; k++) C.col(k) = solve(Eigen::Vector3d::Unit(k));
+    return C;
+}
@@ -0,0 +1,60 @@
+#ifndef FFT_HOMOGENIZATION_H
+#define FFT_HOMOGENIZATION_H
+
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include <Eigen/Dense>
+#include <unsupported/Eigen/FFT>
+#include "PhaseMap.h"
+
+// Homogénisation spectrale (Moulinec-Suquet) sur une image de phases : équation de
+// Lippmann-Schwinger résolue par gradient conjugué (Zeman et al. 2010). Le milieu de
+// référence est l'identité, si bien que l'opérateur de Green se réduit au projecteur G sur
+// les champs de déformation compatibles, diagonal dans l'espace de Fourier. On cherche
+// eps = E + eps~ (eps~ compatible, de moyenne nulle) tel que G[C : eps] = 0, système
+// symétrique défini positif sur les champs compatibles : chaque itération coûte un produit
+// local par C et un aller-retour de FFT, soit O(N log N) pour N pixels. Les conditions sont
+// périodiques : le résultat se compare à runHomogenizationTest (homogenization_bc = periodic).
+
+class FFTHomogenization {
+public:
+    // stiffness[p] : matrice C de la phase p (Material::getC, Voigt avec glissement γxy)
+    FFTHomogenization(const PhaseMap& phases, const std::vector<Eigen::Matrix3d>& stiffness);
+
+    void setTolerance(double tol) { _tolerance = tol; }
+    void setMaxIterations(int n) { _maxIterations = n; }
+    void setLog(std::ostream* log) { _log = log; }
+
+    // Contrainte moyenne (Voigt) pour la déformation moyenne E (Voigt, γxy)
+    Eigen::Vector3d solve(const Eigen::Vector3d& E);
+    // Tenseur de rigidité effectif : trois déformations moyennes unitaires
+    Eigen::Matrix3d effectiveStiffness();
+
+    int lastIterations() const { return _lastIterations; }
+    int totalIterations() const { return _totalIterations; }
+
+private:
+    const PhaseMap& _phases;
+    int _nx, _ny, _nkx;              // pixels, fréquences stockées par ligne (nx/2 + 1)
+    std::vector<double> _C;          // 9 coefficients par phase, notation de Mandel
+    double _tolerance;
+    int _maxIterations;
+    std::ostream* _log;
+    int _lastIterations, _totalIterations;
+
+    std::vector<Eigen::FFT<double>> _fft;                 // un plan par thread
+    std::vector<std::complex<double>> _spectrum[3];       // demi-spectres (ny x nkx)
+    std::vector<std::complex<double>> _columns;           // colonnes de travail : 2 x ny par thread
+
+    std::ostream& log() const { return _log ? *_log : std::cout; }
+
+    // sigma = C : eps, pixel par pixel (trois composantes de Mandel)
+    void applyC(const std::vector<double>* eps, std::vector<double>* sigma) const;
+    // Projection sur les champs compatibles de moyenne nulle, en place
+    void project(std::vector<double>* field);
+    void forward(const std::vector<double>& field, std::vector<std::complex<double>>& spectrum);
+    void inverse(std::vector<std::complex<double>>& spectrum, std::vector<double>& field);
+};
+
+#endif
@@ -0,0 +1,329 @@
+#include "FiberDetector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Indice réfléchi sans répétition du bord (... 2 1 | 0 1 2 ...), comme BORDER_REFLECT_101
+inline int reflect(int i, int n) {
+    if (n == 1) return 0;
+    while (i < 0 || i >= n) {
+        if (i < 0) i = -i;
+        if (i >= n) i = 2 * n - 2 - i;
+    }
+    return i;
+}
+
+// Flou gaussien séparable : chaque ligne est étendue aux bords puis convoluée, et la passe
+// verticale combine des lignes entières ; les boucles internes portent sur x
+void gaussianBlur(const GrayImage& image, double sigma, vector<float>& out) {
+    int w = image.width, h = image.height;
+    int R = max(1, (int)ceil(2.0 * sigma));
+    vector<float> kernel(2 * R + 1);
+    float total = 0.0f;
+    for (int j = -R; j <= R; j++) {
+        kernel[j + R] = (float)exp(-0.5 * j * j / (sigma * sigma));
+        total += kernel[j + R];
+    }
+    for (float& k : kernel) k /= total;
+
+    vector<float> tmp((size_t)w * h);
+    #pragma omp parallel
+    {
+        vector<float> row(w + 2 * R);
+        #pragma omp for schedule(static)
+        for (int y = 0; y < h; y++) {
+            const uint8_t* src = &image.pixels[(size_t)y * w];
+            for (int i = 0; i < w + 2 * R; i++) row[i] = src[reflect(i - R, w)];
+            float* t = &tmp[(size_t)y * w];
+            fill(t, t + w, 0.0f);
+            for (int j = 0; j <= 2 * R; j++) {
+                const float k = kernel[j];
+                const float* r = row.data() + j;
+                #pragma omp simd
+                for (int x = 0; x < w; x++) t[x] += k * r[x];
+            }
+        }
+    }
+
+    out.assign((size_t)w * h, 0.0f);
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < h; y++) {
+        float* o = &out[(size_t)y * w];
+        for (int j = 0; j <= 2 * R; j++) {
+            const float k = kernel[j];
+            const float* src = &tmp[(size_t)reflect(y + j - R, h) * w];
+            #pragma omp simd
+            for (int x = 0; x < w; x++) o[x] += k * src[x];
+        }
+        // Arrondi à l'entier comme l'image 8 bits de traitement.py : HoughCircles voit aussi
+        // les contours des marches de quantification, et le rappel en dépend nettement
+        for (int x = 0; x < w; x++) o[x] = floor(o[x] + 0.5f);
+    }
+}
+
+// Gradients de Sobel 3x3 (mêmes échelles que cv::Sobel, bords répliqués comme dans HoughCircles)
+void sobel(const vector<float>& img, int w, int h, vector<float>& gx, vector<float>& gy) {
+    gx.assign((size_t)w * h, 0.0f);
+    gy.assign((size_t)w * h, 0.0f);
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < h; y++) {
+        const float* a = &img[(size_t)max(y - 1, 0) * w];
+        const float* b = &img[(size_t)y * w];
+        const float* c = &img[(size_t)min(y + 1, h - 1) * w];
+        float* ox = &gx[(size_t)y * w];
+        float* oy = &gy[(size_t)y * w];
+        #pragma omp simd
+        for (int x = 1; x < w - 1; x++) {
+            ox[x] = (a[x + 1] - a[x - 1]) + 2.0f * (b[x + 1] - b[x - 1]) + (c[x + 1] - c[x - 1]);
+            oy[x] = (c[x - 1] + 2.0f * c[x] + c[x + 1]) - (a[x - 1] + 2.0f * a[x] + a[x + 1]);
+        }
+        for (int x : {0, w - 1}) {
+            int l = max(x - 1, 0), r = min(x + 1, w - 1);
+            ox[x] = (a[r] - a[l]) + 2.0f * (b[r] - b[l]) + (c[r] - c[l]);
+            oy[x] = (c[l] + 2.0f * c[x] + c[r]) - (a[l] + 2.0f * a[x] + a[r]);
+        }
+    }
+}
+
+// Contours de Canny : maxima du module |gx| + |gy| dans la direction du gradient (quantifiée
+// sur 4 directions), au-dessus du seuil bas, reliés par hystérésis à un point au-dessus du seuil
+// haut. Retourne les indices des pixels de contour.
+vector<int> canny(const vector<float>& gx, const vector<float>& gy, int w, int h, float high, vector<uint8_t>& edges) {
+    vector<float> mag((size_t)w * h);
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < h; y++) {
+        const float* ox = &gx[(size_t)y * w];
+        const float* oy = &gy[(size_t)y * w];
+        float* m = &mag[(size_t)y * w];
+        #pragma omp simd
+        for (int x = 0; x < w; x++) m[x] = fabs(ox[x]) + fabs(oy[x]);
+    }
+
+    const float low = 0.5f * high;
+    const float tan22 = 0.41421356f, tan67 = 2.41421356f;
+    edges.assign((size_t)w * h, 0);
+    #pragma omp parallel for schedule(static)
+    for (int y = 1; y < h - 1; y++) {
+        for (int x = 1; x < w - 1; x++) {
+            size_t i = (size_t)y * w + x;
+            float m = mag[i];
+            if (m <= low) continue;
+            float ax = fabs(gx[i]), ay = fabs(gy[i]);
+            size_t n1, n2;
+            if (ay <= tan22 * ax) {
+                n1 = i - 1;
+                n2 = i + 1;
+            } else if (ay >= tan67 * ax) {
+                n1 = i - w;
+                n2 = i + w;
+            } else if ((gx[i] > 0) == (gy[i] > 0)) {
+                n1 = i - w - 1;
+                n2 = i + w + 1;
+            } else {
+                n1 = i - w + 1;
+                n2 = i + w - 1;
+            }
+            if (m > mag[n1] && m >= mag[n2]) edges[i] = m > high ? 2 : 1;
+        }
+    }
+
+    // Hystérésis : propagation des contours forts aux contours faibles voisins
+    vector<int> stack, points;
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i] == 2) stack.push_back(i);
+    }
+    while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        points.push_back(i);
+        int x = i % w, y = i / w;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int xx = x + dx, yy = y + dy;
+                if (xx < 0 || yy < 0 || xx >= w || yy >= h) continue;
+                size_t j = (size_t)yy * w + xx;
+                if (edges[j] == 1) {
+                    edges[j] = 2;
+                    stack.push_back(j);
+                }
+            }
+        }
+    }
+    for (uint8_t& e : edges) e = (e == 2);
+    sort(points.begin(), points.end());
+    return points;
+}
+
+}
+
+vector<Fiber> detectFibers(const GrayImage& image, const DetectorOptions& options, ostream& log) {
+    auto t0 = chrono::high_resolution_clock::now();
+    vector<Fiber> fibers;
+    int w = image.width, h = image.height;
+    int minR = max(1, options.minRadius), maxR = max(minR, options.maxRadius);
+    if (w < 3 || h < 3) {
+        cerr << "Erreur : image trop petite pour la détection (" << w << " x " << h << ")" << endl;
+        return fibers;
+    }
+
+    vector<float> blurred, gx, gy;
+    vector<uint8_t> edges;
+    gaussianBlur(image, options.blurSigma, blurred);
+    sobel(blurred, w, h, gx, gy);
+    vector<int> points = canny(gx, gy, w, h, (float)options.edgeThreshold, edges);
+
+    // Accumulateur des centres : chaque point de contour vote des deux côtés de son gradient,
+    // pour chaque rayon de [minR, maxR]. Coordonnées tronquées comme l'accumulateur en virgule
+    // fixe d'OpenCV : la case (x, y) représente le centre (x + 0.5, y + 0.5).
+    vector<int> votes((size_t)w * h, 0);
+    int nbPoints = points.size();
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int k = 0; k < nbPoints; k++) {
+        int i = points[k];
+        double norm = sqrt((double)gx[i] * gx[i] + (double)gy[i] * gy[i]);
+        if (norm == 0.0) continue;
+        double dx = gx[i] / norm, dy = gy[i] / norm;
+        int x = i % w, y = i / w;
+        for (int r = minR; r <= maxR; r++) {
+            for (int sign = -1; sign <= 1; sign += 2) {
+                int cx = (int)floor(x + sign * dx * r), cy = (int)floor(y + sign * dy * r);
+                if (cx < 0 || cy < 0 || cx >= w || cy >= h) continue;
+                #pragma omp atomic
+                votes[(size_t)cy * w + cx]++;
+            }
+        }
+    }
+
+    // Centres candidats : maxima locaux de l'accumulateur au-dessus du seuil
+    vector<int> centers;
+    for (int y = 1; y < h - 1; y++) {
+        for (int x = 1; x < w - 1; x++) {
+            size_t i = (size_t)y * w + x;
+            int v = votes[i];
+            if (v > options.voteThreshold && v > votes[i - 1] && v >= votes[i + 1] && v > votes[i - w]
+                && v >= votes[i + w]) {
+                centers.push_back(i);
+            }
+        }
+    }
+
+    // Coordonnées des points de contour rangées par cellules de côté maxR + 1 : le voisinage
+    // d'un centre tient dans 3 x 3 cellules
+    int cell = maxR + 1;
+    int ncx = (w + cell - 1) / cell, ncy = (h + cell - 1) / cell;
+    vector<int> cellStart(ncx * ncy + 1, 0);
+    vector<float> cellX(nbPoints), cellY(nbPoints);
+    for (int i : points) cellStart[(i / w / cell) * ncx + (i % w) / cell + 1]++;
+    for (int c = 0; c < ncx * ncy; c++) cellStart[c + 1] += cellStart[c];
+    {
+        vector<int> fillPos(cellStart.begin(), cellStart.end() - 1);
+        for (int i : points) {
+            int q = fillPos[(i / w / cell) * ncx + (i % w) / cell]++;
+            cellX[q] = i % w;
+            cellY[q] = i / w;
+        }
+    }
+
+    // Rayon de chaque candidat, comme HoughCircles : distances au centre des contours situés
+    // entre les rayons extrêmes, triées puis regroupées en paquets de 1 pixel de large ; le
+    // rayon retenu maximise l'effectif du paquet rapporté au rayon (densité sur le cercle), le
+    // score est cet effectif. Le tri est un comptage sur des classes de 1/128 de pixel (des
+    // classes plus larges déplacent les égalités et changent sensiblement le résultat).
+    // Candidats indépendants : répartis entre les threads.
+    const int sub = 128;
+    int nbBins = (maxR - minR) * sub + 1;
+    int nbCenters = centers.size();
+    vector<int> score(nbCenters, 0);
+    vector<double> radius(nbCenters, 0.0);
+    float minR2 = (float)minR * minR, maxR2 = (float)maxR * maxR;
+    #pragma omp parallel
+    {
+        vector<int> count(nbBins);
+        #pragma omp for schedule(dynamic, 16)
+        for (int k = 0; k < nbCenters; k++) {
+            int ci = centers[k] % w, cj = centers[k] / w;
+            float cx = ci + 0.5f, cy = cj + 0.5f;
+            fill(count.begin(), count.end(), 0);
+            for (int j = max(0, cj / cell - 1); j <= min(ncy - 1, cj / cell + 1); j++) {
+                for (int i = max(0, ci / cell - 1); i <= min(ncx - 1, ci / cell + 1); i++) {
+                    for (int q = cellStart[j * ncx + i]; q < cellStart[j * ncx + i + 1]; q++) {
+                        float dx = cellX[q] - cx, dy = cellY[q] - cy;
+                        float d2 = dx * dx + dy * dy;
+                        if (d2 < minR2 || d2 > maxR2) continue;
+                        count[min(nbBins - 1, (int)((sqrt(d2) - minR) * sub))]++;
+                    }
+                }
+            }
+
+            // Paquet ouvert à la première classe non vide, fermé à la première classe à plus
+            // de 1 pixel ; son rayon est la distance médiane
+            int best = 0;
+            double rBest = 0.0;
+            int b = 0;
+            while (b < nbBins) {
+                if (count[b] == 0) {
+                    b++;
+                    continue;
+                }
+                int first = b, n = 0;
+                for (; b < nbBins && b - first <= sub; b++) n += count[b];
+                int median = n / 2, m = first;
+                for (int seen = count[first]; seen <= median; seen += count[++m]) {}
+                double r = minR + (m + 0.5) / sub;
+                if (n * rBest >= best * r || (rBest == 0.0 && n >= best)) {
+                    rBest = r;
+                    best = n;
+                }
+            }
+            score[k] = best;
+            radius[k] = rBest;
+        }
+    }
+
+    // Cercles retenus par score décroissant, à distance minimale des précédents
+    vector<int> order(nbCenters);
+    for (int k = 0; k < nbCenters; k++) order[k] = k;
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return score[a] != score[b] ? score[a] > score[b] : centers[a] < centers[b];
+    });
+    double minDist2 = options.minDist * options.minDist;
+    for (int k : order) {
+        if (score[k] <= options.voteThreshold) break;
+        double cx = centers[k] % w + 0.5, cy = centers[k] / w + 0.5;
+        bool tooClose = false;
+        for (const Fiber& f : fibers) {
+            if ((f.x - cx) * (f.x - cx) + (f.y - cy) * (f.y - cy) < minDist2) {
+                tooClose = true;
+                break;
+            }
+        }
+        if (tooClose) continue;
+        Fiber f = {cx, cy, radius[k]};
+        fibers.push_back(f);
+    }
+
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    log << "Détection : " << fibers.size() << " fibres dans l'image " << w << " x " << h << " ("
+        << nbPoints << " points de contour, " << centers.size() << " centres candidats) en "
+        << elapsed.count() * 1e3 << " ms" << endl;
+    return fibers;
+}
+
+double detectionRecall(const vector<Fiber>& detected, const vector<Fiber>& reference, double tolerance) {
+    if (reference.empty()) return 1.0;
+    int found = 0;
+    for (const Fiber& ref : reference) {
+        double limit2 = tolerance * ref.r * tolerance * ref.r;
+        for (const Fiber& f : detected) {
+            if ((f.x - ref.x) * (f.x - ref.x) + (f.y - ref.y) * (f.y - ref.y) < limit2) {
+                found++;
+                break;
+            }
+        }
+    }
+    return (double)found / reference.size();
+}
@@ -0,0 +1,45 @@
+#ifndef FIBER_DETECTOR_H
+#define FIBER_DETECTOR_H
+
+#include <vector>
+#include <iostream>
+#include "ImageReader.h"
+#include "FiberLayout.h"
+
+// Détection des fibres dans une micrographie par transformée de Hough à gradient, comme
+// cv::HoughCircles(HOUGH_GRADIENT, dp = 1) dans Preprocessing/traitement.py : flou gaussien,
+// gradients de Sobel, contours de Canny (suppression des non-maxima puis hystérésis), vote de
+// chaque point de contour pour les centres situés le long de son gradient, à une distance
+// comprise entre les rayons extrêmes. Chaque centre candidat (maximum local de l'accumulateur)
+// reçoit, comme dans OpenCV, le rayon où les points de contour qui l'entourent sont les plus
+// denses (paquets de distances de 1 pixel, effectif rapporté au rayon) ; les candidats sont
+// retenus par effectif décroissant, à distance minimale les uns des autres.
+// Limites : sur images_test, 24 des 28 cercles de cercles.txt sont retrouvés à moins de
+// 10 pixels (26 à moins de 20). Les manqués sont des fibres coupées par le bord de l'image ou
+// au contour peu marqué, dont un centre voisin décalé a pris la place ; la détection trouve en
+// revanche des fibres du bord absentes de la référence. Valider les paramètres detect_* sur
+// une image annotée (detect_reference) avant de mailler une nouvelle série d'images.
+// Flou et gradients travaillent ligne par ligne sur des tableaux contigus (boucles
+// vectorisées), les votes sont répartis entre les threads.
+
+struct DetectorOptions {
+    double blurSigma;         // écart type du flou gaussien (pixels), noyau de rayon ceil(2 sigma)
+    int minRadius, maxRadius; // rayons extrêmes des fibres (pixels)
+    double minDist;           // distance minimale entre deux centres
+    double edgeThreshold;     // seuil haut de Canny sur |gx| + |gy| (seuil bas : la moitié)
+    int voteThreshold;        // votes minimaux d'un centre et points de contour sur son cercle
+
+    // Valeurs de Preprocessing/traitement.py (images x50)
+    DetectorOptions() : blurSigma(2.0), minRadius(44), maxRadius(50), minDist(100.0), edgeThreshold(10.0),
+                        voteThreshold(6) {}
+};
+
+// Cercles détectés, en pixels (x vers la droite, y vers le bas, comme cercles.txt), par
+// nombre décroissant de points de contour
+std::vector<Fiber> detectFibers(const GrayImage& image, const DetectorOptions& options, std::ostream& log = std::cout);
+
+// Fraction des cercles de référence retrouvés : un cercle détecté dont le centre est à moins
+// de tolerance fois le rayon de référence. Les deux listes dans le même repère.
+double detectionRecall(const std::vector<Fiber>& detected, const std::vector<Fiber>& reference, double tolerance);
+
+#endif
@@ -0,0 +1,106 @@
+#include "FiberLayout.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+vector<Fiber> randomFiberLayout(double fraction, double radius, double gap, uint64_t seed) {
+    vector<Fiber> fibers;
+    if (radius <= 0.0 || fraction <= 0.0) return fibers;
+
+    int target = (int)round(fraction / (M_PI * radius * radius));
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> position(radius + gap, 1.0 - radius - gap);
+    double minDist = 2.0 * radius + gap;
+
+    // Au-delà de ~0.55 l'adsorption séquentielle se bloque : nombre d'essais borné
+    int attempts = 0, maxAttempts = 1000 * max(target, 1);
+    while ((int)fibers.size() < target && attempts < maxAttempts) {
+        attempts++;
+        Fiber f = {position(rng), position(rng), radius};
+        bool overlap = false;
+        for (const Fiber& g : fibers) {
+            double dx = f.x - g.x, dy = f.y - g.y;
+            if (dx * dx + dy * dy < minDist * minDist) {
+                overlap = true;
+                break;
+            }
+        }
+        if (!overlap) fibers.push_back(f);
+    }
+    return fibers;
+}
+
+vector<vector<Fiber>> readFiberGroups(const string& filename) {
+    vector<vector<Fiber>> groups;
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << filename << endl;
+        return groups;
+    }
+
+    vector<Fiber> current;
+    string line;
+    while (getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) {
+            if (!current.empty()) groups.push_back(current);
+            current.clear();
+            continue;
+        }
+        if (line[0] == '#') continue;
+        Fiber f;
+        istringstream values(line);
+        if (values >> f.x >> f.y >> f.r) current.push_back(f);
+    }
+    if (!current.empty()) groups.push_back(current);
+    return groups;
+}
+
+vector<Fiber> readFibers(const string& filename) {
+    vector<Fiber> fibers;
+    for (const vector<Fiber>& group : readFiberGroups(filename)) {
+        fibers.insert(fibers.end(), group.begin(), group.end());
+    }
+    return fibers;
+}
+
+void flipFiberAxis(vector<Fiber>& fibers) {
+    for (Fiber& f : fibers) f.y = -f.y;
+}
+
+vector<vector<Fiber>> loadFiberLayouts(const string& filename) {
+    vector<vector<Fiber>> layouts = readFiberGroups(filename);
+    for (vector<Fiber>& layout : layouts) {
+        flipFiberAxis(layout);
+        double xmin = 1e300, xmax = -1e300, ymin = 1e300, ymax = -1e300;
+        for (const Fiber& f : layout) {
+            xmin = min(xmin, f.x - f.r);
+            xmax = max(xmax, f.x + f.r);
+            ymin = min(ymin, f.y - f.r);
+            ymax = max(ymax, f.y + f.r);
+        }
+        xmin -= 1.0;
+        ymin -= 1.0;
+        double side = max(xmax - xmin, ymax - ymin) + 1.0;
+        for (Fiber& f : layout) {
+            f.x = (f.x - xmin) / side;
+            f.y = (f.y - ymin) / side;
+            f.r /= side;
+        }
+    }
+    return layouts;
+}
+
+bool writeFibers(const string& filename, const vector<Fiber>& fibers) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Erreur : impossible d'écrire " << filename << endl;
+        return false;
+    }
+    for (const Fiber& f : fibers) file << f.x << " " << f.y << " " << f.r << "\n";
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef FIBER_LAYOUT_H
+#define FIBER_LAYOUT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Mesh.h"
+
+// Arrangements de fibres circulaires dans un VER carré de côté 1 (mêmes unités que les
+// maillages du projet) et lecture/écriture du format cercles.txt ("x y r" par ligne).
+// Les fichiers cercles.txt et detectFibers sont dans le repère de l'image (y vers le bas) ;
+// les maillages sont en y vers le haut : flipFiberAxis fait le passage, comme
+// Preprocessing/maillage.py.
+
+struct Fiber {
+    double x, y, r;
+};
+
+// Adsorption séquentielle aléatoire : fibres de rayon radius tirées une à une dans le carré
+// unité, rejetées si elles débordent (marge gap au bord) ou s'approchent à moins de gap d'une
+// fibre déjà placée, jusqu'à atteindre la fraction volumique visée. Le tirage ne dépend que de seed.
+std::vector<Fiber> randomFiberLayout(double fraction, double radius, double gap, uint64_t seed);
+
+// Cercles d'un fichier cercles.txt groupés en arrangements séparés par des lignes vides
+// (lignes commençant par '#' ignorées), coordonnées du fichier inchangées
+std::vector<std::vector<Fiber>> readFiberGroups(const std::string& filename);
+
+// Tous les cercles d'un fichier cercles.txt, coordonnées du fichier inchangées
+std::vector<Fiber> readFibers(const std::string& filename);
+
+// Repère image (y vers le bas) vers repère des maillages (y vers le haut) : y -> -y
+void flipFiberAxis(std::vector<Fiber>& fibers);
+
+// Arrangements de readFiberGroups passés dans le repère des maillages (flipFiberAxis) et
+// ramenés au carré unité : boîte englobante des cercles élargie de 1 (comme
+// Preprocessing/maillage.py), mise à l'échelle sur son plus grand côté.
+std::vector<std::vector<Fiber>> loadFiberLayouts(const std::string& filename);
+
+// Écriture au format cercles.txt
+bool writeFibers(const std::string& filename, const std::vector<Fiber>& fibers);
+
+#endif
@@ -0,0 +1,269 @@
+#include "FusedCG.h"
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+using namespace Eigen;
+
+typedef chrono::high_resolution_clock Clock;
+
+double ConvergenceHistory::meanTime() const {
+    if (times.empty()) return 0.0;
+    double total = 0.0;
+    for (double t : times) total += t;
+    return total / times.size();
+}
+
+int fusedConjugateGradient(const SparseMatrix<double>& A, const VectorXd& invDiag, const VectorXd& b,
+                           VectorXd& x, double tol, int maxIter, double& error, ConvergenceHistory& history) {
+    int n = b.size();
+    if (x.size() != n) x = VectorXd::Zero(n);
+    history.clear();
+
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+    const double* d = invDiag.data();
+    const double* bp = b.data();
+    double* xp = x.data();
+
+    VectorXd r(n), z(n), p(n), q(n);
+    double* rp = r.data();
+    double* zp = z.data();
+    double* pp = p.data();
+    double* qp = q.data();
+
+    double bb = 0.0, rz = 0.0, rr = 0.0, pq = 0.0, rzNew = 0.0;
+    double alpha = 0.0, beta = 0.0;
+    int it = 0;
+    bool done = false;
+    Clock::time_point start;
+
+    #pragma omp parallel
+    {
+        // r = b - A x, z = D^-1 r, p = z
+        #pragma omp for schedule(static) reduction(+:bb, rz, rr)
+        for (int i = 0; i < n; i++) {
+            double s = 0.0;
+            for (int k = outer[i]; k < outer[i + 1]; k++) s += values[k] * xp[inner[k]];
+            rp[i] = bp[i] - s;
+            zp[i] = d[i] * rp[i];
+            pp[i] = zp[i];
+            bb += bp[i] * bp[i];
+            rz += rp[i] * zp[i];
+            rr += rp[i] * rp[i];
+        }
+
+        #pragma omp single
+        {
+            error = bb > 0.0 ? sqrt(rr / bb) : 0.0;
+            done = (error < tol || maxIter <= 0);
+            start = Clock::now();
+        }
+
+        while (!done) {
+            #pragma omp single
+            {
+                pq = 0.0;
+                rzNew = 0.0;
+                rr = 0.0;
+            }
+
+            // q = A p et p.q en un passage
+            #pragma omp for schedule(static) reduction(+:pq)
+            for (int i = 0; i < n; i++) {
+                double s = 0.0;
+                for (int k = outer[i]; k < outer[i + 1]; k++) s += values[k] * pp[inner[k]];
+                qp[i] = s;
+                pq += pp[i] * s;
+            }
+
+            #pragma omp single
+            alpha = rz / pq;
+
+            // x, r, z et les produits scalaires en un passage
+            #pragma omp for schedule(static) reduction(+:rzNew, rr)
+            for (int i = 0; i < n; i++) {
+                xp[i] += alpha * pp[i];
+                rp[i] -= alpha * qp[i];
+                zp[i] = d[i] * rp[i];
+                rzNew += rp[i] * zp[i];
+                rr += rp[i] * rp[i];
+            }
+
+            #pragma omp single
+            {
+                beta = rzNew / rz;
+                rz = rzNew;
+                it++;
+                error = sqrt(rr / bb);
+                Clock::time_point now = Clock::now();
+                history.residuals.push_back(error);
+                history.times.push_back(chrono::duration<double>(now - start).count());
+                start = now;
+                done = (error < tol || it >= maxIter);
+            }
+
+            if (!done) {
+                #pragma omp for schedule(static)
+                for (int i = 0; i < n; i++) pp[i] = zp[i] + beta * pp[i];
+            }
+        }
+    }
+    return it;
+}
+
+int pipelinedConjugateGradient(const SparseMatrix<double>& A, const VectorXd& invDiag, const VectorXd& b,
+                               VectorXd& x, double tol, int maxIter, double& error, ConvergenceHistory& history) {
+    int n = b.size();
+    if (x.size() != n) x = VectorXd::Zero(n);
+    history.clear();
+
+    const int* outer = A.outerIndexPtr();
+    const int* inner = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+    const double* d = invDiag.data();
+    const double* bp = b.data();
+    double* xp = x.data();
+
+    // Notations de Ghysels et Vanroose : u = M r, w = A u, m = M w, n = A m
+    VectorXd r(n), u(n), w(n), m(n), nv(n), z(n), q(n), s(n), p(n);
+    double* rp = r.data();
+    double* up = u.data();
+    double* wp = w.data();
+    double* mp = m.data();
+    double* np = nv.data();
+    double* zp = z.data();
+    double* qp = q.data();
+    double* sp = s.data();
+    double* pp = p.data();
+
+    double bb = 0.0, gamma = 0.0, delta = 0.0, rr = 0.0;
+    double gammaOld = 0.0, alpha = 0.0, alphaOld = 0.0, beta = 0.0;
+    const int replacePeriod = 16;
+    int it = 0;
+    bool done = false, replace = false, trueResidual = false;
+    Clock::time_point start;
+
+    #pragma omp parallel
+    {
+        // r = b - A x, u = M r
+        #pragma omp for schedule(static) reduction(+:bb)
+        for (int i = 0; i < n; i++) {
+            double t = 0.0;
+            for (int k = outer[i]; k < outer[i + 1]; k++) t += values[k] * xp[inner[k]];
+            rp[i] = bp[i] - t;
+            up[i] = d[i] * rp[i];
+            zp[i] = qp[i] = sp[i] = pp[i] = 0.0;
+            bb += bp[i] * bp[i];
+        }
+
+        // w = A u
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; i++) {
+            double t = 0.0;
+            for (int k = outer[i]; k < outer[i + 1]; k++) t += values[k] * up[inner[k]];
+            wp[i] = t;
+        }
+
+        #pragma omp single
+        start = Clock::now();
+
+        while (!done) {
+            #pragma omp single
+            {
+                gamma = 0.0;
+                delta = 0.0;
+                rr = 0.0;
+            }
+
+            // Un seul passage : m = M w, n = A m (M diagonale : n_i = sum A_ij d_j w_j)
+            // et les trois produits scalaires, réduits ensemble
+            #pragma omp for schedule(static) reduction(+:gamma, delta, rr)
+            for (int i = 0; i < n; i++) {
+                double t = 0.0;
+                for (int k = outer[i]; k < outer[i + 1]; k++) t += values[k] * d[inner[k]] * wp[inner[k]];
+                np[i] = t;
+                mp[i] = d[i] * wp[i];
+                gamma += rp[i] * up[i];
+                delta += wp[i] * up[i];
+                rr += rp[i] * rp[i];
+            }
+
+            #pragma omp single
+            {
+                error = bb > 0.0 ? sqrt(rr / bb) : 0.0;
+                if (it > 0) {
+                    Clock::time_point now = Clock::now();
+                    history.residuals.push_back(error);
+                    history.times.push_back(chrono::duration<double>(now - start).count());
+                    start = now;
+                }
+                done = (error < tol || it >= maxIter);
+                if (!done) {
+                    if (it == 0) {
+                        beta = 0.0;
+                        alpha = gamma / delta;
+                    } else {
+                        beta = gamma / gammaOld;
+                        alpha = gamma / (delta - beta * gamma / alphaOld);
+                    }
+                    gammaOld = gamma;
+                    alphaOld = alpha;
+                    it++;
+                    replace = (it % replacePeriod == 0);
+                    trueResidual = (error > 1.5e-8);
+                }
+            }
+
+            if (!done) {
+                // Toutes les récurrences de vecteurs en un passage
+                #pragma omp for schedule(static)
+                for (int i = 0; i < n; i++) {
+                    zp[i] = np[i] + beta * zp[i];
+                    qp[i] = mp[i] + beta * qp[i];
+                    sp[i] = wp[i] + beta * sp[i];
+                    pp[i] = up[i] + beta * pp[i];
+                    xp[i] += alpha * pp[i];
+                    rp[i] -= alpha * sp[i];
+                    up[i] -= alpha * qp[i];
+                    wp[i] -= alpha * zp[i];
+                }
+
+                // Remplacement des vecteurs récursifs : leurs récurrences s'écartent des valeurs
+                // vraies par arrondi, gamma et alpha se faussent et le résidu stagne vers 1e-9.
+                // Toutes les replacePeriod itérations, on recalcule u = M r, w = A u, s = A p,
+                // q = M s, z = A q, et r = b - A x tant que le résidu dépasse sqrt(eps) (plus bas,
+                // le résidu vrai est au niveau des arrondis de A x et r reste récursif).
+                // p, alpha et beta sont conservés : l'information de Krylov n'est pas perdue
+                if (replace) {
+                    #pragma omp for schedule(static)
+                    for (int i = 0; i < n; i++) {
+                        double t = 0.0, ts = 0.0;
+                        for (int k = outer[i]; k < outer[i + 1]; k++) {
+                            if (trueResidual) t += values[k] * xp[inner[k]];
+                            ts += values[k] * pp[inner[k]];
+                        }
+                        if (trueResidual) rp[i] = bp[i] - t;
+                        up[i] = d[i] * rp[i];
+                        sp[i] = ts;
+                        qp[i] = d[i] * ts;
+                    }
+
+                    #pragma omp for schedule(static)
+                    for (int i = 0; i < n; i++) {
+                        double t = 0.0, tz = 0.0;
+                        for (int k = outer[i]; k < outer[i + 1]; k++) {
+                            t += values[k] * up[inner[k]];
+                            tz += values[k] * qp[inner[k]];
+                        }
+                        wp[i] = t;
+                        zp[i] = tz;
+                    }
+                }
+            }
+        }
+    }
+    return it;
+}
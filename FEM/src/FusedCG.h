@@ -0,0 +1,39 @@
+#ifndef FUSED_CG_H
+#define FUSED_CG_H
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <vector>
+
+// Historique de convergence : ||r|| / ||b|| après chaque itération et durée de l'itération (s)
+struct ConvergenceHistory {
+    std::vector<double> residuals;
+    std::vector<double> times;
+
+    void clear() { residuals.clear(); times.clear(); }
+    double meanTime() const;
+};
+
+// Gradients conjugués multithreads préconditionnés par Jacobi, écrits pour une matrice
+// symétrique stockée en entier (CSC) : la colonne i étant la ligne i, chaque produit
+// matrice-vecteur est une boucle de sommes indépendantes par ligne.
+// Tout le solveur s'exécute dans une seule région parallèle.
+//
+// fused     : produit matrice-vecteur fusionné avec le produit scalaire p.Ap, mises à jour
+//             de x, r, z et produits scalaires r.z, r.r dans un même passage.
+// pipelined : variante de Ghysels-Vanroose. Les trois produits scalaires d'une itération sont
+//             calculés dans le même passage que le produit matrice-vecteur (une seule réduction),
+//             puis toutes les mises à jour de vecteurs en un passage. Plus sensible aux arrondis :
+//             recalcule périodiquement les vecteurs récursifs (u, w, s, q, z, et r = b - A x
+//             tant que le résidu dépasse sqrt(eps)) à partir de r, x et p ; p et beta sont
+//             conservés.
+// Retournent le nombre d'itérations ; error reçoit ||r|| / ||b|| (résidu récursif).
+int fusedConjugateGradient(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& invDiag,
+                           const Eigen::VectorXd& b, Eigen::VectorXd& x, double tol, int maxIter,
+                           double& error, ConvergenceHistory& history);
+
+int pipelinedConjugateGradient(const Eigen::SparseMatrix<double>& A, const Eigen::VectorXd& invDiag,
+                               const Eigen::VectorXd& b, Eigen::VectorXd& x, double tol, int maxIter,
+                               double& error, ConvergenceHistory& history);
+
+#endif
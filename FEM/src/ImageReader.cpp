@@ -0,0 +1,389 @@
+#include "ImageReader.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// Tailles acceptées : les dimensions viennent de l'en-tête du fichier, à ne pas croire avant
+// d'allouer (32768 pixels de côté, 2^28 pixels au total, soit 256 Mo en niveaux de gris)
+const long maxSide = 32768;
+const size_t maxPixels = (size_t)1 << 28;
+
+bool checkSize(long width, long height, const string& filename) {
+    if (width <= maxSide && height <= maxSide && (size_t)width * height <= maxPixels) return true;
+    cerr << "Erreur : image " << width << " x " << height << " trop grande (au plus " << maxSide
+         << " pixels de côté et " << maxPixels << " pixels) : " << filename << endl;
+    return false;
+}
+
+// Décompression deflate (RFC 1951) : tables de Huffman canoniques indexées par les maxLen
+// prochains bits, lecture par mots de 64 bits. La sortie est bornée à la taille attendue
+// d'après l'en-tête : un flux qui la dépasse est refusé avant toute allocation.
+class Inflater {
+    private:
+        struct Huffman {
+            vector<uint16_t> table;   // (symbole << 4) | longueur, 0 : code invalide
+            int maxLen;
+        };
+
+        const uint8_t* _p;
+        const uint8_t* _end;
+        uint64_t _bits;
+        int _count;
+        int _padding;   // bits nuls ajoutés après la fin des données
+
+        // Bits lus au-delà de la fin des données
+        bool overrun() const { return _padding > _count; }
+
+        void refill() {
+            while (_count <= 56) {
+                if (_p < _end) _bits |= (uint64_t)*_p++ << _count;
+                else _padding += 8;
+                _count += 8;
+            }
+        }
+
+        uint32_t bits(int n) {
+            if (n == 0) return 0;
+            if (_count < n) refill();
+            uint32_t v = _bits & ((1ull << n) - 1);
+            _bits >>= n;
+            _count -= n;
+            return v;
+        }
+
+        static bool build(Huffman& h, const uint8_t* lengths, int n) {
+            int count[16] = {0};
+            h.maxLen = 1;
+            for (int s = 0; s < n; s++) {
+                count[lengths[s]]++;
+                h.maxLen = max(h.maxLen, (int)lengths[s]);
+            }
+            count[0] = 0;
+            int next[16] = {0}, code = 0;
+            for (int len = 1; len < 16; len++) {
+                code = (code + count[len - 1]) << 1;
+                next[len] = code;
+            }
+            h.table.assign(1u << h.maxLen, 0);
+            for (int s = 0; s < n; s++) {
+                int len = lengths[s];
+                if (len == 0) continue;
+                int c = next[len]++;
+                if (c >= (1 << len)) return false;   // code sursouscrit
+                int r = 0;
+                for (int i = 0; i < len; i++) r |= ((c >> i) & 1) << (len - 1 - i);
+                for (int k = r; k < (1 << h.maxLen); k += 1 << len) h.table[k] = (uint16_t)((s << 4) | len);
+            }
+            return true;
+        }
+
+        int decode(const Huffman& h) {
+            if (_count < h.maxLen) refill();
+            uint16_t entry = h.table[_bits & ((1u << h.maxLen) - 1)];
+            int len = entry & 15;
+            if (len == 0) return -1;
+            _bits >>= len;
+            _count -= len;
+            return entry >> 4;
+        }
+
+    public:
+        Inflater(const uint8_t* data, size_t size) : _p(data), _end(data + size), _bits(0), _count(0), _padding(0) {}
+
+        bool inflate(vector<uint8_t>& out, size_t limit) {
+            static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+            static const uint16_t distBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257,
+                                                  385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289,
+                                                  16385, 24577};
+            static const uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8,
+                                                  9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+            static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+            Huffman lit, dist;
+            bool last;
+            do {
+                last = bits(1);
+                int type = bits(2);
+                if (type == 0) {
+                    // Bloc non compressé : aligné sur l'octet
+                    bits(_count % 8);
+                    uint32_t len = bits(16), nlen = bits(16);
+                    if ((len ^ 0xffff) != nlen || out.size() + len > limit) return false;
+                    for (uint32_t i = 0; i < len; i++) out.push_back((uint8_t)bits(8));
+                    continue;
+                }
+                uint8_t lengths[320];
+                int hlit, hdist;
+                if (type == 1) {
+                    hlit = 288;
+                    hdist = 32;
+                    for (int s = 0; s < 288; s++) lengths[s] = s < 144 ? 8 : (s < 256 ? 9 : (s < 280 ? 7 : 8));
+                    for (int s = 0; s < 32; s++) lengths[288 + s] = 5;
+                } else if (type == 2) {
+                    hlit = bits(5) + 257;
+                    hdist = bits(5) + 1;
+                    int hclen = bits(4) + 4;
+                    uint8_t codeLengths[19] = {0};
+                    for (int i = 0; i < hclen; i++) codeLengths[order[i]] = bits(3);
+                    Huffman lengthCode;
+                    if (!build(lengthCode, codeLengths, 19)) return false;
+                    for (int i = 0; i < hlit + hdist; ) {
+                        int sym = decode(lengthCode);
+                        if (sym < 0) return false;
+                        if (sym < 16) {
+                            lengths[i++] = sym;
+                            continue;
+                        }
+                        int repeat, value = 0;
+                        if (sym == 16) {
+                            if (i == 0) return false;
+                            value = lengths[i - 1];
+                            repeat = 3 + bits(2);
+                        } else if (sym == 17) {
+                            repeat = 3 + bits(3);
+                        } else {
+                            repeat = 11 + bits(7);
+                        }
+                        if (i + repeat > hlit + hdist) return false;
+                        while (repeat--) lengths[i++] = value;
+                    }
+                } else {
+                    return false;
+                }
+                if (!build(lit, lengths, hlit) || !build(dist, lengths + hlit, hdist)) return false;
+
+                while (true) {
+                    int sym = decode(lit);
+                    if (sym < 0 || overrun()) return false;
+                    if (sym < 256) {
+                        if (out.size() >= limit) return false;
+                        out.push_back((uint8_t)sym);
+                        continue;
+                    }
+                    if (sym == 256) break;
+                    sym -= 257;
+                    if (sym >= 29) return false;
+                    size_t len = lengthBase[sym] + bits(lengthExtra[sym]);
+                    int d = decode(dist);
+                    if (d < 0 || d >= 30) return false;
+                    size_t distance = distBase[d] + bits(distExtra[d]);
+                    if (distance > out.size() || out.size() + len > limit) return false;
+                    size_t from = out.size() - distance;
+                    for (size_t k = 0; k < len; k++) out.push_back(out[from + k]);
+                }
+            } while (!last);
+            return !overrun();
+        }
+};
+
+uint32_t bigEndian32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint8_t luminance(int r, int g, int b) {
+    return (uint8_t)((299 * r + 587 * g + 114 * b + 500) / 1000);
+}
+
+bool readPNG(const vector<uint8_t>& file, GrayImage& image, const string& filename) {
+    long width = 0, height = 0;
+    int depth = 0, colorType = -1, interlace = 0;
+    vector<uint8_t> compressed, palette;
+    size_t pos = 8;
+    while (pos + 12 <= file.size()) {
+        uint32_t length = bigEndian32(&file[pos]);
+        const char* type = (const char*)&file[pos + 4];
+        const uint8_t* data = &file[pos + 8];
+        if (pos + 12 + (size_t)length > file.size()) break;
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = bigEndian32(data);
+            height = bigEndian32(data + 4);
+            depth = data[8];
+            colorType = data[9];
+            interlace = data[12];
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            palette.assign(data, data + length);
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), data, data + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
+    }
+
+    int channels = colorType == 0 ? 1 : colorType == 2 ? 3 : colorType == 3 ? 1 : colorType == 4 ? 2 : colorType == 6 ? 4 : 0;
+    if (width <= 0 || height <= 0 || channels == 0 || compressed.size() < 2) {
+        cerr << "Erreur : en-tête PNG invalide dans " << filename << endl;
+        return false;
+    }
+    if (!checkSize(width, height, filename)) return false;
+    if (interlace != 0 || (depth != 8 && depth != 16 && !((colorType == 0 || colorType == 3) && depth < 8))) {
+        cerr << "Erreur : PNG entrelacé ou de profondeur " << depth << " non supporté (" << filename << ")" << endl;
+        return false;
+    }
+
+    // Flux zlib : en-tête de 2 octets puis deflate
+    size_t rowBytes = ((size_t)width * channels * depth + 7) / 8;
+    vector<uint8_t> raw;
+    // Réservation bornée par le taux maximal de deflate (1032) : un en-tête mensonger ne suffit
+    // pas à faire allouer la taille annoncée
+    raw.reserve(min((rowBytes + 1) * height, 1032 * compressed.size()));
+    Inflater inflater(compressed.data() + 2, compressed.size() - 2);
+    if (!inflater.inflate(raw, (rowBytes + 1) * height) || raw.size() < (rowBytes + 1) * height) {
+        cerr << "Erreur : données PNG corrompues dans " << filename << endl;
+        return false;
+    }
+
+    // Filtres de ligne (PNG : None, Sub, Up, Average, Paeth), sur place
+    size_t bpp = max<size_t>(1, (size_t)channels * depth / 8);
+    vector<uint8_t> zero(rowBytes, 0);
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = &raw[y * (rowBytes + 1) + 1];
+        const uint8_t* prev = y > 0 ? &raw[(y - 1) * (rowBytes + 1) + 1] : zero.data();
+        int filter = row[-1];
+        for (size_t i = 0; i < rowBytes; i++) {
+            int a = i >= bpp ? row[i - bpp] : 0, b = prev[i], c = i >= bpp ? prev[i - bpp] : 0;
+            int pred = 0;
+            switch (filter) {
+                case 0: pred = 0; break;
+                case 1: pred = a; break;
+                case 2: pred = b; break;
+                case 3: pred = (a + b) / 2; break;
+                case 4: {
+                    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+                    pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                    break;
+                }
+                default:
+                    cerr << "Erreur : filtre PNG " << filter << " inconnu dans " << filename << endl;
+                    return false;
+            }
+            row[i] = (uint8_t)(row[i] + pred);
+        }
+    }
+
+    // Conversion en niveaux de gris
+    image.width = width;
+    image.height = height;
+    image.pixels.resize((size_t)width * height);
+    int step = depth / 8;   // octets par échantillon (profondeurs 8 et 16)
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = &raw[y * (rowBytes + 1) + 1];
+        uint8_t* out = &image.pixels[(size_t)y * width];
+        for (int x = 0; x < width; x++) {
+            if (depth < 8) {
+                int perByte = 8 / depth;
+                int v = (row[x / perByte] >> ((perByte - 1 - x % perByte) * depth)) & ((1 << depth) - 1);
+                if (colorType == 3) {
+                    if (3 * (size_t)v + 2 >= palette.size()) {
+                        cerr << "Erreur : palette PNG incomplète dans " << filename << endl;
+                        return false;
+                    }
+                    out[x] = luminance(palette[3 * v], palette[3 * v + 1], palette[3 * v + 2]);
+                } else {
+                    out[x] = (uint8_t)(v * 255 / ((1 << depth) - 1));
+                }
+                continue;
+            }
+            const uint8_t* px = row + (size_t)x * channels * step;
+            switch (colorType) {
+                case 0: case 4: out[x] = px[0]; break;
+                case 2: case 6: out[x] = luminance(px[0], px[step], px[2 * step]); break;
+                case 3:
+                    if (3 * (size_t)px[0] + 2 >= palette.size()) {
+                        cerr << "Erreur : palette PNG incomplète dans " << filename << endl;
+                        return false;
+                    }
+                    out[x] = luminance(palette[3 * px[0]], palette[3 * px[0] + 1], palette[3 * px[0] + 2]);
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+bool readPGM(const vector<uint8_t>& file, GrayImage& image, const string& filename) {
+    // En-tête texte : magique, largeur, hauteur, valeur maximale (commentaires '#')
+    size_t pos = 2;
+    auto next = [&]() {
+        while (pos < file.size()) {
+            if (file[pos] == '#') {
+                while (pos < file.size() && file[pos] != '\n') pos++;
+            } else if (isspace(file[pos])) {
+                pos++;
+            } else {
+                break;
+            }
+        }
+        long v = 0;
+        bool digits = false;
+        while (pos < file.size() && isdigit(file[pos])) {
+            if (v > 1000000000L) return -1L;
+            v = 10 * v + (file[pos++] - '0');
+            digits = true;
+        }
+        return digits ? v : -1L;
+    };
+    bool binary = file[1] == '5';
+    long width = next(), height = next(), maxValue = next();
+    if (width <= 0 || height <= 0 || maxValue <= 0 || maxValue > 65535) {
+        cerr << "Erreur : en-tête PGM invalide dans " << filename << endl;
+        return false;
+    }
+    if (!checkSize(width, height, filename)) return false;
+    size_t bytes = maxValue > 255 ? 2 : 1;
+    if (binary && pos + 1 + bytes * width * height > file.size()) {
+        cerr << "Erreur : fichier PGM tronqué : " << filename << endl;
+        return false;
+    }
+    image.width = width;
+    image.height = height;
+    image.pixels.resize((size_t)width * height);
+
+    if (binary) {
+        pos++;   // un seul blanc après la valeur maximale
+        for (size_t i = 0; i < image.pixels.size(); i++) {
+            long v = bytes == 2 ? (file[pos + 2 * i] << 8) | file[pos + 2 * i + 1] : file[pos + i];
+            image.pixels[i] = (uint8_t)(v * 255 / maxValue);
+        }
+    } else {
+        for (size_t i = 0; i < image.pixels.size(); i++) {
+            long v = next();
+            if (v < 0) {
+                cerr << "Erreur : fichier PGM tronqué : " << filename << endl;
+                return false;
+            }
+            image.pixels[i] = (uint8_t)(min(v, maxValue) * 255 / maxValue);
+        }
+    }
+    return true;
+}
+
+}
+
+bool readImage(const string& filename, GrayImage& image) {
+    ifstream in(filename, ios::binary);
+    if (!in.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << filename << endl;
+        return false;
+    }
+    vector<uint8_t> file((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    static const uint8_t pngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (file.size() >= 8 && memcmp(file.data(), pngSignature, 8) == 0) return readPNG(file, image, filename);
+    if (file.size() >= 2 && file[0] == 'P' && (file[1] == '5' || file[1] == '2')) return readPGM(file, image, filename);
+
+    cerr << "Erreur : format d'image non supporté (PNG ou PGM attendu) : " << filename << endl;
+    return false;
+}
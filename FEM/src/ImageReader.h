@@ -0,0 +1,30 @@
+#ifndef IMAGE_READER_H
+#define IMAGE_READER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Lecture d'images en niveaux de gris 8 bits, sans dépendance extérieure : PNG (toutes
+// couleurs, profondeurs 1 à 16 bits, non entrelacé ; décompression deflate intégrée) et
+// PGM (P5 binaire, P2 texte). Les images couleur sont converties en luminance
+// (0.299 R + 0.587 G + 0.114 B, comme cv::IMREAD_GRAYSCALE), la transparence est ignorée
+// et les échantillons 16 bits réduits à leur octet de poids fort.
+// Lecteur écrit ici plutôt qu'un chargeur embarqué (stb_image.h) : le dépôt n'embarque aucune
+// bibliothèque et seuls ces deux formats sont utiles. Le contenu du fichier n'est pas supposé
+// sûr : dimensions bornées (32768 pixels de côté, 2^28 pixels) avant toute allocation, sortie
+// de la décompression limitée à la taille annoncée par l'en-tête.
+
+struct GrayImage {
+    int width, height;
+    std::vector<uint8_t> pixels;   // ligne par ligne, y vers le bas
+
+    GrayImage() : width(0), height(0) {}
+    uint8_t operator()(int x, int y) const { return pixels[(size_t)y * width + x]; }
+};
+
+// Format choisi d'après la signature du fichier. Retourne false (message sur cerr) si le
+// fichier est illisible ou d'un format non supporté.
+bool readImage(const std::string& filename, GrayImage& image);
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+#include <cmath>
+
+// Gradient conjugué préconditionné générique.
+// Operator doit fournir apply(x, y) : y = A x, Preconditioner apply(r, z) : z = M^-1 r.
+// Retourne le nombre d'itérations ; error reçoit ||r|| / ||b||.
+template <typename Operator, typename Preconditioner>
+int conjugateGradient(const Operator& A, const Preconditioner& M, const Eigen::VectorXd& b,
+                      Eigen::VectorXd& x, double tol, int maxIter, double& error) {
+    int n = b.size();
+    if (x.size() != n) x = Eigen::VectorXd::Zero(n);
+
+    double bNorm = b.norm();
+    if (bNorm == 0.0) {
+        x.setZero();
+        error = 0.0;
+        return 0;
+    }
+
+    Eigen::VectorXd r(n), z(n), p(n), Ap(n);
+    A.apply(x, Ap);
+    r = b - Ap;
+
+    error = r.norm() / bNorm;
+    if (error < tol) return 0;
+
+    M.apply(r, z);
+    p = z;
+    double rz = r.dot(z);
+
+    int it = 0;
+    while (it < maxIter) {
+        A.apply(p, Ap);
+        double alpha = rz / p.dot(Ap);
+        x += alpha * p;
+        r -= alpha * Ap;
+        it++;
+
+        error = r.norm() / bNorm;
+        if (error < tol) break;
+
+        M.apply(r, z);
+        double rzNew = r.dot(z);
+        p = z + (rzNew / rz) * p;
+        rz = rzNew;
+    }
+    return it;
+}
+
+// Gradient conjugué à mises à jour fiables (Sleijpen et van der Vorst), pour un
+// préconditionneur stocké en précision réduite : le produit par A et les vecteurs restent en
+// double. Quand le résidu itéré a baissé d'un facteur delta depuis la dernière mise à jour, ou
+// passe sous tol, il est remplacé par le résidu vrai b - A x ; x et la direction de descente
+// sont conservés, l'information de Krylov n'est pas perdue. S'arrête quand le résidu vrai passe
+// sous tol, ou quand il ne baisse plus de moitié d'une mise à jour à l'autre (précision
+// atteignable en double, eps * || |A| |x| || / ||b||). Retourne le nombre d'itérations ;
+// error reçoit ||b - A x|| / ||b|| (résidu vrai), updates le nombre de mises à jour.
+template <typename Operator, typename Preconditioner>
+int mixedPrecisionConjugateGradient(const Operator& A, const Preconditioner& M, const Eigen::VectorXd& b,
+                                    Eigen::VectorXd& x, double tol, int maxIter, double& error, int& updates,
+                                    double delta = 0.1) {
+    int n = b.size();
+    updates = 0;
+    x = Eigen::VectorXd::Zero(n);
+    double bNorm = b.norm();
+    error = 0.0;
+    if (bNorm == 0.0) return 0;
+
+    Eigen::VectorXd r = b, z(n), p(n), Ap(n);
+    M.apply(r, z);
+    p = z;
+    double rz = r.dot(z);
+    double rNorm = bNorm, rMax = bNorm;
+    error = 1.0;
+
+    int it = 0;
+    while (it < maxIter) {
+        A.apply(p, Ap);
+        double alpha = rz / p.dot(Ap);
+        x += alpha * p;
+        r -= alpha * Ap;
+        it++;
+        rNorm = r.norm();
+        rMax = std::max(rMax, rNorm);
+
+        if (rNorm < tol * bNorm || rNorm < delta * rMax) {
+            A.apply(x, Ap);
+            r = b - Ap;
+            rNorm = rMax = r.norm();
+            updates++;
+            double previous = error;
+            error = rNorm / bNorm;
+            if (error < tol || error > 0.5 * previous) break;
+        }
+
+        M.apply(r, z);
+        double rzNew = r.dot(z);
+        p = z + (rzNew / rz) * p;
+        rz = rzNew;
+    }
+    if (it == maxIter) {
+        A.apply(x, Ap);
+        error = (b - Ap).norm() / bNorm;
+    }
+    return it;
+}
+
+// Gradient conjugué par blocs (O'Leary) : toutes les colonnes de B sont résolues ensemble,
+// avec un seul produit matrice-bloc et une seule application du préconditionneur par itération.
+// Matrix doit supporter A * X, Preconditioner solve(R). errors reçoit ||r_k|| / ||b_k|| par colonne.
+// Retourne -1 si le bloc dégénère (colonnes linéairement dépendantes).
+template <typename Matrix, typename Preconditioner>
+int blockConjugateGradient(const Matrix& A, const Preconditioner& M, const Eigen::MatrixXd& B,
+                           Eigen::MatrixXd& X, double tol, int maxIter, Eigen::VectorXd& errors) {
+    int m = B.cols();
+    Eigen::VectorXd bNorms = B.colwise().norm().transpose();
+    for (int k = 0; k < m; k++) {
+        if (bNorms(k) == 0.0) bNorms(k) = 1.0;
+    }
+    if (X.rows() != B.rows() || X.cols() != m) X.setZero(B.rows(), m);
+
+    Eigen::MatrixXd R = B - A * X;
+    errors = R.colwise().norm().transpose().cwiseQuotient(bNorms);
+    if (errors.maxCoeff() < tol) return 0;
+
+    Eigen::MatrixXd Z = M.solve(R);
+    Eigen::MatrixXd P = Z;
+    Eigen::MatrixXd gamma = Z.transpose() * R;
+    Eigen::MatrixXd Q;
+
+    int it = 0;
+    while (it < maxIter) {
+        Q = A * P;
+        Eigen::MatrixXd alpha = (P.transpose() * Q).ldlt().solve(gamma);
+        if (!alpha.allFinite()) return -1;
+
+        X += P * alpha;
+        R -= Q * alpha;
+        it++;
+
+        errors = R.colwise().norm().transpose().cwiseQuotient(bNorms);
+        if (errors.maxCoeff() < tol) break;
+
+        Z = M.solve(R);
+        Eigen::MatrixXd gammaNew = Z.transpose() * R;
+        Eigen::MatrixXd beta = gamma.ldlt().solve(gammaNew);
+        if (!beta.allFinite()) return -1;
+        P = Z + P * beta;
+        gamma = gammaNew;
+    }
+    return it;
+}
+
+// Préconditionneur diagonal (Jacobi)
+class JacobiPreconditioner {
+public:
+    Eigen::VectorXd invDiag;
+
+    JacobiPreconditioner() {}
+    explicit JacobiPreconditioner(const Eigen::VectorXd& diag) {
+        invDiag = diag.unaryExpr([](double d) { return std::abs(d) > 0.0 ? 1.0 / d : 1.0; });
+    }
+
+    void apply(const Eigen::VectorXd& r, Eigen::VectorXd& z) const { z = invDiag.cwiseProduct(r); }
+};
+
+// Matrice creuse Eigen vue comme opérateur (y = A x)
+class SparseMatrixOperator {
+public:
+    const Eigen::SparseMatrix<double>& A;
+
+    explicit SparseMatrixOperator(const Eigen::SparseMatrix<double>& matrix) : A(matrix) {}
+
+    void apply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const { y.noalias() = A * x; }
+};
+
+// Incomplete Cholesky calculé en double puis stocké en float : z = P^T S L^-T L^-1 S P r,
+// descente et remontée en double sur les coefficients float. Renumérotation et mise à
+// l'échelle sont appliquées en un seul passage (sans les temporaires des PermutationMatrix).
+class FloatIncompleteCholesky {
+public:
+    Eigen::SparseMatrix<float, Eigen::RowMajor> Lrow;   // partie strictement inférieure, par lignes (descente)
+    Eigen::SparseMatrix<float> Lcol;                    // partie strictement inférieure, par colonnes (remontée)
+    Eigen::VectorXd invDiag;
+    Eigen::VectorXd scale;
+    Eigen::VectorXi perm;          // ligne renumérotée de chaque ligne d'origine
+    mutable Eigen::VectorXd y;
+
+    explicit FloatIncompleteCholesky(const Eigen::IncompleteCholesky<double>& ic) : scale(ic.scalingS()) {
+        Eigen::SparseMatrix<float> L = ic.matrixL().cast<float>();
+        int n = L.cols();
+        invDiag = L.diagonal().cast<double>().cwiseInverse();
+        Lcol = L.triangularView<Eigen::StrictlyLower>();
+        Lrow = Lcol;
+        perm = (ic.permutationP().rows() == n) ? Eigen::VectorXi(ic.permutationP().indices())
+                                               : Eigen::VectorXi(Eigen::VectorXi::LinSpaced(n, 0, n - 1));
+        y.resize(n);
+    }
+
+    void apply(const Eigen::VectorXd& r, Eigen::VectorXd& z) const {
+        int n = invDiag.size();
+        const int* P = perm.data();
+        const double* s = scale.data();
+        const double* d = invDiag.data();
+        double* yp = y.data();
+        for (int i = 0; i < n; i++) yp[P[i]] = s[P[i]] * r[i];
+
+        // L y = y (lignes de haut en bas)
+        const int* outer = Lrow.outerIndexPtr();
+        const int* inner = Lrow.innerIndexPtr();
+        const float* values = Lrow.valuePtr();
+        for (int i = 0; i < n; i++) {
+            double sum = yp[i];
+            for (int k = outer[i]; k < outer[i + 1]; k++) sum -= values[k] * yp[inner[k]];
+            yp[i] = sum * d[i];
+        }
+        // L^T y = y (colonnes de droite à gauche)
+        outer = Lcol.outerIndexPtr();
+        inner = Lcol.innerIndexPtr();
+        values = Lcol.valuePtr();
+        for (int j = n - 1; j >= 0; j--) {
+            double sum = yp[j];
+            for (int k = outer[j]; k < outer[j + 1]; k++) sum -= values[k] * yp[inner[k]];
+            yp[j] = sum * d[j];
+        }
+
+        z.resize(n);
+        for (int i = 0; i < n; i++) z[i] = s[P[i]] * yp[P[i]];
+    }
+
+    // Octets lus par application (une copie de L par passe), et équivalent en double
+    size_t bytes() const { return Lcol.nonZeros() * (sizeof(float) + sizeof(int)) + invDiag.size() * sizeof(float); }
+    size_t doubleBytes() const { return Lcol.nonZeros() * (sizeof(double) + sizeof(int)) + invDiag.size() * sizeof(double); }
+};
+
+#endif
@@ -3,127 +3,284 @@
 #include "Material.h"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 using namespace Eigen;
 
-Element::Element(int elemId, const vector<int>& nIds, Material* mat)
-    : id(elemId), nodeIds(nIds), material(mat), area(0.0) {
-    Ke.setZero();
+Mesh::Mesh() : keepElementMatrices(false), xMin(0), xMax(0), yMin(0), yMax(0) {}
+
+int Mesh::addNode(int id, double x, double y) {
+    nodeX.push_back(x);
+    nodeY.push_back(y);
+    slotToTag.push_back(id);
+    return nodeX.size() - 1;
 }
 
-void Element::computeArea(const Node& n1, const Node& n2, const Node& n3) {
-    Vector2d p1 = n1.coords;
-    Vector2d p2 = n2.coords;
-    Vector2d p3 = n3.coords;
-    
-    area = 0.5 * abs((p2.x() - p1.x()) * (p3.y() - p1.y()) - 
-                     (p3.x() - p1.x()) * (p2.y() - p1.y()));
+int Mesh::addMaterial(int tag, Material* mat) {
+    for (size_t i = 0; i < materialTags.size(); i++) {
+        if (materialTags[i] == tag) return i;
+    }
+    materialTags.push_back(tag);
+    materials.push_back(mat);
+    return materials.size() - 1;
 }
 
-void Element::computeKe(const Node& n1, const Node& n2, const Node& n3) {
-    Vector2d p1 = n1.coords;
-    Vector2d p2 = n2.coords;
-    Vector2d p3 = n3.coords;
-    
-    if (area < 1e-12) {
-        cerr << "Attention : élément " << id << " dégénéré (aire ~ 0)" << endl;
-        Ke.setZero();
-        return;
+bool Mesh::addElement(int n1, int n2, int n3, int materialIndex) {
+    int s1 = findNodeSlot(n1), s2 = findNodeSlot(n2), s3 = findNodeSlot(n3);
+    if (s1 < 0 || s2 < 0 || s3 < 0) return false;
+    connectivity.push_back(s1);
+    connectivity.push_back(s2);
+    connectivity.push_back(s3);
+    elementMaterial.push_back(materialIndex);
+    return true;
+}
+
+bool Mesh::addEdge(int n1, int n2, int tag) {
+    int s1 = findNodeSlot(n1), s2 = findNodeSlot(n2);
+    if (s1 < 0 || s2 < 0) return false;
+    edgeNodes.push_back(s1);
+    edgeNodes.push_back(s2);
+    edgeTags.push_back(tag);
+    return true;
+}
+
+void Mesh::reserve(int numNodes, int numElements) {
+    nodeX.reserve(numNodes);
+    nodeY.reserve(numNodes);
+    slotToTag.reserve(numNodes);
+    connectivity.reserve(3 * numElements);
+    elementMaterial.reserve(numElements);
+}
+
+int Mesh::nodeSlot(int id) const {
+    int slot = findNodeSlot(id);
+    if (slot < 0) cerr << "Erreur : noeud " << id << " introuvable!" << endl;
+    return slot;
+}
+
+void Mesh::buildNodeIndex() {
+    // Table dense tag -> slot, construite une seule fois après la lecture des noeuds
+    int maxTag = 0;
+    for (int id : slotToTag) maxTag = max(maxTag, id);
+
+    tagToSlot.assign(maxTag + 1, -1);
+
+    for (size_t i = 0; i < slotToTag.size(); i++) {
+        if (tagToSlot[slotToTag[i]] >= 0) {
+            cerr << "Attention : noeud " << slotToTag[i] << " défini plusieurs fois" << endl;
+        }
+        tagToSlot[slotToTag[i]] = i;
     }
-    
+}
+
+void Mesh::elementB(int e, ElementB& B) const {
     // Matrice B pour élément triangulaire P1
-    Matrix<double, 3, 6> B;
+    const int32_t* n = elementNodes(e);
+    double x1 = nodeX[n[0]], x2 = nodeX[n[1]], x3 = nodeX[n[2]];
+    double y1 = nodeY[n[0]], y2 = nodeY[n[1]], y3 = nodeY[n[2]];
+
+    double b1 = y2 - y3;
+    double b2 = y3 - y1;
+    double b3 = y1 - y2;
+
+    double c1 = x3 - x2;
+    double c2 = x1 - x3;
+    double c3 = x2 - x1;
+
     B.setZero();
-    
-    double b1 = p2.y() - p3.y();
-    double b2 = p3.y() - p1.y();
-    double b3 = p1.y() - p2.y();
-    
-    double c1 = p3.x() - p2.x();
-    double c2 = p1.x() - p3.x();
-    double c3 = p2.x() - p1.x();
-    
     B(0, 0) = b1;  B(0, 2) = b2;  B(0, 4) = b3;
     B(1, 1) = c1;  B(1, 3) = c2;  B(1, 5) = c3;
     B(2, 0) = c1;  B(2, 2) = c2;  B(2, 4) = c3;
     B(2, 1) = b1;  B(2, 3) = b2;  B(2, 5) = b3;
-    
-    B /= (2.0 * area);
-    
-    // Matrice de rigidité du matériau
-    Matrix3d C = material->getC();
-    
-    // Matrice de rigidité élémentaire
-    Ke = area * B.transpose() * C * B;
+
+    B /= (2.0 * elementArea[e]);
 }
 
-Mesh::Mesh() : xMin(0), xMax(0), yMin(0), yMax(0) {}
+void Mesh::elementStiffness(int e, ElementMatrix& Ke) const {
+    if (!elementMatrices.empty()) {
+        // Décompresser le triangle supérieur stocké
+        const double* packed = &elementMatrices[21 * e];
+        for (int i = 0, k = 0; i < 6; i++) {
+            for (int j = i; j < 6; j++, k++) {
+                Ke(i, j) = Ke(j, i) = packed[k];
+            }
+        }
+        return;
+    }
 
-Node& Mesh::getNode(int id) {
-    for (auto& node : nodes) {
-        if (node.id == id) return node;
+    const Material* mat = material(e);
+    if (elementArea[e] < 1e-12 || mat == nullptr) {
+        Ke.setZero();
+        return;
     }
-    cerr << "Erreur : noeud " << id << " introuvable!" << endl;
-    return nodes[0];
+
+    ElementB B;
+    elementB(e, B);
+
+    // Matrice de rigidité élémentaire
+    Ke = elementArea[e] * B.transpose() * mat->getC() * B;
 }
 
-void Mesh::loadFromGmsh(const string& filename) {
+bool Mesh::loadFromGmsh(const string& filename) {
     MeshReader reader(this);
-    reader.readGmshFile(filename);
-    
+    if (!reader.readGmshFile(filename)) return false;
+
     // Initialiser les éléments (calcul de l'aire et Ke)
     initializeElements();
+    return true;
 }
 
 void Mesh::initializeElements() {
-    for (auto& elem : elements) {
-        Node& n1 = getNode(elem.nodeIds[0]);
-        Node& n2 = getNode(elem.nodeIds[1]);
-        Node& n3 = getNode(elem.nodeIds[2]);
-        
-        elem.computeArea(n1, n2, n3);
-        if (elem.area > 1e-12) {
-            elem.computeKe(n1, n2, n3);
+    int ne = nbElements();
+    elementArea.resize(ne);
+
+    // Éléments remis dans le sens trigonométrique : aire signée positive, si bien que B
+    // (divisée par 2 * aire) donne le bon signe aux déformations et aux contraintes
+    int reoriented = 0;
+    #pragma omp parallel for schedule(static) reduction(+:reoriented)
+    for (int e = 0; e < ne; e++) {
+        int32_t* n = &connectivity[3 * e];
+        double x1 = nodeX[n[0]], x2 = nodeX[n[1]], x3 = nodeX[n[2]];
+        double y1 = nodeY[n[0]], y2 = nodeY[n[1]], y3 = nodeY[n[2]];
+
+        double signedArea = 0.5 * ((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
+        if (signedArea < 0.0) {
+            std::swap(n[1], n[2]);
+            reoriented++;
+        }
+        elementArea[e] = abs(signedArea);
+    }
+    if (reoriented > 0) {
+        cerr << "Attention : " << reoriented << " éléments en sens horaire renumérotés dans le sens trigonométrique" << endl;
+    }
+
+    for (int e = 0; e < ne; e++) {
+        if (elementArea[e] < 1e-12) {
+            cerr << "Attention : élément " << e << " dégénéré (aire ~ 0)" << endl;
+        }
+    }
+
+    if ((int)nodeElementStart.size() != nbNodes() + 1) buildNodeElements();
+    if (colorStart.empty() || colorStart.back() != ne) computeColoring();
+
+    elementMatrices.clear();
+    if (!keepElementMatrices) return;
+
+    vector<double> packed(21 * (size_t)ne);
+    #pragma omp parallel for schedule(static)
+    for (int e = 0; e < ne; e++) {
+        ElementMatrix Ke;
+        elementStiffness(e, Ke);
+        for (int i = 0, k = 0; i < 6; i++) {
+            for (int j = i; j < 6; j++, k++) {
+                packed[21 * (size_t)e + k] = Ke(i, j);
+            }
         }
     }
+    elementMatrices.swap(packed);
+}
+
+void Mesh::buildNodeElements() {
+    int nn = nbNodes();
+    int ne = nbElements();
+
+    nodeElementStart.assign(nn + 1, 0);
+    for (int k = 0; k < 3 * ne; k++) nodeElementStart[connectivity[k] + 1]++;
+    for (int i = 0; i < nn; i++) nodeElementStart[i + 1] += nodeElementStart[i];
+
+    nodeElements.resize(nodeElementStart[nn]);
+    vector<int> fill(nodeElementStart.begin(), nodeElementStart.end() - 1);
+    for (int e = 0; e < ne; e++) {
+        const int32_t* n = elementNodes(e);
+        for (int k = 0; k < 3; k++) nodeElements[fill[n[k]]++] = e;
+    }
+}
+
+void Mesh::computeColoring() {
+    // Coloriage glouton dans l'ordre des éléments : résultat déterministe
+    int ne = nbElements();
+    if ((int)nodeElementStart.size() != nbNodes() + 1) buildNodeElements();
+
+    vector<int> color(ne, -1);
+    vector<int> usedBy;  // usedBy[c] == e : couleur c déjà prise par un voisin de e
+    int nc = 0;
+
+    for (int e = 0; e < ne; e++) {
+        const int32_t* n = elementNodes(e);
+        for (int k = 0; k < 3; k++) {
+            for (int j = nodeElementStart[n[k]]; j < nodeElementStart[n[k] + 1]; j++) {
+                int c = color[nodeElements[j]];
+                if (c >= 0) usedBy[c] = e;
+            }
+        }
+        int c = 0;
+        while (c < nc && usedBy[c] == e) c++;
+        if (c == nc) {
+            usedBy.push_back(-1);
+            nc++;
+        }
+        color[e] = c;
+    }
+
+    // Regrouper les éléments par couleur (ordre croissant dans chaque couleur)
+    colorStart.assign(nc + 1, 0);
+    for (int e = 0; e < ne; e++) colorStart[color[e] + 1]++;
+    for (int c = 0; c < nc; c++) colorStart[c + 1] += colorStart[c];
+
+    colorElements.resize(ne);
+    vector<int> fill(colorStart.begin(), colorStart.end() - 1);
+    for (int e = 0; e < ne; e++) colorElements[fill[color[e]]++] = e;
 }
 
 void Mesh::computeGeometry() {
-    if (nodes.empty()) return;
-    
+    if (nodeX.empty()) return;
+
     // Calculer les limites
-    Vector2d first = nodes[0].coords;
-    xMin = xMax = first.x();
-    yMin = yMax = first.y();
-    
-    for (const auto& node : nodes) {
-        xMin = min(xMin, node.coords.x());
-        xMax = max(xMax, node.coords.x());
-        yMin = min(yMin, node.coords.y());
-        yMax = max(yMax, node.coords.y());
+    xMin = xMax = nodeX[0];
+    yMin = yMax = nodeY[0];
+
+    for (int i = 0; i < nbNodes(); i++) {
+        xMin = min(xMin, nodeX[i]);
+        xMax = max(xMax, nodeX[i]);
+        yMin = min(yMin, nodeY[i]);
+        yMax = max(yMax, nodeY[i]);
     }
-    
+
     // Identifier les nœuds de bord
     leftNodes.clear();
     rightNodes.clear();
     topNodes.clear();
     bottomNodes.clear();
-    
-    for (const auto& node : nodes) {
-        if (abs(node.coords.x() - xMin) < 1e-6) leftNodes.push_back(node.id);
-        if (abs(node.coords.x() - xMax) < 1e-6) rightNodes.push_back(node.id);
-        if (abs(node.coords.y() - yMin) < 1e-6) bottomNodes.push_back(node.id);
-        if (abs(node.coords.y() - yMax) < 1e-6) topNodes.push_back(node.id);
+
+    for (int i = 0; i < nbNodes(); i++) {
+        if (abs(nodeX[i] - xMin) < 1e-6) leftNodes.push_back(slotToTag[i]);
+        if (abs(nodeX[i] - xMax) < 1e-6) rightNodes.push_back(slotToTag[i]);
+        if (abs(nodeY[i] - yMin) < 1e-6) bottomNodes.push_back(slotToTag[i]);
+        if (abs(nodeY[i] - yMax) < 1e-6) topNodes.push_back(slotToTag[i]);
     }
 }
 
+size_t Mesh::memoryUsage() const {
+    size_t bytes = 0;
+    bytes += (nodeX.capacity() + nodeY.capacity()) * sizeof(double);
+    bytes += (tagToSlot.capacity() + slotToTag.capacity()) * sizeof(int);
+    bytes += connectivity.capacity() * sizeof(int32_t);
+    bytes += elementMaterial.capacity() * sizeof(uint16_t);
+    bytes += elementArea.capacity() * sizeof(double);
+    bytes += edgeNodes.capacity() * sizeof(int32_t) + edgeTags.capacity() * sizeof(int);
+    bytes += (nodeElementStart.capacity() + nodeElements.capacity()) * sizeof(int);
+    bytes += (colorStart.capacity() + colorElements.capacity()) * sizeof(int);
+    bytes += elementMatrices.capacity() * sizeof(double);
+    return bytes;
+}
+
 vector<int> Mesh::findNodesAtY(double y, double tol) const {
     vector<int> result;
-    for (const auto& node : nodes) {
-        if (abs(node.coords.y() - y) < tol) {
-            result.push_back(node.id);
+    for (int i = 0; i < nbNodes(); i++) {
+        if (abs(nodeY[i] - y) < tol) {
+            result.push_back(slotToTag[i]);
         }
     }
     return result;
-}
\ No newline at end of file
+}
@@ -3,54 +3,103 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <Eigen/Dense>
 
-class Node {
-public:
-    int id;
-    Eigen::Vector2d coords;
-
-    Node(int nodeId, const Eigen::Vector2d& c) : id(nodeId), coords(c) {}
-};
+class Material;
 
-class Element {
-public:
-    int id;
-    std::vector<int> nodeIds;
-    class Material* material;
-    double area;
-    Eigen::Matrix<double, 6, 6> Ke;
-
-    Element(int elemId, const std::vector<int>& nIds, Material* mat);
-    
-    void computeArea(const Node& n1, const Node& n2, const Node& n3);
-    void computeKe(const Node& n1, const Node& n2, const Node& n3);
-};
+// Matrices élémentaires d'un triangle P1 (2 DDL par noeud)
+typedef Eigen::Matrix<double, 6, 6> ElementMatrix;
+typedef Eigen::Matrix<double, 3, 6> ElementB;
 
 class Mesh {
+    // Maillage de triangles P1 stocké en "structure of arrays" : coordonnées, connectivité
+    // et matériaux sont des tableaux plats, sans objet alloué par noeud ou par élément.
+    // Les noeuds sont repérés par leur slot (indice compact 0..nbNodes-1), les tags Gmsh
+    // ne servent qu'aux entrées/sorties.
 public:
-    std::vector<Node> nodes;
-    std::vector<Element> elements;
-    
+    // Noeuds (indexés par slot)
+    std::vector<double> nodeX, nodeY;
+
+    // Indexation des noeuds : les tags Gmsh peuvent être creux, on les compacte
+    // en indices contigus (slots) à partir de 0. Le DDL d'un noeud vaut 2*slot + dof.
+    std::vector<int> tagToSlot;  // tag -> slot (table dense, -1 si tag absent)
+    std::vector<int> slotToTag;  // slot -> tag (pour les sorties)
+
+    // Éléments : 3 slots de noeuds par triangle (sens trigonométrique après
+    // initializeElements), indice de matériau et aire
+    std::vector<int32_t> connectivity;
+    std::vector<uint16_t> elementMaterial;
+    std::vector<double> elementArea;
+
+    // Table des matériaux (indice -> matériau et tag physique associé)
+    std::vector<Material*> materials;
+    std::vector<int> materialTags;
+
+    // Éléments attachés à chaque noeud (format CSR)
+    std::vector<int> nodeElementStart, nodeElements;
+
+    // Coloriage des éléments : deux éléments d'une même couleur n'ont aucun noeud commun,
+    // ce qui permet de les traiter en parallèle sans conflit d'écriture
+    std::vector<int> colorStart, colorElements;
+
+    // Arêtes (segments Gmsh) : 2 slots par arête et tag physique
+    std::vector<int32_t> edgeNodes;
+    std::vector<int> edgeTags;
+
+    // Conserver les matrices Ke (21 coefficients du triangle supérieur par élément).
+    // Sinon elles sont recalculées à la demande depuis la géométrie et le matériau.
+    bool keepElementMatrices;
+    std::vector<double> elementMatrices;
+
     // Informations géométriques
     double xMin, xMax, yMin, yMax;
-    std::vector<int> leftNodes, rightNodes, topNodes, bottomNodes;
+    std::vector<int> leftNodes, rightNodes, topNodes, bottomNodes;  // tags
 
     Mesh();
 
-    void addNode(const Node& node) { nodes.push_back(node); }
-    void addElement(const Element& elem) { elements.push_back(elem); }
+    // Construction
+    int addNode(int id, double x, double y);
+    int addMaterial(int tag, Material* mat);
+    // Tags de noeuds ; retournent false (sans rien ajouter) si un tag est introuvable
+    bool addElement(int n1, int n2, int n3, int materialIndex);
+    bool addEdge(int n1, int n2, int tag);
+    void reserve(int numNodes, int numElements);
 
-    Node& getNode(int id);
-    int nbNodes() const { return nodes.size(); }
-    int nbElements() const { return elements.size(); }
+    int nodeSlot(int id) const;       // message sur cerr et -1 si le tag est introuvable
+    int findNodeSlot(long long id) const {  // -1 sans message (lectures parallèles)
+        return (id >= 0 && id < (long long)tagToSlot.size()) ? tagToSlot[id] : -1;
+    }
+    bool hasNode(long long id) const { return findNodeSlot(id) >= 0; }
+    // Tag existant : vérifié une fois à la pose des conditions aux limites (Solver::set*BC,
+    // BoundaryConditions), les listes de noeuds du maillage le sont par construction
+    int dof(int id, int d) const { return 2 * nodeSlot(id) + d; }
+    int nbDofs() const { return 2 * nbNodes(); }
+    int nbNodes() const { return nodeX.size(); }
+    int nbElements() const { return elementMaterial.size(); }
+    int nbEdges() const { return edgeTags.size(); }
+    int nbColors() const { return colorStart.empty() ? 0 : (int)colorStart.size() - 1; }
     double width() const { return xMax - xMin; }
     double height() const { return yMax - yMin; }
-    
-    void loadFromGmsh(const std::string& filename);
+
+    Eigen::Vector2d nodeCoords(int slot) const { return Eigen::Vector2d(nodeX[slot], nodeY[slot]); }
+    const int32_t* elementNodes(int e) const { return &connectivity[3 * e]; }
+    const Material* material(int e) const { return materials[elementMaterial[e]]; }
+    int elementTag(int e) const { return materialTags[elementMaterial[e]]; }
+
+    // Calculs élémentaires
+    void elementB(int e, ElementB& B) const;
+    void elementStiffness(int e, ElementMatrix& Ke) const;
+    void clearElementMatrices() { elementMatrices.clear(); }
+
+    bool loadFromGmsh(const std::string& filename);   // false si la lecture a échoué
+    void buildNodeIndex();
     void initializeElements();
+    void buildNodeElements();
+    void computeColoring();
     void computeGeometry();
-    
+    size_t memoryUsage() const;
+
     std::vector<int> findNodesAtY(double y, double tol = 1e-6) const;
 };
 
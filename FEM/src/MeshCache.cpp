@@ -0,0 +1,50 @@
+#include "MeshCache.h"
+#include "MeshReader.h"
+#include "MeshRefinement.h"
+
+using namespace std;
+using namespace Eigen;
+
+bool MeshCache::get(const string& file, int refine, bool snapshot, const map<int, Material*>& materials,
+                    Mesh& mesh, vector<SparseMatrix<double>>& prolongations, bool& hit, ostream& log) {
+    Entry* entry;
+    {
+        lock_guard<mutex> guard(_lock);
+        unique_ptr<Entry>& slot = _entries[make_pair(file, refine)];
+        if (!slot) slot.reset(new Entry());
+        entry = slot.get();
+    }
+
+    // Verrou propre à l'entrée : des maillages différents sont lus en parallèle
+    {
+        lock_guard<mutex> guard(entry->lock);
+        hit = entry->loaded;
+        if (!hit) {
+            MeshReader reader(&entry->mesh);
+            reader.setLog(&log);
+            reader.setSnapshotCache(snapshot);
+            for (const auto& m : materials) reader.setMaterial(m.first, m.second);
+            if (!reader.readGmshFile(file)) {
+                entry->mesh = Mesh();
+                return false;
+            }
+            entry->prolongations = refineUniform(entry->mesh, refine, log);
+            for (Material*& mat : entry->mesh.materials) mat = nullptr;
+            entry->loaded = true;
+        }
+    }
+    {
+        lock_guard<mutex> guard(_lock);
+        if (hit) _hits++;
+        else _misses++;
+    }
+
+    // L'entrée n'est plus modifiée une fois chargée : copie sans verrou
+    mesh = entry->mesh;
+    prolongations = entry->prolongations;
+    for (size_t i = 0; i < mesh.materials.size(); i++) {
+        map<int, Material*>::const_iterator it = materials.find(mesh.materialTags[i]);
+        mesh.materials[i] = (it != materials.end()) ? it->second : nullptr;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <Eigen/Sparse>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <iostream>
+#include "Mesh.h"
+
+class MeshCache {
+    // Maillages partagés entre calculs concurrents (mode batch). La première demande d'un
+    // couple (fichier, raffinements) lit et raffine le maillage ; les demandes suivantes, y
+    // compris celles arrivées pendant la lecture, en reçoivent une copie. Les maillages en
+    // cache ne sont jamais modifiés et ne portent pas de matériaux : chaque copie est liée
+    // aux matériaux du demandeur par tag physique.
+
+    private:
+        struct Entry {
+            std::mutex lock;
+            bool loaded;
+            Mesh mesh;
+            std::vector<Eigen::SparseMatrix<double>> prolongations;
+            Entry() : loaded(false) {}
+        };
+
+        std::mutex _lock;
+        std::map<std::pair<std::string, int>, std::unique_ptr<Entry>> _entries;
+        int _hits, _misses;
+
+    public:
+        MeshCache() : _hits(0), _misses(0) {}
+
+        // Copie dans mesh du maillage file raffiné refine fois (prolongements des niveaux dans
+        // prolongations). snapshot : instantané binaire utilisé pour la lecture initiale. hit
+        // reçoit true si le maillage était déjà en cache. Retourne false si la lecture a échoué :
+        // l'entrée reste non chargée, la demande suivante relit le fichier.
+        bool get(const std::string& file, int refine, bool snapshot, const std::map<int, Material*>& materials,
+                 Mesh& mesh, std::vector<Eigen::SparseMatrix<double>>& prolongations, bool& hit,
+                 std::ostream& log = std::cout);
+
+        int hits() const { return _hits; }
+        int misses() const { return _misses; }
+};
+
+#endif
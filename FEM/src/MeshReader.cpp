@@ -1,14 +1,149 @@
 #include "MeshReader.h"
+#include "MeshSnapshot.h"
 #include <iostream>
-#include <sstream>
 #include <algorithm>
 #include <vector>
-#include <fstream>
 #include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
 
 using namespace std;
 using namespace Eigen;
 
+namespace {
+
+// Nombre d'entités (noeuds ou éléments) d'un paquet de lecture parallèle
+const int chunkSize = 4096;
+
+// Paquet d'entités consécutives d'un bloc : début dans le tampon, nombre, position de sortie
+struct Chunk {
+    const char* p;
+    int count;
+    size_t offset;
+    int block;
+};
+
+// Fin de lecture des éléments : échec si certains référencent des noeuds inexistants
+bool checkNodeReferences(long invalid) {
+    if (invalid == 0) return true;
+    cerr << "Erreur : " << invalid << " élément(s) de la section $Elements référencent des noeuds inexistants" << endl;
+    return false;
+}
+
+// Bloc d'éléments : type Gmsh, tag d'entité, matériau, début des triangles ou arêtes en sortie
+struct ElementBlock {
+    int type;
+    int entityTag;
+    int material;
+    size_t offset;
+};
+
+inline bool isSpace(char c) { return (unsigned char)c <= ' '; }
+
+inline void skipSpaces(const char*& p, const char* end) {
+    while (p < end && isSpace(*p)) p++;
+}
+
+inline void skipLine(const char*& p, const char* end) {
+    const void* nl = memchr(p, '\n', end - p);
+    p = nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+inline long long parseInt(const char*& p, const char* end) {
+    skipSpaces(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = 10 * v + (*p++ - '0');
+    return negative ? -v : v;
+}
+
+// Réels : chemin rapide de Clinger (mantisse < 2^53 et |exposant| <= 22, arrondi exact),
+// sinon strtod, ce qui donne bit à bit les mêmes valeurs qu'une lecture par flux
+inline double parseDouble(const char*& p, const char* end) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    skipSpaces(p, end);
+    const char* start = p;
+    const char* q = p;
+    bool negative = false;
+    if (q < end && (*q == '-' || *q == '+')) negative = (*q++ == '-');
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    while (q < end && *q >= '0' && *q <= '9') {
+        if (mantissa || *q != '0') digits++;
+        mantissa = 10 * mantissa + (*q++ - '0');
+    }
+    if (q < end && *q == '.') {
+        q++;
+        while (q < end && *q >= '0' && *q <= '9') {
+            if (mantissa || *q != '0') digits++;
+            mantissa = 10 * mantissa + (*q++ - '0');
+            exponent--;
+        }
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        q++;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+')) negativeExponent = (*q++ == '-');
+        int e = 0;
+        while (q < end && *q >= '0' && *q <= '9') e = 10 * e + (*q++ - '0');
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+        p = q;
+        double v = (double)mantissa;
+        v = exponent < 0 ? v / powers[-exponent] : v * powers[exponent];
+        return negative ? -v : v;
+    }
+    char* stop;
+    double v = strtod(start, &stop);
+    p = stop;
+    return v;
+}
+
+template <typename T>
+inline T readBinary(const char*& p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return v;
+}
+
+// Nombre de noeuds des types d'éléments Gmsh courants (-1 si inconnu)
+int nodesPerElement(int type) {
+    switch (type) {
+        case 1: return 2;    // segment
+        case 2: return 3;    // triangle
+        case 3: return 4;    // quadrangle
+        case 4: return 4;    // tétraèdre
+        case 5: return 8;    // hexaèdre
+        case 6: return 6;    // prisme
+        case 7: return 5;    // pyramide
+        case 8: return 3;    // segment quadratique
+        case 9: return 6;    // triangle quadratique
+        case 10: return 9;   // quadrangle quadratique
+        case 11: return 10;  // tétraèdre quadratique
+        case 15: return 1;   // point
+        default: return -1;
+    }
+}
+
+// Fin de section : position juste après la ligne "$End<name>"
+const char* findSectionEnd(const char* p, const char* end, const string& name) {
+    string marker = "$End" + name;
+    const char* found = search(p, end, marker.begin(), marker.end());
+    if (found == end) return end;
+    found += marker.size();
+    skipLine(found, end);
+    return found;
+}
+
+}
+
 Edge::Edge(int n1, int n2, int t) : node1(min(n1, n2)), node2(max(n1, n2)), tag(t) {}
 
 bool Edge::operator<(const Edge& other) const {
@@ -16,228 +151,471 @@ bool Edge::operator<(const Edge& other) const {
     return node2 < other.node2;
 }
 
-MeshReader::MeshReader(Mesh* m) : mesh(m) {}
+MeshReader::MeshReader(Mesh* m) : mesh(m), snapshotCache(false), log(&cout) {}
 
 void MeshReader::setMaterial(int tag, Material* mat) {
     materialMap[tag] = mat;
 }
 
-void MeshReader::readGmshFile(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+bool MeshReader::readGmshFile(const string& filename) {
+    auto t0 = chrono::high_resolution_clock::now();
+    MappedFile file(filename);
+    if (!file.isOpen()) {
         cerr << "Erreur : impossible d'ouvrir " << filename << endl;
-        return;
-    }
-    
-    string line;
-    while (getline(file, line)) {
-        if (line.find("$Nodes") != string::npos) {
-            readNodes(file);
-        }
-        else if (line.find("$Elements") != string::npos) {
-            readElements(file);
-        }
-    }
-    
-    file.close();
-    printStatistics();
-}
-
-void MeshReader::readNodes(ifstream& file) {
-    string line;
-    getline(file, line);
-    
-    int numNodes;
-    istringstream iss(line);
-    
-    // Détecter le format Gmsh
-    if (line.find_first_of("0123456789") == 0) {
-        vector<string> tokens;
-        string token;
-        while (iss >> token) {
-            tokens.push_back(token);
-        }
-        
-        if (tokens.size() == 4) {
-            // Format Gmsh 4.x : numEntityBlocks numNodes minNodeTag maxNodeTag
-            int numEntityBlocks = stoi(tokens[0]);
-            numNodes = stoi(tokens[1]);
-            
-            for (int i = 0; i < numEntityBlocks; i++) {
-                getline(file, line);
-                istringstream blockHeader(line);
-                int entityDim, entityTag, parametric, numNodesInBlock;
-                blockHeader >> entityDim >> entityTag >> parametric >> numNodesInBlock;
-                
-                // Lire les IDs des noeuds
-                vector<int> nodeIds;
-                for (int j = 0; j < numNodesInBlock; j++) {
-                    getline(file, line);
-                    nodeIds.push_back(stoi(line));
+        return false;
+    }
+
+    if (!snapshotCache) {
+        if (!parseGmshBuffer(file.data(), file.size())) return false;
+    } else {
+        string snapshot = filename + ".snap";
+        if (loadMeshSnapshot(*mesh, snapshot, file, materialMap)) {
+            chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+            *log << "Maillage chargé depuis l'instantané " << snapshot << " (" << elapsed.count() * 1e3 << " ms)" << endl;
+            return true;
+        }
+
+        if (!parseGmshBuffer(file.data(), file.size())) return false;
+        if (mesh->nbElements() > 0 && saveMeshSnapshot(*mesh, snapshot, file)) {
+            *log << "Instantané du maillage écrit dans " << snapshot << endl;
+        }
+    }
+
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    *log << "Lecture du maillage : " << file.size() / 1048576.0 << " Mo en " << elapsed.count() * 1e3
+         << " ms (" << file.size() / 1048576.0 / max(elapsed.count(), 1e-9) << " Mo/s)" << endl;
+    return true;
+}
+
+bool MeshReader::parseGmshBuffer(const char* data, size_t size) {
+    const char* p = data;
+    const char* end = data + size;
+    double version = 2.2;
+    bool binary = false;
+
+    while (p < end) {
+        skipSpaces(p, end);
+        if (p >= end) break;
+        if (*p != '$') {
+            skipLine(p, end);
+            continue;
+        }
+
+        const char* nameEnd = p;
+        while (nameEnd < end && !isSpace(*nameEnd)) nameEnd++;
+        string section(p + 1, nameEnd);
+        p = nameEnd;
+        skipLine(p, end);
+
+        if (section == "MeshFormat") {
+            version = parseDouble(p, end);
+            binary = (parseInt(p, end) == 1);
+            int dataSize = parseInt(p, end);
+            skipLine(p, end);
+            if (binary) {
+                if (version < 4.1 || dataSize != (int)sizeof(size_t)) {
+                    cerr << "Erreur : format Gmsh binaire " << version << " non supporté (4.1 attendu)" << endl;
+                    return false;
                 }
-                
-                // Lire les coordonnées
-                for (int j = 0; j < numNodesInBlock; j++) {
-                    getline(file, line);
-                    istringstream coords(line);
-                    double x, y, z;
-                    coords >> x >> y >> z;
-                    
-                    Vector2d pos(x, y);
-                    mesh->addNode(Node(nodeIds[j], pos));
+                if (end - p < 4 || readBinary<int>(p) != 1) {
+                    cerr << "Erreur : fichier Gmsh binaire d'un autre boutisme" << endl;
+                    return false;
                 }
             }
+            p = findSectionEnd(p, end, section);
         }
-        else {
-            // Format Gmsh 2.2 : simple numNodes
-            numNodes = stoi(tokens[0]);
-            for (int i = 0; i < numNodes; i++) {
-                getline(file, line);
-                istringstream nodeStream(line);
-                int id;
-                double x, y, z;
-                nodeStream >> id >> x >> y >> z;
-                
-                Vector2d pos(x, y);
-                mesh->addNode(Node(id, pos));
-            }
+        else if (section == "Nodes") {
+            bool ok = (version < 4.0) ? readNodesLegacy(p, end) : binary ? readNodesBinary(p, end) : readNodes(p, end);
+            if (!ok) return false;
+            p = findSectionEnd(p, end, section);
+
+            // Les éléments référencent les noeuds par slot : indexer avant de les lire
+            mesh->buildNodeIndex();
+        }
+        else if (section == "Elements") {
+            bool ok = (version < 4.0) ? readElementsLegacy(p, end) : binary ? readElementsBinary(p, end) : readElements(p, end);
+            if (!ok) return false;
+            p = findSectionEnd(p, end, section);
+        }
+        else if (section.compare(0, 3, "End") != 0) {
+            // Section ignorée ($PhysicalNames, $Entities...), éventuellement binaire
+            p = findSectionEnd(p, end, section);
+        }
+    }
+    if (mesh->nbElements() == 0) {
+        cerr << "Erreur : aucun élément triangulaire lu" << endl;
+        return false;
+    }
+    return true;
+}
+
+int MeshReader::blockMaterial(int entityTag) {
+    map<int, Material*>::const_iterator it = materialMap.find(entityTag);
+    Material* mat = (it != materialMap.end()) ? it->second : nullptr;
+    if (mat == nullptr) {
+        cerr << "Attention : matériau non défini pour le tag " << entityTag << endl;
+    }
+    return mesh->addMaterial(entityTag, mat);
+}
+
+bool MeshReader::readNodes(const char*& p, const char* end) {
+    // Format Gmsh 4.1 : numEntityBlocks numNodes minNodeTag maxNodeTag, puis par bloc
+    // entityDim entityTag parametric numNodesInBlock, les tags puis les coordonnées
+    int numBlocks = parseInt(p, end);
+    size_t numNodes = parseInt(p, end);
+    skipLine(p, end);
+
+    // Premier passage : repérage des paquets (sauts de lignes seulement)
+    size_t base = mesh->nbNodes();
+    vector<Chunk> tags, coords;
+    size_t offset = base;
+    for (int b = 0; b < numBlocks && p < end; b++) {
+        parseInt(p, end);
+        parseInt(p, end);
+        parseInt(p, end);
+        int n = parseInt(p, end);
+        skipLine(p, end);
+        for (int j = 0; j < n; j += chunkSize) {
+            Chunk c = {p, min(chunkSize, n - j), offset + j, b};
+            tags.push_back(c);
+            for (int k = 0; k < c.count; k++) skipLine(p, end);
+        }
+        for (int j = 0; j < n; j += chunkSize) {
+            Chunk c = {p, min(chunkSize, n - j), offset + j, b};
+            coords.push_back(c);
+            for (int k = 0; k < c.count; k++) skipLine(p, end);
+        }
+        offset += n;
+    }
+    if (offset - base != numNodes) {
+        cerr << "Attention : " << offset - base << " noeuds lus pour " << numNodes << " annoncés" << endl;
+    }
+
+    mesh->nodeX.resize(offset);
+    mesh->nodeY.resize(offset);
+    mesh->slotToTag.resize(offset);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < (int)tags.size(); k++) {
+        const char* q = tags[k].p;
+        for (int j = 0; j < tags[k].count; j++) {
+            mesh->slotToTag[tags[k].offset + j] = parseInt(q, end);
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < (int)coords.size(); k++) {
+        const char* q = coords[k].p;
+        for (int j = 0; j < coords[k].count; j++) {
+            mesh->nodeX[coords[k].offset + j] = parseDouble(q, end);
+            mesh->nodeY[coords[k].offset + j] = parseDouble(q, end);
+            skipLine(q, end);  // z et éventuelles coordonnées paramétriques
+        }
+    }
+    return true;
+}
+
+bool MeshReader::readNodesBinary(const char*& p, const char* end) {
+    // Même structure qu'en ASCII : size_t pour les nombres et tags, int pour l'en-tête
+    // de bloc, 3 double par noeud. Les positions de chaque bloc se déduisent des tailles.
+    if (end - p < (ptrdiff_t)(4 * sizeof(size_t))) {
+        cerr << "Erreur : section $Nodes binaire tronquée" << endl;
+        return false;
+    }
+    size_t numBlocks = readBinary<size_t>(p);
+    size_t numNodes = readBinary<size_t>(p);
+    p += 2 * sizeof(size_t);
+
+    struct NodeBlock { const char* tags; const char* coords; size_t n, offset; };
+    vector<NodeBlock> blocks;
+    size_t base = mesh->nbNodes();
+    size_t offset = base;
+    for (size_t b = 0; b < numBlocks; b++) {
+        if (end - p < (ptrdiff_t)(3 * sizeof(int) + sizeof(size_t))) break;
+        p += sizeof(int);  // entityDim
+        p += sizeof(int);  // entityTag
+        int parametric = readBinary<int>(p);
+        size_t n = readBinary<size_t>(p);
+        if (parametric) {
+            cerr << "Erreur : coordonnées paramétriques non supportées en binaire" << endl;
+            return false;
+        }
+        NodeBlock block = {p, p + n * sizeof(size_t), n, offset};
+        p += n * (sizeof(size_t) + 3 * sizeof(double));
+        if (p > end) {
+            cerr << "Erreur : section $Nodes binaire tronquée" << endl;
+            p = end;
+            return false;
+        }
+        blocks.push_back(block);
+        offset += n;
+    }
+    if (offset - base != numNodes) {
+        cerr << "Attention : " << offset - base << " noeuds lus pour " << numNodes << " annoncés" << endl;
+    }
+
+    mesh->nodeX.resize(offset);
+    mesh->nodeY.resize(offset);
+    mesh->slotToTag.resize(offset);
+
+    vector<Chunk> chunks;
+    for (size_t b = 0; b < blocks.size(); b++) {
+        for (size_t j = 0; j < blocks[b].n; j += chunkSize) {
+            Chunk c = {nullptr, (int)min((size_t)chunkSize, blocks[b].n - j), j, (int)b};
+            chunks.push_back(c);
         }
     }
-    
-    getline(file, line);  // $EndNodes
-}
-
-void MeshReader::readElements(ifstream& file) {
-    string line;
-    getline(file, line);
-    
-    int numElements;
-    istringstream iss(line);
-    
-    int elemIdCounter = 1;
-    int numTrianglesMatrix = 0;
-    int numTrianglesFiber = 0;
-    int numEdgesFiberMatrix = 0;
-    int numEdgesBoundary = 0;
-    
-    vector<string> tokens;
-    string token;
-    while (iss >> token) {
-        tokens.push_back(token);
-    }
-    
-    if (tokens.size() == 4) {
-        // Format Gmsh 4.x : numEntityBlocks numElements minTag maxTag
-        int numEntityBlocks = stoi(tokens[0]);
-        numElements = stoi(tokens[1]);
-        
-        for (int i = 0; i < numEntityBlocks; i++) {
-            getline(file, line);
-            istringstream blockHeader(line);
-            int entityDim, entityTag, elementType, numElementsInBlock;
-            blockHeader >> entityDim >> entityTag >> elementType >> numElementsInBlock;
-            
-            for (int j = 0; j < numElementsInBlock; j++) {
-                getline(file, line);
-                istringstream elemStream(line);
-                int elemId;
-                elemStream >> elemId;
-                
-                if (elementType == 2) {  // Triangle
-                    int n1, n2, n3;
-                    elemStream >> n1 >> n2 >> n3;
-                    
-                    vector<int> nodeIds = {n1, n2, n3};
-                    Material* mat = materialMap[entityTag];
-                    
-                    if (mat == nullptr) {
-                        cerr << "Attention : matériau non défini pour le tag " 
-                                  << entityTag << endl;
-                    }
-                    
-                    mesh->addElement(Element(elemIdCounter++, nodeIds, mat));
-                    
-                    if (entityTag == 1) numTrianglesMatrix++;
-                    else if (entityTag == 2) numTrianglesFiber++;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int k = 0; k < (int)chunks.size(); k++) {
+        const NodeBlock& block = blocks[chunks[k].block];
+        const char* t = block.tags + chunks[k].offset * sizeof(size_t);
+        const char* x = block.coords + chunks[k].offset * 3 * sizeof(double);
+        for (int j = 0; j < chunks[k].count; j++) {
+            size_t slot = block.offset + chunks[k].offset + j;
+            mesh->slotToTag[slot] = readBinary<size_t>(t);
+            mesh->nodeX[slot] = readBinary<double>(x);
+            mesh->nodeY[slot] = readBinary<double>(x);
+            x += sizeof(double);
+        }
+    }
+    return true;
+}
+
+bool MeshReader::readNodesLegacy(const char*& p, const char* end) {
+    // Format Gmsh 2.2 : numNodes puis "id x y z" par ligne
+    int numNodes = parseInt(p, end);
+    skipLine(p, end);
+    mesh->reserve(mesh->nbNodes() + numNodes, 0);
+    for (int i = 0; i < numNodes && p < end; i++) {
+        int id = parseInt(p, end);
+        double x = parseDouble(p, end);
+        double y = parseDouble(p, end);
+        skipLine(p, end);
+        mesh->addNode(id, x, y);
+    }
+    return true;
+}
+
+bool MeshReader::readElements(const char*& p, const char* end) {
+    // Format Gmsh 4.1 : numEntityBlocks numElements minTag maxTag, puis par bloc
+    // entityDim entityTag elementType numElementsInBlock et une ligne par élément
+    int numBlocks = parseInt(p, end);
+    parseInt(p, end);
+    skipLine(p, end);
+
+    // Premier passage : blocs, matériaux et positions de sortie, paquets de lignes
+    vector<ElementBlock> blocks;
+    vector<Chunk> chunks;
+    size_t triangles = mesh->nbElements(), edges = mesh->nbEdges();
+    for (int b = 0; b < numBlocks && p < end; b++) {
+        parseInt(p, end);
+        ElementBlock block;
+        block.entityTag = parseInt(p, end);
+        block.type = parseInt(p, end);
+        int n = parseInt(p, end);
+        skipLine(p, end);
+
+        block.material = -1;
+        block.offset = 0;
+        if (block.type == 2) {
+            block.material = blockMaterial(block.entityTag);
+            block.offset = triangles;
+            triangles += n;
+        } else if (block.type == 1) {
+            block.offset = edges;
+            edges += n;
+        }
+        blocks.push_back(block);
+
+        for (int j = 0; j < n; j += chunkSize) {
+            Chunk c = {p, min(chunkSize, n - j), (size_t)j, b};
+            if (block.type == 1 || block.type == 2) chunks.push_back(c);
+            for (int k = 0; k < c.count; k++) skipLine(p, end);
+        }
+    }
+
+    mesh->connectivity.resize(3 * triangles);
+    mesh->elementMaterial.resize(triangles);
+    mesh->edgeNodes.resize(2 * edges);
+    mesh->edgeTags.resize(edges);
+
+    // Éléments aux noeuds introuvables comptés par paquet (pas de message depuis les threads),
+    // slot 0 en attendant l'échec de la lecture
+    long invalid = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:invalid)
+    for (int k = 0; k < (int)chunks.size(); k++) {
+        const ElementBlock& block = blocks[chunks[k].block];
+        const char* q = chunks[k].p;
+        long missing = 0;
+        for (int j = 0; j < chunks[k].count; j++) {
+            size_t e = block.offset + chunks[k].offset + j;
+            parseInt(q, end);  // tag de l'élément
+            if (block.type == 2) {
+                bool bad = false;
+                for (int a = 0; a < 3; a++) {
+                    int slot = mesh->findNodeSlot(parseInt(q, end));
+                    bad |= (slot < 0);
+                    mesh->connectivity[3*e + a] = max(slot, 0);
                 }
-                else if (elementType == 1) {  // Segment (arête)
-                    int n1, n2;
-                    elemStream >> n1 >> n2;
-                    
-                    edges.insert(Edge(n1, n2, entityTag));
-                    
-                    if (entityTag == 11) numEdgesFiberMatrix++;
-                    else if (entityTag == 12) numEdgesBoundary++;
+                missing += bad;
+                mesh->elementMaterial[e] = block.material;
+            } else {
+                bool bad = false;
+                for (int a = 0; a < 2; a++) {
+                    int slot = mesh->findNodeSlot(parseInt(q, end));
+                    bad |= (slot < 0);
+                    mesh->edgeNodes[2*e + a] = max(slot, 0);
                 }
+                missing += bad;
+                mesh->edgeTags[e] = block.entityTag;
             }
+            skipLine(q, end);
         }
+        invalid += missing;
+    }
+    return checkNodeReferences(invalid);
+}
+
+bool MeshReader::readElementsBinary(const char*& p, const char* end) {
+    if (end - p < (ptrdiff_t)(4 * sizeof(size_t))) {
+        cerr << "Erreur : section $Elements binaire tronquée" << endl;
+        return false;
     }
-    else {
-        // Format Gmsh 2.2
-        numElements = stoi(tokens[0]);
-        
-        for (int i = 0; i < numElements; i++) {
-            getline(file, line);
-            istringstream elemStream(line);
-            
-            int elemId, elemType, numTags;
-            elemStream >> elemId >> elemType >> numTags;
-            
-            vector<int> tags;
-            for (int t = 0; t < numTags; t++) {
-                int tag;
-                elemStream >> tag;
-                tags.push_back(tag);
+    size_t numBlocks = readBinary<size_t>(p);
+    p += 3 * sizeof(size_t);
+
+    vector<ElementBlock> blocks;
+    vector<const char*> blockData;
+    vector<Chunk> chunks;
+    size_t triangles = mesh->nbElements(), edges = mesh->nbEdges();
+    for (size_t b = 0; b < numBlocks; b++) {
+        if (end - p < (ptrdiff_t)(3 * sizeof(int) + sizeof(size_t))) break;
+        p += sizeof(int);  // entityDim
+        ElementBlock block;
+        block.entityTag = readBinary<int>(p);
+        block.type = readBinary<int>(p);
+        size_t n = readBinary<size_t>(p);
+        int nodes = nodesPerElement(block.type);
+        if (nodes < 0) {
+            cerr << "Erreur : type d'élément Gmsh " << block.type << " inconnu en binaire" << endl;
+            p = end;
+            return false;
+        }
+
+        block.material = -1;
+        block.offset = 0;
+        if (block.type == 2) {
+            block.material = blockMaterial(block.entityTag);
+            block.offset = triangles;
+            triangles += n;
+        } else if (block.type == 1) {
+            block.offset = edges;
+            edges += n;
+        }
+        blocks.push_back(block);
+        blockData.push_back(p);
+        if (block.type == 1 || block.type == 2) {
+            for (size_t j = 0; j < n; j += chunkSize) {
+                Chunk c = {nullptr, (int)min((size_t)chunkSize, n - j), j, (int)b};
+                chunks.push_back(c);
             }
-            
-            int physicalTag = (numTags > 0) ? tags[0] : 0;
-            
-            if (elemType == 2) {  // Triangle
-                int n1, n2, n3;
-                elemStream >> n1 >> n2 >> n3;
-                
-                vector<int> nodeIds = {n1, n2, n3};
-                Material* mat = materialMap[physicalTag];
-                
-                if (mat == nullptr) {
-                    cerr << "Attention : matériau non défini pour le tag " 
-                              << physicalTag << endl;
+        }
+        p += n * (1 + nodes) * sizeof(size_t);
+        if (p > end) {
+            cerr << "Erreur : section $Elements binaire tronquée" << endl;
+            p = end;
+            return false;
+        }
+    }
+
+    mesh->connectivity.resize(3 * triangles);
+    mesh->elementMaterial.resize(triangles);
+    mesh->edgeNodes.resize(2 * edges);
+    mesh->edgeTags.resize(edges);
+
+    long invalid = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:invalid)
+    for (int k = 0; k < (int)chunks.size(); k++) {
+        const ElementBlock& block = blocks[chunks[k].block];
+        int nodes = nodesPerElement(block.type);
+        const char* q = blockData[chunks[k].block] + chunks[k].offset * (1 + nodes) * sizeof(size_t);
+        long missing = 0;
+        for (int j = 0; j < chunks[k].count; j++) {
+            size_t e = block.offset + chunks[k].offset + j;
+            q += sizeof(size_t);  // tag de l'élément
+            if (block.type == 2) {
+                bool bad = false;
+                for (int a = 0; a < 3; a++) {
+                    int slot = mesh->findNodeSlot(readBinary<size_t>(q));
+                    bad |= (slot < 0);
+                    mesh->connectivity[3*e + a] = max(slot, 0);
                 }
-                
-                mesh->addElement(Element(elemIdCounter++, nodeIds, mat));
-                
-                if (physicalTag == 1) numTrianglesMatrix++;
-                else if (physicalTag == 2) numTrianglesFiber++;
-            }
-            else if (elemType == 1) {  // Segment (arête)
-                int n1, n2;
-                elemStream >> n1 >> n2;
-                
-                edges.insert(Edge(n1, n2, physicalTag));
-                
-                if (physicalTag == 11) numEdgesFiberMatrix++;
-                else if (physicalTag == 12) numEdgesBoundary++;
+                missing += bad;
+                mesh->elementMaterial[e] = block.material;
+            } else {
+                bool bad = false;
+                for (int a = 0; a < 2; a++) {
+                    int slot = mesh->findNodeSlot(readBinary<size_t>(q));
+                    bad |= (slot < 0);
+                    mesh->edgeNodes[2*e + a] = max(slot, 0);
+                }
+                missing += bad;
+                mesh->edgeTags[e] = block.entityTag;
             }
         }
+        invalid += missing;
     }
-    
-    getline(file, line);  // $EndElements
+    return checkNodeReferences(invalid);
 }
 
-void MeshReader::printStatistics() const {
-    // Statistiques simplifiées déjà affichées
+bool MeshReader::readElementsLegacy(const char*& p, const char* end) {
+    // Format Gmsh 2.2 : "id type numTags tags... noeuds" par ligne, tag physique en premier
+    int numElements = parseInt(p, end);
+    skipLine(p, end);
+    mesh->reserve(mesh->nbNodes(), mesh->nbElements() + numElements);
+
+    long invalid = 0;  // éléments écartés : un de leurs noeuds est introuvable
+    for (int i = 0; i < numElements && p < end; i++) {
+        parseInt(p, end);
+        int elemType = parseInt(p, end);
+        int numTags = parseInt(p, end);
+        int physicalTag = 0;
+        for (int t = 0; t < numTags; t++) {
+            int tag = parseInt(p, end);
+            if (t == 0) physicalTag = tag;
+        }
+
+        if (elemType == 2) {  // Triangle
+            int n1 = parseInt(p, end), n2 = parseInt(p, end), n3 = parseInt(p, end);
+            if (!mesh->addElement(n1, n2, n3, blockMaterial(physicalTag))) invalid++;
+        }
+        else if (elemType == 1) {  // Segment (arête)
+            int n1 = parseInt(p, end), n2 = parseInt(p, end);
+            if (!mesh->addEdge(n1, n2, physicalTag)) invalid++;
+        }
+        skipLine(p, end);
+    }
+    return checkNodeReferences(invalid);
 }
 
-const set<Edge>& MeshReader::getEdges() const {
-    return edges;
+vector<Edge> MeshReader::getEdges() const {
+    vector<Edge> result;
+    result.reserve(mesh->nbEdges());
+    for (int i = 0; i < mesh->nbEdges(); i++) {
+        result.push_back(Edge(mesh->slotToTag[mesh->edgeNodes[2*i]],
+                              mesh->slotToTag[mesh->edgeNodes[2*i+1]], mesh->edgeTags[i]));
+    }
+    return result;
 }
 
 vector<Edge> MeshReader::getEdgesByTag(int tag) const {
     vector<Edge> result;
-    for (const auto& edge : edges) {
-        if (edge.tag == tag) {
-            result.push_back(edge);
+    for (int i = 0; i < mesh->nbEdges(); i++) {
+        if (mesh->edgeTags[i] == tag) {
+            result.push_back(Edge(mesh->slotToTag[mesh->edgeNodes[2*i]],
+                                  mesh->slotToTag[mesh->edgeNodes[2*i+1]], tag));
         }
     }
     return result;
-}
\ No newline at end of file
+}
@@ -6,7 +6,7 @@
 #include <map>
 #include <set>
 #include <vector>
-#include <fstream>
+#include <iostream>
 
 // Structure pour stocker les informations d'une arête
 struct Edge {
@@ -22,12 +22,21 @@ class MeshReader {
 private:
     Mesh* mesh;
     std::map<int, Material*> materialMap;  // tag -> Material
-    std::set<Edge> edges;
+    bool snapshotCache;                    // relire/écrire l'instantané binaire <fichier>.snap
+    std::ostream* log;                     // messages de lecture (std::cout par défaut)
     
-    // Méthodes privées pour la lecture
-    void readNodes(std::ifstream& file);
-    void readElements(std::ifstream& file);
-    void printStatistics() const;
+    // Lecture depuis le fichier projeté en mémoire : chaque méthode avance p jusqu'à la fin
+    // de sa section. Les blocs d'entités des formats 4.1 sont découpés en paquets lus en parallèle.
+    // Retournent false (message sur cerr) si la section est tronquée ou si des éléments
+    // référencent des noeuds inexistants.
+    bool parseGmshBuffer(const char* data, size_t size);   // false : format non supporté
+    bool readNodes(const char*& p, const char* end);           // Gmsh 4.1 ASCII
+    bool readNodesBinary(const char*& p, const char* end);     // Gmsh 4.1 binaire
+    bool readNodesLegacy(const char*& p, const char* end);     // Gmsh 2.2 ASCII
+    bool readElements(const char*& p, const char* end);
+    bool readElementsBinary(const char*& p, const char* end);
+    bool readElementsLegacy(const char*& p, const char* end);
+    int blockMaterial(int entityTag);
     
 public:
     MeshReader(Mesh* m);
@@ -35,11 +44,20 @@ public:
     // Associer un matériau à un tag physique
     void setMaterial(int tag, Material* mat);
     
-    // Lire le fichier Gmsh
-    void readGmshFile(const std::string& filename);
+    // Instantané binaire : à la lecture, <fichier>.snap est chargé s'il correspond au fichier
+    // Gmsh (taille et date, empreinte si la date diffère), sinon le fichier est analysé puis
+    // l'instantané (ré)écrit
+    void setSnapshotCache(bool enabled) { snapshotCache = enabled; }
     
-    // Accéder aux arêtes
-    const std::set<Edge>& getEdges() const;
+    // Flux des messages de lecture (nullptr : std::cout)
+    void setLog(std::ostream* out) { log = out ? out : &std::cout; }
+    
+    // Lire le fichier Gmsh. Retourne false (message sur cerr) si le fichier est illisible,
+    // d'un format non supporté ou sans élément ; le maillage est alors à jeter.
+    bool readGmshFile(const std::string& filename);
+    
+    // Accéder aux arêtes (stockées dans le maillage)
+    std::vector<Edge> getEdges() const;
     std::vector<Edge> getEdgesByTag(int tag) const;
 };
 
@@ -0,0 +1,102 @@
+#include "MeshRefinement.h"
+#include <iostream>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace std;
+using namespace Eigen;
+
+SparseMatrix<double> refineUniform(Mesh& mesh) {
+    int nn = mesh.nbNodes();
+    int ne = mesh.nbElements();
+    int nextTag = 0;
+    for (int id : mesh.slotToTag) nextTag = max(nextTag, id + 1);
+
+    // Un milieu par arête, repérée par ses deux slots triés
+    unordered_map<long long, int> midpoints;
+    midpoints.reserve(3 * (size_t)ne / 2 + mesh.nbEdges());
+    vector<Triplet<double>> triplets;
+    triplets.reserve(nn + 3 * (size_t)ne);
+    for (int i = 0; i < nn; i++) triplets.push_back(Triplet<double>(i, i, 1.0));
+
+    auto midpoint = [&](int a, int b) -> int {
+        long long key = (long long)min(a, b) * nn + max(a, b);
+        auto it = midpoints.find(key);
+        if (it != midpoints.end()) return it->second;
+
+        int slot = mesh.addNode(nextTag++, 0.5 * (mesh.nodeX[a] + mesh.nodeX[b]),
+                                0.5 * (mesh.nodeY[a] + mesh.nodeY[b]));
+        triplets.push_back(Triplet<double>(slot, a, 0.5));
+        triplets.push_back(Triplet<double>(slot, b, 0.5));
+        midpoints[key] = slot;
+        return slot;
+    };
+
+    // Éléments : les 4 enfants remplacent le parent, orientation conservée
+    vector<int32_t> connectivity;
+    vector<uint16_t> elementMaterial;
+    connectivity.reserve(12 * (size_t)ne);
+    elementMaterial.reserve(4 * (size_t)ne);
+    for (int e = 0; e < ne; e++) {
+        int a = mesh.connectivity[3*e], b = mesh.connectivity[3*e+1], c = mesh.connectivity[3*e+2];
+        int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+        int32_t children[12] = {a, ab, ca,  ab, b, bc,  ca, bc, c,  ab, bc, ca};
+        connectivity.insert(connectivity.end(), children, children + 12);
+        elementMaterial.insert(elementMaterial.end(), 4, mesh.elementMaterial[e]);
+    }
+
+    // Arêtes : chaque segment est coupé en deux au même milieu que les triangles voisins
+    vector<int32_t> edgeNodes;
+    vector<int> edgeTags;
+    edgeNodes.reserve(2 * mesh.edgeNodes.size());
+    edgeTags.reserve(2 * mesh.edgeTags.size());
+    for (int k = 0; k < mesh.nbEdges(); k++) {
+        int a = mesh.edgeNodes[2*k], b = mesh.edgeNodes[2*k+1];
+        int m = midpoint(a, b);
+        int32_t halves[4] = {a, m, m, b};
+        edgeNodes.insert(edgeNodes.end(), halves, halves + 4);
+        edgeTags.insert(edgeTags.end(), 2, mesh.edgeTags[k]);
+    }
+
+    mesh.connectivity.swap(connectivity);
+    mesh.elementMaterial.swap(elementMaterial);
+    mesh.edgeNodes.swap(edgeNodes);
+    mesh.edgeTags.swap(edgeTags);
+
+    // Données dérivées à reconstruire
+    mesh.elementArea.clear();
+    mesh.nodeElementStart.clear();
+    mesh.nodeElements.clear();
+    mesh.colorStart.clear();
+    mesh.colorElements.clear();
+    mesh.elementMatrices.clear();
+    mesh.buildNodeIndex();
+
+    SparseMatrix<double> P(mesh.nbNodes(), nn);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+vector<SparseMatrix<double>> refineUniform(Mesh& mesh, int nbLevels, ostream& log) {
+    vector<SparseMatrix<double>> prolongations;
+    for (int l = 0; l < nbLevels; l++) {
+        prolongations.push_back(refineUniform(mesh));
+        log << "Raffinement " << l + 1 << " : " << mesh.nbNodes() << " noeuds, "
+             << mesh.nbElements() << " éléments" << endl;
+    }
+    return prolongations;
+}
+
+SparseMatrix<double> dofProlongation(const SparseMatrix<double>& P) {
+    vector<Triplet<double>> triplets;
+    triplets.reserve(2 * P.nonZeros());
+    for (int j = 0; j < P.outerSize(); j++) {
+        for (SparseMatrix<double>::InnerIterator it(P, j); it; ++it) {
+            triplets.push_back(Triplet<double>(2 * it.row(), 2 * j, it.value()));
+            triplets.push_back(Triplet<double>(2 * it.row() + 1, 2 * j + 1, it.value()));
+        }
+    }
+    SparseMatrix<double> Pd(2 * P.rows(), 2 * P.cols());
+    Pd.setFromTriplets(triplets.begin(), triplets.end());
+    return Pd;
+}
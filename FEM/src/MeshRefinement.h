@@ -0,0 +1,22 @@
+#ifndef MESH_REFINEMENT_H
+#define MESH_REFINEMENT_H
+
+#include "Mesh.h"
+#include <Eigen/Sparse>
+#include <vector>
+#include <iostream>
+
+// Raffinement uniforme : chaque triangle est découpé en 4 par les milieux de ses arêtes.
+// Les noeuds existants gardent leur slot et leur tag, les milieux reçoivent de nouveaux tags.
+// Matériau des éléments et tags des arêtes (segments Gmsh, coupés en deux) sont conservés.
+// Le maillage doit ensuite être réinitialisé (initializeElements, computeGeometry).
+// Retourne le prolongement nodal P (nbNodes fin x nbNodes grossier) : interpolation P1 exacte.
+Eigen::SparseMatrix<double> refineUniform(Mesh& mesh);
+
+// nbLevels raffinements successifs. Retourne les prolongements nodaux, du plus grossier au plus fin.
+std::vector<Eigen::SparseMatrix<double>> refineUniform(Mesh& mesh, int nbLevels, std::ostream& log = std::cout);
+
+// Prolongement sur les DDL (2 par noeud) à partir du prolongement nodal
+Eigen::SparseMatrix<double> dofProlongation(const Eigen::SparseMatrix<double>& P);
+
+#endif
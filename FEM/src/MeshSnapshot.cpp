@@ -0,0 +1,187 @@
+#include "MeshSnapshot.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+static_assert(sizeof(int) == 4, "les tableaux int du maillage sont stockés sur 32 bits");
+
+namespace {
+
+const char snapshotMagic[8] = {'F', 'E', 'M', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t snapshotVersion = 2;
+const uint32_t byteOrderMark = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    int32_t nbNodes, nbElements, nbEdges, nbMaterials;
+};
+
+// Chaque tableau commence sur un multiple de 8 octets (lecture alignée des double)
+size_t padded(size_t bytes) { return (bytes + 7) & ~(size_t)7; }
+
+template <typename T>
+void writeArray(ofstream& file, const vector<T>& v) {
+    static const char zeros[8] = {0};
+    size_t bytes = v.size() * sizeof(T);
+    if (bytes > 0) file.write(reinterpret_cast<const char*>(v.data()), bytes);
+    file.write(zeros, padded(bytes) - bytes);
+}
+
+template <typename T>
+void readArray(const char*& p, vector<T>& v, size_t count) {
+    v.resize(count);
+    if (count > 0) memcpy(v.data(), p, count * sizeof(T));
+    p += padded(count * sizeof(T));
+}
+
+}
+
+MappedFile::MappedFile(const string& filename) : _data(nullptr), _size(0), _mtime(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        _mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            _data = static_cast<const char*>(p);
+            _size = st.st_size;
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (_data) munmap(const_cast<char*>(_data), _size);
+}
+
+uint64_t fnv1aHash(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w;
+        memcpy(&w, data + 8 * i, 8);
+        hash ^= w;
+        hash *= 1099511628211ULL;
+    }
+    for (size_t i = 8 * words; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool saveMeshSnapshot(const Mesh& mesh, const string& filename, const MappedFile& source) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.byteOrder = byteOrderMark;
+    header.sourceSize = source.size();
+    header.sourceMtime = source.mtime();
+    header.sourceHash = fnv1aHash(source.data(), source.size());
+    header.nbNodes = mesh.nbNodes();
+    header.nbElements = mesh.nbElements();
+    header.nbEdges = mesh.nbEdges();
+    header.nbMaterials = mesh.materialTags.size();
+
+    // Écriture dans un fichier temporaire puis renommage : un autre processus ne voit jamais
+    // d'instantané partiel
+    string tmp = filename + ".tmp" + to_string(getpid());
+    ofstream file(tmp, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Attention : impossible d'écrire l'instantané " << filename << endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(file, mesh.slotToTag);
+    writeArray(file, mesh.nodeX);
+    writeArray(file, mesh.nodeY);
+    writeArray(file, mesh.connectivity);
+    writeArray(file, mesh.elementMaterial);
+    writeArray(file, mesh.materialTags);
+    writeArray(file, mesh.edgeNodes);
+    writeArray(file, mesh.edgeTags);
+    file.close();
+
+    if (!file || rename(tmp.c_str(), filename.c_str()) != 0) {
+        cerr << "Attention : impossible d'écrire l'instantané " << filename << endl;
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool loadMeshSnapshot(Mesh& mesh, const string& filename, const MappedFile& source,
+                      const map<int, Material*>& materials) {
+    MappedFile file(filename);
+    if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 ||
+        header.version != snapshotVersion || header.byteOrder != byteOrderMark ||
+        header.sourceSize != source.size()) {
+        return false;
+    }
+    // Source modifiée depuis l'écriture, ou seulement touchée : l'empreinte tranche. Contenu
+    // inchangé : la nouvelle date est reportée dans l'en-tête, les chargements suivants ne
+    // recalculent plus l'empreinte (au mieux, l'instantané reste valide si l'écriture échoue)
+    if (header.sourceMtime != source.mtime()) {
+        if (header.sourceHash != fnv1aHash(source.data(), source.size())) return false;
+        fstream update(filename, ios::binary | ios::in | ios::out);
+        int64_t mtime = source.mtime();
+        update.seekp(offsetof(SnapshotHeader, sourceMtime));
+        update.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+    }
+    if (header.nbNodes < 0 || header.nbElements < 0 || header.nbEdges < 0 || header.nbMaterials < 0) {
+        return false;
+    }
+
+    size_t nn = header.nbNodes, ne = header.nbElements, nk = header.nbEdges, nm = header.nbMaterials;
+    size_t expected = sizeof(header) + padded(nn * sizeof(int32_t)) + 2 * padded(nn * sizeof(double))
+                    + padded(3 * ne * sizeof(int32_t)) + padded(ne * sizeof(uint16_t))
+                    + padded(nm * sizeof(int32_t)) + padded(2 * nk * sizeof(int32_t))
+                    + padded(nk * sizeof(int32_t));
+    if (file.size() != expected) {
+        cerr << "Attention : instantané " << filename << " tronqué, ignoré" << endl;
+        return false;
+    }
+
+    const char* p = file.data() + sizeof(header);
+    readArray(p, mesh.slotToTag, nn);
+    readArray(p, mesh.nodeX, nn);
+    readArray(p, mesh.nodeY, nn);
+    readArray(p, mesh.connectivity, 3 * ne);
+    readArray(p, mesh.elementMaterial, ne);
+    readArray(p, mesh.materialTags, nm);
+    readArray(p, mesh.edgeNodes, 2 * nk);
+    readArray(p, mesh.edgeTags, nk);
+
+    mesh.materials.assign(nm, nullptr);
+    for (size_t i = 0; i < nm; i++) {
+        map<int, Material*>::const_iterator it = materials.find(mesh.materialTags[i]);
+        if (it != materials.end()) mesh.materials[i] = it->second;
+        if (mesh.materials[i] == nullptr) {
+            cerr << "Attention : matériau non défini pour le tag " << mesh.materialTags[i] << endl;
+        }
+    }
+
+    mesh.buildNodeIndex();
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef MESH_SNAPSHOT_H
+#define MESH_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include "Mesh.h"
+
+// Fichier projeté en mémoire en lecture seule (mmap). Les pages sont partagées par le cache
+// du noyau entre tous les processus qui lisent le même fichier.
+class MappedFile {
+    private:
+        const char* _data;
+        size_t _size;
+        int64_t _mtime;   // date de modification (ns depuis l'epoch)
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+    public:
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        bool isOpen() const { return _data != nullptr; }
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+        int64_t mtime() const { return _mtime; }
+};
+
+// Empreinte FNV-1a 64 bits calculée par mots de 8 octets (octets restants un à un) : un
+// produit par mot au lieu d'un par octet. Ne coïncide pas avec le FNV-1a octet par octet.
+uint64_t fnv1aHash(const char* data, size_t size);
+
+// Instantané binaire versionné d'un maillage lu : noeuds (tags et coordonnées), connectivité,
+// tags physiques des éléments et arêtes de bord. L'en-tête identifie le fichier source par sa
+// taille, sa date de modification et son empreinte : taille et date identiques, l'instantané
+// est chargé sans relire la source ; date différente (copie, touch), l'empreinte est
+// recalculée et comparée ; taille, empreinte ou version différente, il est ignoré.
+// Les matériaux ne sont pas stockés, ils sont retrouvés par tag physique au chargement.
+// Les tableaux sont copiés de la projection dans le maillage : les pages de l'instantané sont
+// partagées par le cache du noyau, pas les tableaux du maillage, que chaque processus possède
+// (en mode batch, MeshCache partage une lecture entre les jobs, chacun recevant sa copie).
+bool saveMeshSnapshot(const Mesh& mesh, const std::string& filename, const MappedFile& source);
+bool loadMeshSnapshot(Mesh& mesh, const std::string& filename, const MappedFile& source,
+                      const std::map<int, Material*>& materials);
+
+#endif
@@ -0,0 +1,154 @@
+#include "Multigrid.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+using namespace std;
+using namespace Eigen;
+
+MultigridPreconditioner::MultigridPreconditioner() : _smoother("chebyshev"), _info(Success) {}
+
+void MultigridPreconditioner::setSmoother(const string& smoother) {
+    if (smoother == "jacobi" || smoother == "chebyshev") {
+        _smoother = smoother;
+    } else {
+        cerr << "Attention : lisseur multigrille inconnu '" << smoother << "', utilisation de chebyshev" << endl;
+        _smoother = "chebyshev";
+    }
+}
+
+MultigridPreconditioner::Level MultigridPreconditioner::makeLevel(const RowMatrix& A) {
+    Level L;
+    L.A = A;
+    L.invDiag = A.diagonal().unaryExpr([](double d) { return abs(d) > 0.0 ? 1.0 / d : 1.0; });
+    L.lambdaMax = estimateLambdaMax(L.A, L.invDiag);
+    return L;
+}
+
+void MultigridPreconditioner::factorCoarsest(const string& name) {
+    SparseMatrix<double> coarsest = _levels.back().A;
+    _coarseSolver.compute(coarsest);
+    if (_coarseSolver.info() != Success) {
+        cerr << "Erreur : factorisation du niveau grossier " << name << " impossible" << endl;
+        _info = NumericalIssue;
+    }
+}
+
+double MultigridPreconditioner::estimateLambdaMax(const RowMatrix& A, const VectorXd& invDiag) {
+    // Méthode de la puissance sur D^-1 A (quelques itérations suffisent pour le lisseur)
+    int n = A.rows();
+    VectorXd v(n), w(n);
+    for (int i = 0; i < n; i++) v(i) = 1.0 + 0.1 * ((i * 7919) % 13);
+    v.normalize();
+
+    double lambda = 1.0;
+    for (int it = 0; it < 15; it++) {
+        w.noalias() = A * v;
+        w = invDiag.cwiseProduct(w);
+        lambda = w.norm();
+        if (lambda == 0.0) return 1.0;
+        v = w / lambda;
+    }
+    return lambda;
+}
+
+void MultigridPreconditioner::smooth(const Level& L, const VectorXd& b, VectorXd& x) const {
+    if (_smoother == "jacobi") {
+        // Deux balayages de Jacobi amorti
+        double omega = 4.0 / (3.0 * L.lambdaMax);
+        for (int s = 0; s < 2; s++) {
+            VectorXd r = b - L.A * x;
+            x += omega * L.invDiag.cwiseProduct(r);
+        }
+        return;
+    }
+
+    // Chebyshev de degré 3 sur [lambdaMax/30, 1.1 lambdaMax] pour D^-1 A
+    double upper = 1.1 * L.lambdaMax;
+    double lower = upper / 30.0;
+    double theta = 0.5 * (upper + lower);
+    double delta = 0.5 * (upper - lower);
+    double sigma = theta / delta;
+    double rho = 1.0 / sigma;
+
+    VectorXd r = b - L.A * x;
+    VectorXd d = L.invDiag.cwiseProduct(r) / theta;
+    x += d;
+    for (int k = 1; k < 3; k++) {
+        r -= L.A * d;
+        double rhoNew = 1.0 / (2.0 * sigma - rho);
+        d = (rhoNew * rho) * d + (2.0 * rhoNew / delta) * L.invDiag.cwiseProduct(r);
+        x += d;
+        rho = rhoNew;
+    }
+}
+
+void MultigridPreconditioner::vcycle(int level, const VectorXd& b, VectorXd& x) const {
+    const Level& L = _levels[level];
+    if (level == (int)_levels.size() - 1) {
+        x = _coarseSolver.solve(b);
+        return;
+    }
+
+    x.setZero(b.size());
+    smooth(L, b, x);
+
+    VectorXd r = b - L.A * x;
+    VectorXd rc = L.R * r;
+    VectorXd xc;
+    vcycle(level + 1, rc, xc);
+    x += L.P * xc;
+
+    smooth(L, b, x);
+}
+
+VectorXd MultigridPreconditioner::solve(const VectorXd& b) const {
+    VectorXd x;
+    if (_levels.empty()) return b;
+    vcycle(0, b, x);
+    return x;
+}
+
+double MultigridPreconditioner::operatorComplexity() const {
+    if (_levels.empty()) return 0.0;
+    double total = 0.0;
+    for (const Level& L : _levels) total += L.A.nonZeros();
+    return total / _levels[0].A.nonZeros();
+}
+
+void MultigridPreconditioner::printHierarchy(const string& name, ostream& out) const {
+    streamsize precision = out.precision();
+    out << name << " : " << _levels.size() << " niveaux, lisseur " << _smoother
+         << ", complexité " << setprecision(3) << operatorComplexity() << setprecision(precision) << endl;
+    for (size_t l = 0; l < _levels.size(); l++) {
+        out << "  Niveau " << l << " : " << _levels[l].A.rows() << " DDL, "
+             << _levels[l].A.nonZeros() << " nnz" << endl;
+    }
+}
+
+void GeometricMultigrid::setProlongations(const vector<SparseMatrix<double>>& prolongations) {
+    _prolongations.clear();
+    for (const SparseMatrix<double>& P : prolongations) _prolongations.push_back(RowMatrix(P));
+}
+
+void GeometricMultigrid::setup(const RowMatrix& A) {
+    _levels.clear();
+    _info = Success;
+
+    _levels.push_back(makeLevel(A));
+    for (size_t l = 0; l < _prolongations.size(); l++) {
+        Level& L = _levels.back();
+        if (_prolongations[l].rows() != L.A.rows()) {
+            cerr << "Erreur : prolongement " << l << " incompatible (" << _prolongations[l].rows()
+                 << " lignes pour " << L.A.rows() << " DDL)" << endl;
+            _info = InvalidInput;
+            return;
+        }
+        L.P = _prolongations[l];
+        L.R = L.P.transpose();
+        RowMatrix coarse = L.R * (L.A * L.P);
+        _levels.push_back(makeLevel(coarse));
+    }
+
+    factorCoarsest("GMG");
+}
@@ -0,0 +1,80 @@
+#ifndef MULTIGRID_H
+#define MULTIGRID_H
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <vector>
+#include <string>
+#include <iostream>
+
+class MultigridPreconditioner {
+    // Cycle en V commun aux multigrilles algébrique (AMG) et géométrique : hiérarchie
+    // d'opérateurs de Galerkin A_{l+1} = P_l^T A_l P_l, lisseur de Jacobi amorti ou de
+    // Chebyshev, niveau le plus grossier résolu par LDLt creux.
+    // Compatible avec l'interface préconditionneur d'Eigen (ConjugateGradient) via les classes dérivées.
+
+    public:
+        typedef Eigen::SparseMatrix<double, Eigen::RowMajor> RowMatrix;
+
+        struct Level {
+            RowMatrix A;
+            RowMatrix P;                // prolongement depuis le niveau suivant
+            RowMatrix R;                // restriction = P^T
+            Eigen::VectorXd invDiag;
+            double lambdaMax;           // rayon spectral estimé de D^-1 A
+        };
+
+    protected:
+        std::vector<Level> _levels;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> _coarseSolver;
+        std::string _smoother;          // "jacobi" ou "chebyshev"
+        Eigen::ComputationInfo _info;
+
+        // Diagonale inverse et rayon spectral du lisseur pour un nouveau niveau
+        static Level makeLevel(const RowMatrix& A);
+        static double estimateLambdaMax(const RowMatrix& A, const Eigen::VectorXd& invDiag);
+        void factorCoarsest(const std::string& name);
+
+        void vcycle(int level, const Eigen::VectorXd& b, Eigen::VectorXd& x) const;
+        void smooth(const Level& L, const Eigen::VectorXd& b, Eigen::VectorXd& x) const;
+
+    public:
+        MultigridPreconditioner();
+
+        void setSmoother(const std::string& smoother);
+
+        Eigen::VectorXd solve(const Eigen::VectorXd& b) const;
+        Eigen::ComputationInfo info() const { return _info; }
+
+        int nbLevels() const { return _levels.size(); }
+        double operatorComplexity() const;
+        void printHierarchy(const std::string& name, std::ostream& out = std::cout) const;
+};
+
+class GeometricMultigrid : public MultigridPreconditioner {
+    // Multigrille géométrique sur une suite de maillages emboîtés (raffinement uniforme) :
+    // les prolongements sont l'interpolation P1 exacte d'un niveau sur le suivant.
+
+    private:
+        std::vector<RowMatrix> _prolongations;  // du niveau fin vers le plus grossier
+
+        void setup(const RowMatrix& A);
+
+    public:
+        // prolongations[l] : DDL du niveau l+1 -> DDL du niveau l (0 = niveau de la matrice)
+        void setProlongations(const std::vector<Eigen::SparseMatrix<double>>& prolongations);
+
+        // Interface préconditionneur Eigen
+        template <typename MatType>
+        GeometricMultigrid& analyzePattern(const MatType&) { return *this; }
+        template <typename MatType>
+        GeometricMultigrid& factorize(const MatType& mat) {
+            setup(RowMatrix(mat));
+            return *this;
+        }
+        template <typename MatType>
+        GeometricMultigrid& compute(const MatType& mat) { return factorize(mat); }
+};
+
+#endif
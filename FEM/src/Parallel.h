@@ -0,0 +1,44 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Petites fonctions d'accès au nombre de threads, utilisables avec ou sans OpenMP
+
+inline int numThreads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+inline int threadId() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+// Nombre de threads de l'équipe courante (1 hors région parallèle)
+inline int teamSize() {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+// n <= 0 : conserver la valeur par défaut (OMP_NUM_THREADS ou nombre de coeurs)
+inline void setNumThreads(int n) {
+#ifdef _OPENMP
+    if (n > 0) omp_set_num_threads(n);
+#else
+    (void)n;
+#endif
+}
+
+#endif
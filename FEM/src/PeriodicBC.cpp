@@ -0,0 +1,119 @@
+#include "PeriodicBC.h"
+#include <iostream>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Grille de hachage : cellules de côté h, un noeud maître est cherché dans les 3x3 cellules
+// autour du point visé (h >= tolérance)
+class SpatialHash {
+    private:
+        const Mesh& _mesh;
+        double _h;
+        unordered_map<long long, vector<int>> _cells;
+
+        long long key(long long i, long long j) const { return (i << 32) ^ (j & 0xffffffffLL); }
+        long long cell(double v) const { return (long long)floor(v / _h); }
+
+    public:
+        SpatialHash(const Mesh& mesh, double h) : _mesh(mesh), _h(h) {}
+
+        void insert(int slot) {
+            _cells[key(cell(_mesh.nodeX[slot]), cell(_mesh.nodeY[slot]))].push_back(slot);
+        }
+
+        // Slot le plus proche de (x, y) à moins de tol, -1 sinon
+        int find(double x, double y, double tol) const {
+            long long ci = cell(x), cj = cell(y);
+            int best = -1;
+            double bestDist = tol * tol;
+            for (long long i = ci - 1; i <= ci + 1; i++) {
+                for (long long j = cj - 1; j <= cj + 1; j++) {
+                    auto it = _cells.find(key(i, j));
+                    if (it == _cells.end()) continue;
+                    for (int slot : it->second) {
+                        double ddx = _mesh.nodeX[slot] - x, ddy = _mesh.nodeY[slot] - y;
+                        double d2 = ddx * ddx + ddy * ddy;
+                        if (d2 <= bestDist) {
+                            bestDist = d2;
+                            best = slot;
+                        }
+                    }
+                }
+            }
+            return best;
+        }
+};
+
+vector<char> sideMask(const Mesh& mesh, const vector<int>& tags) {
+    vector<char> mask(mesh.nbNodes(), 0);
+    for (int id : tags) mask[mesh.nodeSlot(id)] = 1;
+    return mask;
+}
+
+}
+
+PeriodicPairs findPeriodicPairs(const Mesh& mesh, double tol) {
+    PeriodicPairs pairs;
+    pairs.corner = -1;
+    pairs.unmatched = 0;
+
+    double W = mesh.width(), H = mesh.height();
+    double eps = tol * max(W, H);
+    vector<char> left = sideMask(mesh, mesh.leftNodes), right = sideMask(mesh, mesh.rightNodes);
+    vector<char> bottom = sideMask(mesh, mesh.bottomNodes), top = sideMask(mesh, mesh.topNodes);
+
+    // Coins : le coin bas-gauche est la référence, les trois autres lui sont liés
+    int corners[4] = {-1, -1, -1, -1};  // BG, BD, HD, HG
+    for (int i = 0; i < mesh.nbNodes(); i++) {
+        if (left[i] && bottom[i]) corners[0] = i;
+        if (right[i] && bottom[i]) corners[1] = i;
+        if (right[i] && top[i]) corners[2] = i;
+        if (left[i] && top[i]) corners[3] = i;
+    }
+    if (corners[0] < 0) {
+        cerr << "Erreur : coin (xMin, yMin) absent du maillage, périodicité impossible" << endl;
+        return pairs;
+    }
+    pairs.corner = mesh.slotToTag[corners[0]];
+    const double cornerOffset[4][2] = {{0, 0}, {W, 0}, {W, H}, {0, H}};
+    for (int c = 1; c < 4; c++) {
+        if (corners[c] < 0) {
+            pairs.unmatched++;
+            continue;
+        }
+        PeriodicLink link = {mesh.slotToTag[corners[c]], pairs.corner, cornerOffset[c][0], cornerOffset[c][1]};
+        pairs.links.push_back(link);
+    }
+
+    // Maîtres (bords gauche et bas hors coins) dans la table de hachage
+    SpatialHash hash(mesh, max(eps, 1e-300));
+    for (int i = 0; i < mesh.nbNodes(); i++) {
+        bool corner = (left[i] || right[i]) && (bottom[i] || top[i]);
+        if (!corner && (left[i] || bottom[i])) hash.insert(i);
+    }
+
+    // Esclaves : bord droit -> gauche (décalage W, 0), bord haut -> bas (0, H)
+    for (int i = 0; i < mesh.nbNodes(); i++) {
+        bool corner = (left[i] || right[i]) && (bottom[i] || top[i]);
+        if (corner || !(right[i] || top[i])) continue;
+        double dx = right[i] ? W : 0.0, dy = right[i] ? 0.0 : H;
+        int master = hash.find(mesh.nodeX[i] - dx, mesh.nodeY[i] - dy, eps);
+        if (master < 0) {
+            pairs.unmatched++;
+            continue;
+        }
+        PeriodicLink link = {mesh.slotToTag[i], mesh.slotToTag[master], dx, dy};
+        pairs.links.push_back(link);
+    }
+
+    if (pairs.unmatched > 0) {
+        cerr << "Attention : " << pairs.unmatched << " noeuds de bord sans vis-à-vis (maillage non périodique), "
+             << "laissés libres" << endl;
+    }
+    return pairs;
+}
@@ -0,0 +1,35 @@
+#ifndef PERIODIC_BC_H
+#define PERIODIC_BC_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "Mesh.h"
+
+// Conditions périodiques sur un VER rectangulaire : u(esclave) = u(maître) + E (x_esclave - x_maître),
+// E déformation macroscopique. Les noeuds du bord droit sont esclaves du bord gauche, ceux du
+// bord haut esclaves du bord bas ; les trois autres coins sont esclaves du coin (xMin, yMin),
+// qui sert de référence (mouvement de corps rigide bloqué). Les vis-à-vis sont trouvés par une
+// table de hachage spatiale sur les noeuds maîtres : le maillage doit être conforme périodique.
+
+struct PeriodicLink {
+    int slave, master;  // tags
+    double dx, dy;      // x_esclave - x_maître
+};
+
+struct PeriodicPairs {
+    int corner;                       // tag du coin de référence (-1 si absent)
+    std::vector<PeriodicLink> links;
+    int unmatched;                    // noeuds de bord sans vis-à-vis
+};
+
+// tol : distance maximale entre un noeud esclave translaté et son maître, relative à la
+// plus grande dimension du VER
+PeriodicPairs findPeriodicPairs(const Mesh& mesh, double tol = 1e-6);
+
+// Décalage de la composante d pour la déformation de Voigt (exx, eyy, gxy)
+inline double periodicOffset(const PeriodicLink& link, int d, const Eigen::Vector3d& E) {
+    return d == 0 ? E(0) * link.dx + 0.5 * E(2) * link.dy
+                  : 0.5 * E(2) * link.dx + E(1) * link.dy;
+}
+
+#endif
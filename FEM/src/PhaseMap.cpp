@@ -0,0 +1,151 @@
+#include "PhaseMap.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+double PhaseMap::fraction(int p) const {
+    if (phase.empty()) return 0.0;
+    return (double)count(phase.begin(), phase.end(), (uint8_t)p) / phase.size();
+}
+
+// Plus grand entier <= n sans facteur premier autre que 2, 3 et 5 : les FFT de kissfft
+// restent en O(n log n) (un grand facteur premier p coûte O(n p))
+static int fftSize(int n) {
+    for (int m = n; m > 1; m--) {
+        int r = m;
+        for (int f : {2, 3, 5}) {
+            while (r % f == 0) r /= f;
+        }
+        if (r == 1) return m;
+    }
+    return 1;
+}
+
+// Plus grand entier <= n de la forme c * 2^k avec c <= 32 : la grille se réduit de moitié
+// k fois, jusqu'à un niveau grossier d'au plus 32 pixels de côté (4095 -> 3968 = 31 * 128).
+// Une taille impaire quelconque laisserait toute la grille fine à la factorisation directe.
+static int multigridSize(int n) {
+    if (n <= 32) return max(n, 1);
+    int k = 0;
+    while ((n >> k) > 32) k++;
+    return (n >> k) << k;
+}
+
+static int pixelSize(int n, PixelSizing sizing) {
+    return sizing == PixelSizing::MULTIGRID ? multigridSize(n) : fftSize(n);
+}
+
+// Pixels sur chaque côté : resolution sur le plus grand, au moins 1 sur l'autre
+static void pixelCounts(double lx, double ly, int resolution, PixelSizing sizing, int& nx, int& ny) {
+    if (lx >= ly) {
+        nx = pixelSize(resolution, sizing);
+        ny = pixelSize(max(1, (int)lround(nx * ly / lx)), sizing);
+    } else {
+        ny = pixelSize(resolution, sizing);
+        nx = pixelSize(max(1, (int)lround(ny * lx / ly)), sizing);
+    }
+}
+
+PhaseMap rasterizeMesh(const Mesh& mesh, int resolution, PixelSizing sizing) {
+    PhaseMap map;
+    map.lx = mesh.xMax - mesh.xMin;
+    map.ly = mesh.yMax - mesh.yMin;
+    pixelCounts(map.lx, map.ly, resolution, sizing, map.width, map.height);
+    map.phase.assign((size_t)map.width * map.height, 0);
+    double hx = map.lx / map.width, hy = map.ly / map.height;
+
+    // Pixels dont le centre est dans la boîte englobante de chaque triangle, test par
+    // coordonnées barycentriques (tolérance relative : centres situés sur une arête)
+    for (int e = 0; e < mesh.nbElements(); e++) {
+        const int32_t* n = mesh.elementNodes(e);
+        double x1 = mesh.nodeX[n[0]], y1 = mesh.nodeY[n[0]];
+        double x2 = mesh.nodeX[n[1]], y2 = mesh.nodeY[n[1]];
+        double x3 = mesh.nodeX[n[2]], y3 = mesh.nodeY[n[2]];
+        double det = (x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1);
+        if (det == 0.0) continue;
+        int i0 = max(0, (int)ceil((min(x1, min(x2, x3)) - mesh.xMin) / hx - 0.5));
+        int i1 = min(map.width - 1, (int)floor((max(x1, max(x2, x3)) - mesh.xMin) / hx - 0.5));
+        int j0 = max(0, (int)ceil((min(y1, min(y2, y3)) - mesh.yMin) / hy - 0.5));
+        int j1 = min(map.height - 1, (int)floor((max(y1, max(y2, y3)) - mesh.yMin) / hy - 0.5));
+        uint8_t p = mesh.elementMaterial[e];
+        for (int j = j0; j <= j1; j++) {
+            double y = mesh.yMin + (j + 0.5) * hy;
+            for (int i = i0; i <= i1; i++) {
+                double x = mesh.xMin + (i + 0.5) * hx;
+                double l2 = ((x - x1) * (y3 - y1) - (x3 - x1) * (y - y1)) / det;
+                double l3 = ((x2 - x1) * (y - y1) - (x - x1) * (y2 - y1)) / det;
+                if (l2 >= -1e-12 && l3 >= -1e-12 && l2 + l3 <= 1.0 + 1e-12) map.phase[(size_t)j * map.width + i] = p;
+            }
+        }
+    }
+    return map;
+}
+
+PhaseMap rasterizeFibers(const vector<Fiber>& fibers, double xMin, double yMin, double xMax, double yMax,
+                         int resolution, PixelSizing sizing) {
+    PhaseMap map;
+    map.lx = xMax - xMin;
+    map.ly = yMax - yMin;
+    pixelCounts(map.lx, map.ly, resolution, sizing, map.width, map.height);
+    map.phase.assign((size_t)map.width * map.height, 0);
+    double hx = map.lx / map.width, hy = map.ly / map.height;
+
+    for (const Fiber& f : fibers) {
+        int i0 = max(0, (int)ceil((f.x - f.r - xMin) / hx - 0.5));
+        int i1 = min(map.width - 1, (int)floor((f.x + f.r - xMin) / hx - 0.5));
+        int j0 = max(0, (int)ceil((f.y - f.r - yMin) / hy - 0.5));
+        int j1 = min(map.height - 1, (int)floor((f.y + f.r - yMin) / hy - 0.5));
+        for (int j = j0; j <= j1; j++) {
+            double dy = yMin + (j + 0.5) * hy - f.y;
+            for (int i = i0; i <= i1; i++) {
+                double dx = xMin + (i + 0.5) * hx - f.x;
+                if (dx * dx + dy * dy <= f.r * f.r) map.phase[(size_t)j * map.width + i] = 1;
+            }
+        }
+    }
+    return map;
+}
+
+// Seuil d'Otsu : maximise la variance interclasses de l'histogramme
+static int otsuThreshold(const GrayImage& image) {
+    vector<double> hist(256, 0.0);
+    for (uint8_t g : image.pixels) hist[g] += 1.0;
+    double total = image.pixels.size(), sumAll = 0.0;
+    for (int g = 0; g < 256; g++) sumAll += g * hist[g];
+    double w0 = 0.0, sum0 = 0.0, best = -1.0;
+    int threshold = 128;
+    for (int g = 0; g < 255; g++) {
+        w0 += hist[g];
+        sum0 += g * hist[g];
+        double w1 = total - w0;
+        if (w0 == 0.0 || w1 == 0.0) continue;
+        double m0 = sum0 / w0, m1 = (sumAll - sum0) / w1;
+        double between = w0 * w1 * (m0 - m1) * (m0 - m1);
+        if (between > best) {
+            best = between;
+            threshold = g + 1;
+        }
+    }
+    return threshold;
+}
+
+PhaseMap thresholdImage(const GrayImage& image, int threshold, bool fiberDark, int* usedThreshold, PixelSizing sizing) {
+    if (threshold <= 0) threshold = otsuThreshold(image);
+    if (usedThreshold) *usedThreshold = threshold;
+    // Recadrage centré aux dimensions favorables au solveur
+    PhaseMap map;
+    map.width = pixelSize(image.width, sizing);
+    map.height = pixelSize(image.height, sizing);
+    map.lx = map.width;
+    map.ly = map.height;
+    map.phase.resize((size_t)map.width * map.height);
+    int x0 = (image.width - map.width) / 2, y0 = (image.height - map.height) / 2;
+    for (int j = 0; j < map.height; j++) {
+        for (int i = 0; i < map.width; i++) {
+            bool bright = image(x0 + i, y0 + map.height - 1 - j) >= threshold;
+            map.phase[(size_t)j * map.width + i] = bright != fiberDark ? 1 : 0;
+        }
+    }
+    return map;
+}
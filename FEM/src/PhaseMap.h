@@ -0,0 +1,45 @@
+#ifndef PHASE_MAP_H
+#define PHASE_MAP_H
+
+#include <vector>
+#include <cstdint>
+#include "Mesh.h"
+#include "FiberLayout.h"
+#include "ImageReader.h"
+
+// Images de phases pour les solveurs sur grille de pixels (FFTHomogenization,
+// PixelGridSolver) : pixellisation d'un maillage ou de cercles, seuillage d'une micrographie.
+
+// Image de phases : un indice de matériau par pixel
+struct PhaseMap {
+    int width, height;
+    double lx, ly;                 // dimensions du domaine (pixels rectangulaires si besoin)
+    std::vector<uint8_t> phase;    // ligne par ligne, y vers le haut
+
+    PhaseMap() : width(0), height(0), lx(0.0), ly(0.0) {}
+    // Fraction surfacique de la phase p
+    double fraction(int p) const;
+};
+
+// Dimensions en pixels : resolution et l'image seuillée sont ramenées à la plus grande taille
+// admise par le solveur
+enum class PixelSizing {
+    FFT,        // facteurs premiers 2, 3 et 5 seulement (FFT rapides)
+    MULTIGRID   // c * 2^k avec c <= 32 : k grilles deux fois plus grossières, la dernière factorisée
+};
+
+// Matériau de l'élément contenant le centre de chaque pixel (indice dans mesh.materials) ;
+// resolution pixels sur le plus grand côté du maillage
+PhaseMap rasterizeMesh(const Mesh& mesh, int resolution, PixelSizing sizing = PixelSizing::FFT);
+
+// Phase 1 (fibre) aux pixels dont le centre est dans un cercle, 0 (matrice) ailleurs
+PhaseMap rasterizeFibers(const std::vector<Fiber>& fibers, double xMin, double yMin, double xMax, double yMax,
+                         int resolution, PixelSizing sizing = PixelSizing::FFT);
+
+// Seuillage d'une micrographie : phase 1 au-dessus du seuil (en dessous si fiberDark),
+// threshold <= 0 : seuil d'Otsu, retourné dans usedThreshold. Un pixel de l'image par pixel
+// de phase (image recadrée au centre), axe y retourné (y vers le haut, comme les maillages).
+PhaseMap thresholdImage(const GrayImage& image, int threshold, bool fiberDark, int* usedThreshold = nullptr,
+                        PixelSizing sizing = PixelSizing::FFT);
+
+#endif
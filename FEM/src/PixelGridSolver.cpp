@@ -0,0 +1,490 @@
+#include "PixelGridSolver.h"
+#include "Krylov.h"
+#include <array>
+#include <map>
+#include <cmath>
+#include <chrono>
+#include <iomanip>
+
+using namespace std;
+using namespace Eigen;
+
+typedef Matrix<double, 8, 8> Matrix8d;
+typedef Matrix<double, 3, 8> MatrixB;
+
+// Noeuds locaux d'un pixel : (0,0), (1,0), (1,1), (0,1) en unités de pixel
+static const int cornerX[4] = {0, 1, 1, 0};
+static const int cornerY[4] = {0, 0, 1, 1};
+
+// Matrice B du Q4 de côtés hx x hy au point (xi, eta) de l'élément de référence [-1, 1]^2
+static MatrixB shapeB(double xi, double eta, double hx, double hy) {
+    MatrixB B = MatrixB::Zero();
+    for (int k = 0; k < 4; k++) {
+        double sx = 2 * cornerX[k] - 1, sy = 2 * cornerY[k] - 1;
+        double dx = 0.5 * sx * (1.0 + sy * eta) / hx;
+        double dy = 0.5 * sy * (1.0 + sx * xi) / hy;
+        B(0, 2*k) = dx;
+        B(1, 2*k+1) = dy;
+        B(2, 2*k) = dy;
+        B(2, 2*k+1) = dx;
+    }
+    return B;
+}
+
+// Prolongement bilinéaire d'un élément grossier vers son enfant (a, b) : DDL des 4 noeuds
+// grossiers -> DDL des 4 noeuds de l'enfant
+static Matrix8d childProlongation(int a, int b) {
+    Matrix8d P = Matrix8d::Zero();
+    for (int m = 0; m < 4; m++) {
+        double s = 0.5 * (a + cornerX[m]), t = 0.5 * (b + cornerY[m]);
+        double N[4] = {(1 - s) * (1 - t), s * (1 - t), s * t, (1 - s) * t};
+        for (int k = 0; k < 4; k++) {
+            P(2*m, 2*k) = N[k];
+            P(2*m+1, 2*k+1) = N[k];
+        }
+    }
+    return P;
+}
+
+// Lignes 2 L et 2 L + 1 de Ke (noeud local L) appliquées aux DDL des noeuds n0..n3
+static inline void addRows(const double* K, int L, int n0, int n1, int n2, int n3, const double* x,
+                           double& sx, double& sy) {
+    double xe[8] = {x[2*n0], x[2*n0+1], x[2*n1], x[2*n1+1], x[2*n2], x[2*n2+1], x[2*n3], x[2*n3+1]};
+    const double* rx = K + 16 * L;
+    const double* ry = rx + 8;
+    for (int k = 0; k < 8; k++) {
+        sx += rx[k] * xe[k];
+        sy += ry[k] * xe[k];
+    }
+}
+
+const int PixelGridSolver::maxCoarseNodes;
+
+PixelGridSolver::PixelGridSolver(const PhaseMap& phases, const vector<Matrix3d>& stiffness)
+    : _phases(phases), _C(stiffness), _tolerance(1e-6), _maxIterations(1000), _log(nullptr),
+      _lastIterations(0), _totalIterations(0), _valid(true) {
+    _hx = phases.lx / phases.width;
+    _hy = phases.ly / phases.height;
+
+    // Matrice de référence de chaque phase (Gauss 2 x 2) et C * intégrale de B
+    Level L0;
+    L0.nx = phases.width;
+    L0.ny = phases.height;
+    L0.Ke.resize(64 * stiffness.size());
+    _CB.resize(24 * stiffness.size());
+    double g = 1.0 / sqrt(3.0), w = 0.25 * _hx * _hy;
+    for (size_t p = 0; p < stiffness.size(); p++) {
+        Matrix8d Ke = Matrix8d::Zero();
+        MatrixB intB = MatrixB::Zero();
+        for (double xi : {-g, g}) {
+            for (double eta : {-g, g}) {
+                MatrixB B = shapeB(xi, eta, _hx, _hy);
+                Ke += w * B.transpose() * stiffness[p] * B;
+                intB += w * B;
+            }
+        }
+        Map<Matrix<double, 8, 8, RowMajor>> K(&L0.Ke[64 * p]);
+        Map<Matrix<double, 3, 8, RowMajor>> CB(&_CB[24 * p]);
+        K = Ke;
+        CB = stiffness[p] * intB;
+    }
+    _levels.push_back(L0);
+    buildHierarchy();
+}
+
+template <typename T>
+void PixelGridSolver::applyStencil(const Level& L, const T* type, const VectorXd& xv, VectorXd& yv) const {
+    int nx = L.nx, ny = L.ny;
+    const double* x = xv.data();
+    double* y = yv.data();
+    const double* K = L.Ke.data();
+
+    // Noeud (i, j) : coin commun des éléments (i-1, j-1), (i, j-1), (i-1, j) et (i, j), dont
+    // il est respectivement le noeud local 2, 3, 1 et 0 (l'élément (i, j) a pour noeud 0 le
+    // noeud (i, j), indices périodiques)
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < ny; j++) {
+        int jm = j == 0 ? ny - 1 : j - 1;
+        int jp = j + 1 == ny ? 0 : j + 1;
+        for (int i = 0; i < nx; i++) {
+            int im = i == 0 ? nx - 1 : i - 1;
+            int ip = i + 1 == nx ? 0 : i + 1;
+            int n00 = jm * nx + im, n10 = jm * nx + i, n20 = jm * nx + ip;
+            int n01 = j * nx + im, n11 = j * nx + i, n21 = j * nx + ip;
+            int n02 = jp * nx + im, n12 = jp * nx + i, n22 = jp * nx + ip;
+            double sx = 0.0, sy = 0.0;
+            addRows(K + 64 * type[n00], 2, n00, n10, n11, n01, x, sx, sy);
+            addRows(K + 64 * type[n10], 3, n10, n20, n21, n11, x, sx, sy);
+            addRows(K + 64 * type[n01], 1, n01, n11, n12, n02, x, sx, sy);
+            addRows(K + 64 * type[n11], 0, n11, n21, n22, n12, x, sx, sy);
+            y[2*n11] = sx;
+            y[2*n11+1] = sy;
+        }
+    }
+}
+
+void PixelGridSolver::applyLevel(int l, const VectorXd& x, VectorXd& y) const {
+    const Level& L = _levels[l];
+    y.resize(x.size());
+    if (l == 0) applyStencil(L, _phases.phase.data(), x, y);
+    else applyStencil(L, L.type.data(), x, y);
+}
+
+template <typename T>
+void PixelGridSolver::diagonal(const Level& L, const T* type, VectorXd& diag) const {
+    int nx = L.nx, ny = L.ny;
+    diag.resize(2 * nx * ny);
+    const double* K = L.Ke.data();
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < ny; j++) {
+        int jm = j == 0 ? ny - 1 : j - 1;
+        for (int i = 0; i < nx; i++) {
+            int im = i == 0 ? nx - 1 : i - 1;
+            int elements[4] = {jm * nx + im, jm * nx + i, j * nx + im, j * nx + i};
+            int local[4] = {2, 3, 1, 0};
+            double dx = 0.0, dy = 0.0;
+            for (int k = 0; k < 4; k++) {
+                const double* Ke = K + 64 * type[elements[k]];
+                dx += Ke[18 * local[k]];
+                dy += Ke[18 * local[k] + 9];
+            }
+            diag(2 * (j * nx + i)) = dx;
+            diag(2 * (j * nx + i) + 1) = dy;
+        }
+    }
+}
+
+template <typename T>
+void PixelGridSolver::coarsen(const Level& fine, const T* fineType, Level& coarse) const {
+    static const Matrix8d P[4] = {childProlongation(0, 0), childProlongation(1, 0),
+                                  childProlongation(0, 1), childProlongation(1, 1)};
+    coarse.nx = fine.nx / 2;
+    coarse.ny = fine.ny / 2;
+    coarse.type.resize((size_t)coarse.nx * coarse.ny);
+
+    // Un type par composition (types des enfants (0,0), (1,0), (0,1), (1,1)) : K = somme des P^T Ke P
+    map<array<uint32_t, 4>, uint32_t> types;
+    for (int J = 0; J < coarse.ny; J++) {
+        for (int I = 0; I < coarse.nx; I++) {
+            array<uint32_t, 4> children;
+            for (int c = 0; c < 4; c++) {
+                children[c] = fineType[(2 * J + c / 2) * fine.nx + 2 * I + c % 2];
+            }
+            auto found = types.find(children);
+            if (found == types.end()) {
+                Matrix8d Kc = Matrix8d::Zero();
+                for (int c = 0; c < 4; c++) {
+                    Map<const Matrix<double, 8, 8, RowMajor>> Kf(&fine.Ke[64 * (size_t)children[c]]);
+                    Kc += P[c].transpose() * Kf * P[c];
+                }
+                size_t id = coarse.Ke.size() / 64;
+                coarse.Ke.resize(coarse.Ke.size() + 64);
+                Map<Matrix<double, 8, 8, RowMajor>> K(&coarse.Ke[64 * id]);
+                K = Kc;
+                found = types.insert(make_pair(children, (uint32_t)id)).first;
+            }
+            coarse.type[J * coarse.nx + I] = found->second;
+        }
+    }
+}
+
+double PixelGridSolver::estimateLambdaMax(int l) const {
+    // Méthode de la puissance sur D^-1 A, comme MultigridPreconditioner mais avec plus
+    // d'itérations : sur les grandes grilles, une valeur sous-estimée fait diverger Chebyshev
+    const Level& L = _levels[l];
+    int n = L.invDiag.size();
+    VectorXd v(n), w(n);
+    for (int i = 0; i < n; i++) v(i) = 1.0 + 0.1 * ((i * 7919) % 13);
+    v.normalize();
+
+    double lambda = 1.0;
+    for (int it = 0; it < 60; it++) {
+        applyLevel(l, v, w);
+        w = L.invDiag.cwiseProduct(w);
+        lambda = w.norm();
+        if (lambda == 0.0) return 1.0;
+        v = w / lambda;
+    }
+    return lambda;
+}
+
+void PixelGridSolver::setupLevel(int l) {
+    Level& L = _levels[l];
+    VectorXd diag;
+    if (l == 0) diagonal(L, _phases.phase.data(), diag);
+    else diagonal(L, L.type.data(), diag);
+    L.invDiag = diag.unaryExpr([](double d) { return abs(d) > 0.0 ? 1.0 / d : 1.0; });
+    L.lambdaMax = estimateLambdaMax(l);
+    int n = 2 * L.nx * L.ny;
+    L.r.resize(n);
+    L.d.resize(n);
+    L.q.resize(n);
+    if (l > 0) {
+        L.b.resize(n);
+        L.x.resize(n);
+    }
+}
+
+void PixelGridSolver::buildHierarchy() {
+    // Grilles grossières tant que les dimensions sont paires et la grille assez grande pour
+    // qu'une factorisation directe soit coûteuse
+    while (true) {
+        const Level& L = _levels.back();
+        if (L.nx % 2 != 0 || L.ny % 2 != 0 || L.nx < 8 || L.ny < 8 || L.nx * L.ny <= 1024) break;
+        Level coarse;
+        if (_levels.size() == 1) coarsen(L, _phases.phase.data(), coarse);
+        else coarsen(L, L.type.data(), coarse);
+        _levels.push_back(coarse);
+    }
+    Level& last = _levels.back();
+    if (last.nx * last.ny > maxCoarseNodes) {
+        cerr << "Erreur : grille de pixels " << _levels[0].nx << " x " << _levels[0].ny << " réduite seulement à "
+             << last.nx << " x " << last.ny << " (dimension impaire), trop grande pour une factorisation directe ("
+             << maxCoarseNodes << " noeuds au plus) : choisir des dimensions de la forme c * 2^k, c <= 32" << endl;
+        _valid = false;
+        return;
+    }
+    for (size_t l = 0; l + 1 < _levels.size(); l++) setupLevel(l);
+    last.b.resize(2 * last.nx * last.ny);
+    last.x.resize(2 * last.nx * last.ny);
+    factorCoarsest();
+}
+
+void PixelGridSolver::factorCoarsest() {
+    // Assemblage du niveau le plus grossier ; le noeud 0 est bloqué (translations)
+    const Level& L = _levels.back();
+    int nx = L.nx, ny = L.ny, n = 2 * nx * ny;
+    vector<Triplet<double>> triplets;
+    triplets.reserve((size_t)64 * nx * ny + 2);
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            int e = j * nx + i;
+            const double* Ke = _levels.size() == 1 ? &L.Ke[64 * _phases.phase[e]] : &L.Ke[64 * (size_t)L.type[e]];
+            int nodes[4];
+            for (int m = 0; m < 4; m++) nodes[m] = ((j + cornerY[m]) % ny) * nx + (i + cornerX[m]) % nx;
+            for (int a = 0; a < 8; a++) {
+                int row = 2 * nodes[a / 2] + a % 2;
+                if (row < 2) continue;
+                for (int b = 0; b < 8; b++) {
+                    int col = 2 * nodes[b / 2] + b % 2;
+                    if (col >= 2) triplets.push_back(Triplet<double>(row, col, Ke[8 * a + b]));
+                }
+            }
+        }
+    }
+    triplets.push_back(Triplet<double>(0, 0, 1.0));
+    triplets.push_back(Triplet<double>(1, 1, 1.0));
+    SparseMatrix<double> A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    _coarseSolver.compute(A);
+    if (_coarseSolver.info() != Success) {
+        cerr << "Erreur : factorisation du niveau grossier de la grille de pixels impossible" << endl;
+    }
+}
+
+void PixelGridSolver::restrictResidual(int l, const VectorXd& r, VectorXd& rc) const {
+    // Transposée du prolongement bilinéaire : poids 1, 1/2 et 1/4 autour du noeud (2I, 2J)
+    const Level& F = _levels[l];
+    const Level& C = _levels[l + 1];
+    #pragma omp parallel for schedule(static)
+    for (int J = 0; J < C.ny; J++) {
+        for (int I = 0; I < C.nx; I++) {
+            double sx = 0.0, sy = 0.0;
+            for (int dj = -1; dj <= 1; dj++) {
+                int j = (2 * J + dj + F.ny) % F.ny;
+                double wj = dj == 0 ? 1.0 : 0.5;
+                for (int di = -1; di <= 1; di++) {
+                    int i = (2 * I + di + F.nx) % F.nx;
+                    double w = wj * (di == 0 ? 1.0 : 0.5);
+                    sx += w * r(2 * (j * F.nx + i));
+                    sy += w * r(2 * (j * F.nx + i) + 1);
+                }
+            }
+            rc(2 * (J * C.nx + I)) = sx;
+            rc(2 * (J * C.nx + I) + 1) = sy;
+        }
+    }
+}
+
+void PixelGridSolver::prolongAdd(int l, const VectorXd& xc, VectorXd& x) const {
+    const Level& F = _levels[l];
+    const Level& C = _levels[l + 1];
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < F.ny; j++) {
+        int J = j / 2, Jp = (J + 1) % C.ny;
+        double t = 0.5 * (j % 2);
+        for (int i = 0; i < F.nx; i++) {
+            int I = i / 2, Ip = (I + 1) % C.nx;
+            double s = 0.5 * (i % 2);
+            int c00 = J * C.nx + I, c10 = J * C.nx + Ip, c01 = Jp * C.nx + I, c11 = Jp * C.nx + Ip;
+            double w00 = (1 - s) * (1 - t), w10 = s * (1 - t), w01 = (1 - s) * t, w11 = s * t;
+            for (int d = 0; d < 2; d++) {
+                x(2 * (j * F.nx + i) + d) += w00 * xc(2 * c00 + d) + w10 * xc(2 * c10 + d)
+                                            + w01 * xc(2 * c01 + d) + w11 * xc(2 * c11 + d);
+            }
+        }
+    }
+}
+
+void PixelGridSolver::smooth(int l, const VectorXd& b, VectorXd& x, bool zeroGuess) const {
+    // Chebyshev de degré 3 sur [lambdaMax/30, 1.1 lambdaMax] pour D^-1 A
+    const Level& L = _levels[l];
+    double upper = 1.1 * L.lambdaMax;
+    double lower = upper / 30.0;
+    double theta = 0.5 * (upper + lower);
+    double delta = 0.5 * (upper - lower);
+    double sigma = theta / delta;
+    double rho = 1.0 / sigma;
+
+    if (zeroGuess) {
+        L.r = b;
+    } else {
+        applyLevel(l, x, L.q);
+        L.r = b - L.q;
+    }
+    L.d = L.invDiag.cwiseProduct(L.r) / theta;
+    x += L.d;
+    for (int k = 1; k < 3; k++) {
+        applyLevel(l, L.d, L.q);
+        L.r -= L.q;
+        double rhoNew = 1.0 / (2.0 * sigma - rho);
+        L.d = (rhoNew * rho) * L.d + (2.0 * rhoNew / delta) * L.invDiag.cwiseProduct(L.r);
+        x += L.d;
+        rho = rhoNew;
+    }
+}
+
+void PixelGridSolver::vcycle(int l, const VectorXd& b, VectorXd& x) const {
+    if (l == (int)_levels.size() - 1) {
+        VectorXd bc = b;
+        bc(0) = bc(1) = 0.0;
+        x = _coarseSolver.solve(bc);
+        return;
+    }
+    const Level& L = _levels[l];
+    const Level& C = _levels[l + 1];
+
+    x.setZero(b.size());
+    smooth(l, b, x, true);
+
+    applyLevel(l, x, L.q);
+    L.r = b - L.q;
+    restrictResidual(l, L.r, C.b);
+    vcycle(l + 1, C.b, C.x);
+    prolongAdd(l, C.x, x);
+
+    smooth(l, b, x, false);
+}
+
+void PixelGridSolver::Preconditioner::apply(const VectorXd& r, VectorXd& z) const {
+    solver.vcycle(0, r, z);
+    // Translations retirées : les itérés restent orthogonaux au noyau de K périodique
+    int n = z.size() / 2;
+    Map<VectorXd, 0, InnerStride<2>> zx(z.data(), n), zy(z.data() + 1, n);
+    zx.array() -= zx.mean();
+    zy.array() -= zy.mean();
+}
+
+Vector3d PixelGridSolver::solve(const Vector3d& E) {
+    if (!_valid) return Vector3d::Zero();
+    auto t0 = chrono::high_resolution_clock::now();
+    const Level& L = _levels[0];
+    int nx = L.nx, ny = L.ny, phases = L.Ke.size() / 64;
+    const uint8_t* phase = _phases.phase.data();
+
+    // Efforts nodaux de la déformation moyenne : -Ke u_E par élément (u_E = E x, mêmes
+    // valeurs pour tous les pixels d'une phase)
+    vector<double> g(8 * phases);
+    for (int p = 0; p < phases; p++) {
+        Matrix<double, 8, 1> uE;
+        for (int m = 0; m < 4; m++) {
+            double x = cornerX[m] * _hx, y = cornerY[m] * _hy;
+            uE(2*m) = E(0) * x + 0.5 * E(2) * y;
+            uE(2*m+1) = 0.5 * E(2) * x + E(1) * y;
+        }
+        Map<const Matrix<double, 8, 8, RowMajor>> Ke(&L.Ke[64 * p]);
+        Map<Matrix<double, 8, 1>> gp(&g[8 * p]);
+        gp = Ke * uE;
+    }
+    VectorXd b(nbDofs());
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < ny; j++) {
+        int jm = j == 0 ? ny - 1 : j - 1;
+        for (int i = 0; i < nx; i++) {
+            int im = i == 0 ? nx - 1 : i - 1;
+            int elements[4] = {jm * nx + im, jm * nx + i, j * nx + im, j * nx + i};
+            int local[4] = {2, 3, 1, 0};
+            double fx = 0.0, fy = 0.0;
+            for (int k = 0; k < 4; k++) {
+                fx -= g[8 * phase[elements[k]] + 2 * local[k]];
+                fy -= g[8 * phase[elements[k]] + 2 * local[k] + 1];
+            }
+            b(2 * (j * nx + i)) = fx;
+            b(2 * (j * nx + i) + 1) = fy;
+        }
+    }
+
+    VectorXd u = VectorXd::Zero(nbDofs());
+    double error;
+    Preconditioner M = {*this};
+    _lastIterations = conjugateGradient(*this, M, b, u, _tolerance, _maxIterations, error);
+    _totalIterations += _lastIterations;
+    if (error > _tolerance) {
+        cerr << "Attention : grille de pixels non convergée en " << _lastIterations << " itérations (erreur "
+             << error << ")" << endl;
+    }
+
+    // Contrainte moyenne : C E + (C intégrale de B) u_e / aire, sur tous les pixels
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+    #pragma omp parallel for reduction(+:s0,s1,s2) schedule(static)
+    for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+            int e = j * nx + i;
+            const double* CB = &_CB[24 * phase[e]];
+            Vector3d sigma = _C[phase[e]] * E * (_hx * _hy);
+            for (int m = 0; m < 4; m++) {
+                int node = ((j + cornerY[m]) % ny) * nx + (i + cornerX[m]) % nx;
+                for (int d = 0; d < 2; d++) {
+                    double ue = u(2 * node + d);
+                    for (int c = 0; c < 3; c++) sigma(c) += CB[8 * c + 2 * m + d] * ue;
+                }
+            }
+            s0 += sigma(0);
+            s1 += sigma(1);
+            s2 += sigma(2);
+        }
+    }
+    double area = (double)nx * ny * _hx * _hy;
+
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    log() << "Gradient conjugué (multigrille sur pixels): itérations = " << _lastIterations << ", erreur = " << error
+          << ", temps = " << elapsed.count() << " s" << endl;
+    return Vector3d(s0, s1, s2) / area;
+}
+
+Matrix3d PixelGridSolver::effectiveStiffness() {
+    Matrix3d C;
+    for (int k = 0; k < 3; k++) C.col(k) = solve(Vector3d::Unit(k));
+    return C;
+}
+
+size_t PixelGridSolver::operatorMemory() const {
+    size_t bytes = _phases.phase.size();
+    for (const Level& L : _levels) bytes += L.type.size() * sizeof(uint32_t) + L.Ke.size() * sizeof(double);
+    return bytes;
+}
+
+size_t PixelGridSolver::workMemory() const {
+    size_t doubles = 0;
+    for (const Level& L : _levels) doubles += L.invDiag.size() + L.r.size() + L.d.size() + L.q.size() + L.b.size() + L.x.size();
+    return doubles * sizeof(double);
+}
+
+void PixelGridSolver::printHierarchy(ostream& out) const {
+    out << "Multigrille sur pixels : " << _levels.size() << " niveaux" << endl;
+    for (size_t l = 0; l < _levels.size(); l++) {
+        const Level& L = _levels[l];
+        out << "  Niveau " << l << " : " << L.nx << " x " << L.ny << " éléments, " << L.Ke.size() / 64
+            << " matrices Ke" << (l + 1 == _levels.size() ? " (factorisé)" : "") << endl;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef PIXEL_GRID_SOLVER_H
+#define PIXEL_GRID_SOLVER_H
+
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include "PhaseMap.h"
+
+class PixelGridSolver {
+    // Éléments finis sur la grille de pixels d'une image de phases : un quadrangle bilinéaire
+    // (Q4) par pixel, conditions périodiques, homogénéisation par trois déformations moyennes.
+    // Aucune matrice par élément n'est stockée : une matrice Ke de référence par matériau et
+    // l'octet de phase de chaque pixel suffisent, K x est un produit par stencil 3 x 3 calculé
+    // noeud par noeud (sans conflit d'écriture entre threads).
+    // Préconditionneur multigrille géométrique : grilles deux fois plus grossières tant que les
+    // dimensions sont paires, opérateurs de Galerkin exacts (le prolongement bilinéaire d'un Q4
+    // grossier est représenté exactement par ses 2 x 2 Q4 fins), donc encore élément par
+    // élément. Un élément grossier est repéré par les types de ses quatre enfants : les
+    // matrices sont partagées entre éléments de même composition (une seule par niveau pour
+    // une zone homogène), le niveau ne stocke qu'un indice de type par élément.
+    // Lisseur de Chebyshev de degré 3 comme MultigridPreconditioner, niveau le plus grossier
+    // factorisé (LDLt creux, un noeud bloqué pour les translations) s'il a au plus
+    // maxCoarseNodes noeuds : une dimension impaire arrête la réduction.
+
+    static const int maxCoarseNodes = 16384;
+
+    public:
+        // stiffness[p] : matrice C de la phase p (Material::getC)
+        PixelGridSolver(const PhaseMap& phases, const std::vector<Eigen::Matrix3d>& stiffness);
+
+        void setTolerance(double tol) { _tolerance = tol; }
+        void setMaxIterations(int n) { _maxIterations = n; }
+        void setLog(std::ostream* log) { _log = log; }
+
+        // Contrainte moyenne (Voigt) pour la déformation moyenne E (Voigt, γxy)
+        Eigen::Vector3d solve(const Eigen::Vector3d& E);
+        // Tenseur de rigidité effectif : trois déformations moyennes unitaires
+        Eigen::Matrix3d effectiveStiffness();
+
+        // false si le niveau le plus grossier reste trop grand pour une factorisation directe
+        // (dimensions sans grand facteur 2, voir PixelSizing::MULTIGRID ; message sur cerr)
+        bool isValid() const { return _valid; }
+        int lastIterations() const { return _lastIterations; }
+        int totalIterations() const { return _totalIterations; }
+        int nbDofs() const { return 2 * _levels[0].nx * _levels[0].ny; }
+
+        // y = K x sur la grille fine (fluctuations périodiques)
+        void apply(const Eigen::VectorXd& x, Eigen::VectorXd& y) const { applyLevel(0, x, y); }
+
+        // Octets de l'opérateur (phases, types et matrices de tous les niveaux) et des
+        // vecteurs de travail du multigrille
+        size_t operatorMemory() const;
+        size_t workMemory() const;
+        void printHierarchy(std::ostream& out) const;
+
+    private:
+        struct Level {
+            int nx, ny;                    // noeuds = éléments par direction (périodique)
+            std::vector<uint32_t> type;    // type de chaque élément (vide au niveau 0 : phases)
+            std::vector<double> Ke;        // 64 coefficients par type
+            Eigen::VectorXd invDiag;
+            double lambdaMax;              // rayon spectral estimé de D^-1 A
+            mutable Eigen::VectorXd r, d, q, b, x;   // vecteurs de travail (b, x : niveaux grossiers)
+        };
+
+        const PhaseMap& _phases;
+        std::vector<Level> _levels;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> _coarseSolver;
+        std::vector<Eigen::Matrix3d> _C;   // Voigt, par phase
+        std::vector<double> _CB;           // C * intégrale de B sur un pixel (3 x 8), par phase
+        double _hx, _hy;
+        double _tolerance;
+        int _maxIterations;
+        std::ostream* _log;
+        int _lastIterations, _totalIterations;
+        bool _valid;
+
+        // Préconditionneur pour conjugateGradient : un cycle en V, moyenne (translations) retirée
+        struct Preconditioner {
+            const PixelGridSolver& solver;
+            void apply(const Eigen::VectorXd& r, Eigen::VectorXd& z) const;
+        };
+
+        std::ostream& log() const { return _log ? *_log : std::cout; }
+
+        void buildHierarchy();
+        template <typename T>
+        void coarsen(const Level& fine, const T* fineType, Level& coarse) const;
+        void setupLevel(int l);
+        void factorCoarsest();
+
+        template <typename T>
+        void applyStencil(const Level& L, const T* type, const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+        void applyLevel(int l, const Eigen::VectorXd& x, Eigen::VectorXd& y) const;
+        template <typename T>
+        void diagonal(const Level& L, const T* type, Eigen::VectorXd& diag) const;
+        void restrictResidual(int l, const Eigen::VectorXd& r, Eigen::VectorXd& rc) const;
+        void prolongAdd(int l, const Eigen::VectorXd& xc, Eigen::VectorXd& x) const;
+        void smooth(int l, const Eigen::VectorXd& b, Eigen::VectorXd& x, bool zeroGuess) const;
+        void vcycle(int l, const Eigen::VectorXd& b, Eigen::VectorXd& x) const;
+        double estimateLambdaMax(int l) const;
+};
+
+#endif
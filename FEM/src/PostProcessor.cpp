@@ -0,0 +1,172 @@
+#include "PostProcessor.h"
+#include "Material.h"
+#include <cmath>
+
+using namespace std;
+using namespace Eigen;
+
+PostProcessor::PostProcessor(const Mesh& mesh) : _mesh(mesh) {
+    int ne = mesh.nbElements();
+    for (int a = 0; a < 3; a++) {
+        _dNdx[a].assign(ne, 0.0);
+        _dNdy[a].assign(ne, 0.0);
+    }
+    _c11.assign(ne, 0.0);
+    _c12.assign(ne, 0.0);
+    _c33.assign(ne, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (int e = 0; e < ne; e++) {
+        const Material* mat = mesh.material(e);
+        if (mesh.elementArea[e] < 1e-12 || mat == nullptr) continue;  // élément ignoré : champs nuls
+
+        // Mêmes coefficients que Mesh::elementB
+        const int32_t* n = mesh.elementNodes(e);
+        double x1 = mesh.nodeX[n[0]], x2 = mesh.nodeX[n[1]], x3 = mesh.nodeX[n[2]];
+        double y1 = mesh.nodeY[n[0]], y2 = mesh.nodeY[n[1]], y3 = mesh.nodeY[n[2]];
+        double inv = 1.0 / (2.0 * mesh.elementArea[e]);
+        _dNdx[0][e] = (y2 - y3) * inv;
+        _dNdx[1][e] = (y3 - y1) * inv;
+        _dNdx[2][e] = (y1 - y2) * inv;
+        _dNdy[0][e] = (x3 - x2) * inv;
+        _dNdy[1][e] = (x1 - x3) * inv;
+        _dNdy[2][e] = (x2 - x1) * inv;
+
+        Matrix3d C = mat->getC();
+        _c11[e] = C(0, 0);
+        _c12[e] = C(0, 1);
+        _c33[e] = C(2, 2);
+    }
+}
+
+void PostProcessor::compute(const VectorXd& U) {
+    int ne = _mesh.nbElements();
+    strainXX.resize(ne);
+    strainYY.resize(ne);
+    strainXY.resize(ne);
+    stressXX.resize(ne);
+    stressYY.resize(ne);
+    stressXY.resize(ne);
+    vonMises.resize(ne);
+
+    const double* u = U.data();
+    const int32_t* conn = _mesh.connectivity.data();
+    const double *bx0 = _dNdx[0].data(), *bx1 = _dNdx[1].data(), *bx2 = _dNdx[2].data();
+    const double *by0 = _dNdy[0].data(), *by1 = _dNdy[1].data(), *by2 = _dNdy[2].data();
+
+    // Par paquets : les déplacements des noeuds sont d'abord rassemblés dans des tableaux
+    // contigus, puis tous les calculs se font sur des tableaux alignés, sans indirection
+    const int batch = 256;
+    int nbBatches = (ne + batch - 1) / batch;
+
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < nbBatches; k++) {
+        double ux[3][batch], uy[3][batch];
+        int first = k * batch;
+        int count = min(batch, ne - first);
+
+        for (int j = 0; j < count; j++) {
+            const int32_t* n = conn + 3 * (size_t)(first + j);
+            for (int a = 0; a < 3; a++) {
+                ux[a][j] = u[2 * n[a]];
+                uy[a][j] = u[2 * n[a] + 1];
+            }
+        }
+
+        for (int j = 0; j < count; j++) {
+            int e = first + j;
+            double exx = bx0[e] * ux[0][j] + bx1[e] * ux[1][j] + bx2[e] * ux[2][j];
+            double eyy = by0[e] * uy[0][j] + by1[e] * uy[1][j] + by2[e] * uy[2][j];
+            double gxy = by0[e] * ux[0][j] + by1[e] * ux[1][j] + by2[e] * ux[2][j]
+                       + bx0[e] * uy[0][j] + bx1[e] * uy[1][j] + bx2[e] * uy[2][j];
+            double sxx = _c11[e] * exx + _c12[e] * eyy;
+            double syy = _c12[e] * exx + _c11[e] * eyy;
+            double sxy = _c33[e] * gxy;
+
+            strainXX[e] = exx;
+            strainYY[e] = eyy;
+            strainXY[e] = gxy;
+            stressXX[e] = sxx;
+            stressYY[e] = syy;
+            stressXY[e] = sxy;
+            vonMises[e] = sqrt(sxx * sxx - sxx * syy + syy * syy + 3.0 * sxy * sxy);
+        }
+    }
+}
+
+void PostProcessor::recoverNodalFields() {
+    int nn = _mesh.nbNodes();
+    nodalStressXX.assign(nn, 0.0);
+    nodalStressYY.assign(nn, 0.0);
+    nodalStressXY.assign(nn, 0.0);
+    nodalVonMises.assign(nn, 0.0);
+    const vector<double>& area = _mesh.elementArea;
+
+    if ((int)_mesh.nodeElementStart.size() == nn + 1) {
+        // Rassemblement par noeud (éléments voisins en CSR) : pas de conflit d'écriture
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < nn; i++) {
+            double w = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0, vm = 0.0;
+            for (int k = _mesh.nodeElementStart[i]; k < _mesh.nodeElementStart[i + 1]; k++) {
+                int e = _mesh.nodeElements[k];
+                w += area[e];
+                sxx += area[e] * stressXX[e];
+                syy += area[e] * stressYY[e];
+                sxy += area[e] * stressXY[e];
+                vm += area[e] * vonMises[e];
+            }
+            if (w > 0.0) {
+                nodalStressXX[i] = sxx / w;
+                nodalStressYY[i] = syy / w;
+                nodalStressXY[i] = sxy / w;
+                nodalVonMises[i] = vm / w;
+            }
+        }
+        return;
+    }
+
+    // Index noeud -> éléments absent : accumulation séquentielle élément par élément
+    vector<double> weight(nn, 0.0);
+    for (int e = 0; e < _mesh.nbElements(); e++) {
+        const int32_t* n = _mesh.elementNodes(e);
+        for (int a = 0; a < 3; a++) {
+            weight[n[a]] += area[e];
+            nodalStressXX[n[a]] += area[e] * stressXX[e];
+            nodalStressYY[n[a]] += area[e] * stressYY[e];
+            nodalStressXY[n[a]] += area[e] * stressXY[e];
+            nodalVonMises[n[a]] += area[e] * vonMises[e];
+        }
+    }
+    for (int i = 0; i < nn; i++) {
+        if (weight[i] > 0.0) {
+            nodalStressXX[i] /= weight[i];
+            nodalStressYY[i] /= weight[i];
+            nodalStressXY[i] /= weight[i];
+            nodalVonMises[i] /= weight[i];
+        }
+    }
+}
+
+double PostProcessor::maxVonMises(int tag, int* element) const {
+    double vmMax = 0.0;
+    int eMax = -1;
+    for (int e = 0; e < (int)vonMises.size(); e++) {
+        if (tag >= 0 && _mesh.elementTag(e) != tag) continue;
+        if (vonMises[e] > vmMax) {
+            vmMax = vonMises[e];
+            eMax = e;
+        }
+    }
+    if (element) *element = eMax;
+    return vmMax;
+}
+
+double PostProcessor::average(const vector<double>& field, int tag) const {
+    double sum = 0.0, total = 0.0;
+    for (int e = 0; e < (int)field.size(); e++) {
+        if (tag >= 0 && _mesh.elementTag(e) != tag) continue;
+        sum += _mesh.elementArea[e] * field[e];
+        total += _mesh.elementArea[e];
+    }
+    return total > 0.0 ? sum / total : 0.0;
+}
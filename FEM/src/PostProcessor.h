@@ -0,0 +1,47 @@
+#ifndef POST_PROCESSOR_H
+#define POST_PROCESSOR_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include "Mesh.h"
+
+class PostProcessor {
+    // Déformations et contraintes d'un champ de déplacements, constantes par élément (P1),
+    // rangées en "structure of arrays" comme le maillage. Les dérivées des fonctions de forme
+    // (coefficients de B) et les coefficients de C sont calculés une fois à la construction :
+    // chaque évaluation n'est plus qu'une boucle de produits sur des tableaux contigus,
+    // parallèle et vectorisable, que l'on peut relancer à chaque point d'une étude paramétrique.
+    // La géométrie et les matériaux du maillage ne doivent pas changer ensuite, et les éléments
+    // doivent être orientés (initializeElements) : B est divisée par l'aire non signée.
+
+    private:
+        const Mesh& _mesh;
+        std::vector<double> _dNdx[3], _dNdy[3];     // dérivées des 3 fonctions de forme
+        // C en contraintes planes, par élément. Seuls c11, c12 et c33 sont gardés : matériaux
+        // isotropes (Material), c22 = c11 et pas de couplage traction-cisaillement
+        std::vector<double> _c11, _c12, _c33;
+
+    public:
+        // Champs par élément : eps = B u (gamma_xy = 2 eps_xy), sigma = C eps
+        std::vector<double> strainXX, strainYY, strainXY;
+        std::vector<double> stressXX, stressYY, stressXY;
+        std::vector<double> vonMises;
+
+        // Champs lissés aux noeuds (slots) : moyenne pondérée par l'aire des éléments voisins
+        std::vector<double> nodalStressXX, nodalStressYY, nodalStressXY;
+        std::vector<double> nodalVonMises;
+
+        explicit PostProcessor(const Mesh& mesh);
+
+        void compute(const Eigen::VectorXd& U);
+        void recoverNodalFields();
+
+        // Contrainte de von Mises maximale (et élément correspondant) parmi les éléments de
+        // tag physique tag (tous si tag < 0)
+        double maxVonMises(int tag = -1, int* element = nullptr) const;
+
+        // Moyenne volumique d'un champ par élément, sur un tag physique (tous si tag < 0)
+        double average(const std::vector<double>& field, int tag = -1) const;
+};
+
+#endif
@@ -0,0 +1,820 @@
+#include "RVEMesher.h"
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Triangulation de Delaunay incrémentale (Bowyer-Watson). Les triangles sont dans le sens
+// direct ; l'arête i d'un triangle relie ses sommets i+1 et i+2 et nbr[3t+i] est le triangle
+// voisin de l'autre côté (-1 au bord). Les sommets 0, 1 et 2 forment un super-triangle qui
+// englobe le domaine ; les triangles qui les touchent sont retirés à la fin.
+class Delaunay {
+    public:
+        vector<double> x, y;
+        vector<int> tri, nbr;
+        vector<char> alive;
+
+        Delaunay(double x0, double y0, double x1, double y1) : _stamp(0), _last(0) {
+            double cx = 0.5 * (x0 + x1), cy = 0.5 * (y0 + y1), L = max(x1 - x0, y1 - y0);
+            _tiny = 1e-10 * L;
+            x = {cx - 20.0 * L, cx + 20.0 * L, cx};
+            y = {cy - 10.0 * L, cy - 10.0 * L, cy + 20.0 * L};
+            tri = {0, 1, 2};
+            nbr = {-1, -1, -1};
+            alive = {1};
+            _mark = {0};
+        }
+
+        int nbTriangles() const { return alive.size(); }
+        static bool isSuper(int v) { return v < 3; }
+
+        // Insère le point (px, py) et retourne son indice (celui d'un sommet confondu s'il
+        // existe déjà, -1 si le point n'a pas pu être inséré)
+        int insert(double px, double py) {
+            int t = locate(px, py);
+            for (int k = 0; k < 3; k++) {
+                int v = tri[3 * t + k];
+                if (abs(x[v] - px) + abs(y[v] - py) < _tiny) return v;
+            }
+
+            // Cavité : triangles dont le cercle circonscrit contient le point
+            _stamp++;
+            _cavity.clear();
+            _stack.assign(1, t);
+            _mark[t] = _stamp;
+            while (!_stack.empty()) {
+                int c = _stack.back();
+                _stack.pop_back();
+                _cavity.push_back(c);
+                for (int i = 0; i < 3; i++) {
+                    int n = nbr[3 * c + i];
+                    if (n >= 0 && _mark[n] != _stamp && inCircle(n, px, py)) {
+                        _mark[n] = _stamp;
+                        _stack.push_back(n);
+                    }
+                }
+            }
+
+            // En arithmétique flottante la cavité peut ne pas être étoilée par rapport au
+            // point : on retire les triangles dont une arête du contour ne le voit pas
+            for (int pass = 0; ; pass++) {
+                int bad = -1, badEdge = -1;
+                _boundary.clear();
+                for (int c : _cavity) {
+                    for (int i = 0; i < 3 && bad < 0; i++) {
+                        int n = nbr[3 * c + i];
+                        if (n >= 0 && _mark[n] == _stamp) continue;
+                        int a = tri[3 * c + (i + 1) % 3], b = tri[3 * c + (i + 2) % 3];
+                        if (orient(a, b, px, py) <= 0) {
+                            bad = c;
+                            badEdge = i;
+                            break;
+                        }
+                        int j = -1;
+                        if (n >= 0) {
+                            for (j = 0; j < 3 && nbr[3 * n + j] != c; j++) {}
+                        }
+                        BoundaryEdge edge = {a, b, n, j};
+                        _boundary.push_back(edge);
+                    }
+                    if (bad >= 0) break;
+                }
+                if (bad < 0) break;
+                if (pass > 1000) return -1;
+
+                if (bad == t) {
+                    // Point sur une arête du triangle de départ : le voisin rejoint la cavité
+                    int n = nbr[3 * t + badEdge];
+                    if (n < 0) return -1;
+                    _mark[n] = _stamp;
+                    _cavity.push_back(n);
+                    continue;
+                }
+
+                // Retrait de bad, puis seuls les triangles encore reliés au départ sont gardés
+                _mark[bad] = 0;
+                _stamp++;
+                _cavity.clear();
+                _stack.assign(1, t);
+                _mark[t] = _stamp;
+                while (!_stack.empty()) {
+                    int c = _stack.back();
+                    _stack.pop_back();
+                    _cavity.push_back(c);
+                    for (int i = 0; i < 3; i++) {
+                        int n = nbr[3 * c + i];
+                        if (n >= 0 && _mark[n] == _stamp - 1) {
+                            _mark[n] = _stamp;
+                            _stack.push_back(n);
+                        }
+                    }
+                }
+            }
+
+            // Nouveaux triangles (a, b, p) sur le contour, dans les places libérées d'abord
+            int p = x.size();
+            x.push_back(px);
+            y.push_back(py);
+            _startAt.resize(x.size(), -1);
+            for (int c : _cavity) {
+                alive[c] = 0;
+                _free.push_back(c);
+            }
+            for (const BoundaryEdge& edge : _boundary) {
+                int T = newTriangle();
+                tri[3 * T] = edge.a;
+                tri[3 * T + 1] = edge.b;
+                tri[3 * T + 2] = p;
+                nbr[3 * T + 2] = edge.outside;
+                if (edge.outside >= 0) nbr[3 * edge.outside + edge.outsideEdge] = T;
+                alive[T] = 1;
+                _startAt[edge.a] = T;
+            }
+            for (const BoundaryEdge& edge : _boundary) {
+                int T = _startAt[edge.a], next = _startAt[edge.b];
+                nbr[3 * T] = next;         // arête (b, p)
+                nbr[3 * next + 1] = T;     // arête (p, a) du suivant
+            }
+            _last = _startAt[_boundary[0].a];
+            return p;
+        }
+
+    private:
+        struct BoundaryEdge {
+            int a, b;             // arête du contour de la cavité, dans le sens direct
+            int outside;          // triangle extérieur (-1 : bord)
+            int outsideEdge;      // indice de l'arête dans le triangle extérieur
+        };
+
+        vector<int> _free, _mark, _cavity, _stack, _startAt;
+        vector<BoundaryEdge> _boundary;
+        int _stamp, _last;
+        double _tiny;
+
+        // Signe de l'aire du triangle (a, b, p), nul en deçà de l'erreur d'arrondi. orient et
+        // inCircle sont des filtres à tolérance relative, pas des prédicats exacts : des points
+        // presque alignés ou cocirculaires à ~1e-12 (resp. 1e-10) près sont tranchés comme
+        // dégénérés, sans garantie de cohérence entre les deux tests
+        int orient(int a, int b, double px, double py) const {
+            double l = (x[b] - x[a]) * (py - y[a]), r = (y[b] - y[a]) * (px - x[a]);
+            double det = l - r, bound = 1e-12 * (abs(l) + abs(r));
+            return det > bound ? 1 : (det < -bound ? -1 : 0);
+        }
+
+        // Point strictement dans le cercle circonscrit du triangle t (cocirculaires exclus)
+        bool inCircle(int t, double px, double py) const {
+            int a = tri[3 * t], b = tri[3 * t + 1], c = tri[3 * t + 2];
+            double adx = x[a] - px, ady = y[a] - py;
+            double bdx = x[b] - px, bdy = y[b] - py;
+            double cdx = x[c] - px, cdy = y[c] - py;
+            double alift = adx * adx + ady * ady;
+            double blift = bdx * bdx + bdy * bdy;
+            double clift = cdx * cdx + cdy * cdy;
+            double det = alift * (bdx * cdy - bdy * cdx) + blift * (cdx * ady - cdy * adx)
+                       + clift * (adx * bdy - ady * bdx);
+            double permanent = alift * (abs(bdx * cdy) + abs(bdy * cdx)) + blift * (abs(cdx * ady) + abs(cdy * adx))
+                             + clift * (abs(adx * bdy) + abs(ady * bdx));
+            return det > 1e-10 * permanent;
+        }
+
+        // Marche orientée depuis le dernier triangle créé (points insérés dans un ordre
+        // spatialement cohérent : quelques pas suffisent)
+        int locate(double px, double py) {
+            int t = alive[_last] ? _last : 0;
+            while (!alive[t]) t++;
+            int limit = 8 + nbTriangles();
+            for (int step = 0; step < limit; step++) {
+                bool moved = false;
+                for (int k = 0; k < 3; k++) {
+                    int i = (k + step) % 3;
+                    if (orient(tri[3 * t + (i + 1) % 3], tri[3 * t + (i + 2) % 3], px, py) < 0) {
+                        int n = nbr[3 * t + i];
+                        if (n < 0) return t;
+                        t = n;
+                        moved = true;
+                        break;
+                    }
+                }
+                if (!moved) return t;
+            }
+
+            // Marche bouclée (dégénérescence) : recherche exhaustive
+            for (int s = 0; s < nbTriangles(); s++) {
+                if (!alive[s]) continue;
+                bool inside = true;
+                for (int i = 0; i < 3 && inside; i++) {
+                    inside = orient(tri[3 * s + (i + 1) % 3], tri[3 * s + (i + 2) % 3], px, py) >= 0;
+                }
+                if (inside) return s;
+            }
+            return t;
+        }
+
+        int newTriangle() {
+            if (!_free.empty()) {
+                int t = _free.back();
+                _free.pop_back();
+                return t;
+            }
+            tri.resize(tri.size() + 3);
+            nbr.resize(nbr.size() + 3);
+            alive.push_back(0);
+            _mark.push_back(0);
+            return alive.size() - 1;
+        }
+};
+
+// Fibres rangées dans une grille (chaque fibre dans les cellules que couvre sa boîte) pour
+// évaluer la distance à l'interface la plus proche
+class FiberGrid {
+    private:
+        const vector<Fiber>& _fibers;
+        double _x0, _y0, _cell;
+        int _nx, _ny;
+        vector<int> _start, _items;
+
+        int cellX(double v) const { return min(_nx - 1, max(0, (int)floor((v - _x0) / _cell))); }
+        int cellY(double v) const { return min(_ny - 1, max(0, (int)floor((v - _y0) / _cell))); }
+
+    public:
+        FiberGrid(const vector<Fiber>& fibers, double x0, double y0, double x1, double y1, double cell)
+            : _fibers(fibers), _x0(x0), _y0(y0), _cell(cell) {
+            _nx = max(1, (int)ceil((x1 - x0) / cell));
+            _ny = max(1, (int)ceil((y1 - y0) / cell));
+            _start.assign((size_t)_nx * _ny + 1, 0);
+            for (int pass = 0; pass < 2; pass++) {
+                vector<int> fill(_start.begin(), _start.end() - 1);
+                if (pass == 1) _items.resize(_start.back());
+                for (size_t k = 0; k < fibers.size(); k++) {
+                    const Fiber& f = fibers[k];
+                    for (int j = cellY(f.y - f.r); j <= cellY(f.y + f.r); j++) {
+                        for (int i = cellX(f.x - f.r); i <= cellX(f.x + f.r); i++) {
+                            size_t c = (size_t)j * _nx + i;
+                            if (pass == 0) _start[c + 1]++;
+                            else _items[fill[c]++] = k;
+                        }
+                    }
+                }
+                if (pass == 0) {
+                    for (size_t c = 0; c + 1 < _start.size(); c++) _start[c + 1] += _start[c];
+                }
+            }
+        }
+
+        // Distance de (px, py) à l'interface la plus proche, bornée par maxDist ; owner reçoit
+        // la fibre qui contient le point (-1 : matrice)
+        double distance(double px, double py, double maxDist, int& owner) const {
+            double best = maxDist;
+            owner = -1;
+            for (int j = cellY(py - maxDist); j <= cellY(py + maxDist); j++) {
+                for (int i = cellX(px - maxDist); i <= cellX(px + maxDist); i++) {
+                    size_t c = (size_t)j * _nx + i;
+                    for (int k = _start[c]; k < _start[c + 1]; k++) {
+                        const Fiber& f = _fibers[_items[k]];
+                        double rho = sqrt((px - f.x) * (px - f.x) + (py - f.y) * (py - f.y));
+                        if (rho < f.r) owner = _items[k];
+                        best = min(best, abs(rho - f.r));
+                    }
+                }
+            }
+            return best;
+        }
+};
+
+// Points acceptés, chaînés par cellule, pour rejeter les candidats trop proches
+class PointGrid {
+    private:
+        double _x0, _y0, _cell;
+        int _nx, _ny;
+        vector<int> _head, _next;
+        const vector<double>& _px;
+        const vector<double>& _py;
+
+    public:
+        PointGrid(const vector<double>& px, const vector<double>& py, double x0, double y0, double x1, double y1,
+                  double cell)
+            : _x0(x0), _y0(y0), _cell(cell), _px(px), _py(py) {
+            _nx = max(1, (int)ceil((x1 - x0) / cell));
+            _ny = max(1, (int)ceil((y1 - y0) / cell));
+            _head.assign((size_t)_nx * _ny, -1);
+        }
+
+        int cellX(double v) const { return min(_nx - 1, max(0, (int)floor((v - _x0) / _cell))); }
+        int cellY(double v) const { return min(_ny - 1, max(0, (int)floor((v - _y0) / _cell))); }
+
+        void add(int i) {
+            size_t c = (size_t)cellY(_py[i]) * _nx + cellX(_px[i]);
+            _next.resize(max(_next.size(), (size_t)i + 1), -1);
+            _next[i] = _head[c];
+            _head[c] = i;
+        }
+
+        bool near(double x, double y, double radius) const {
+            for (int j = cellY(y - radius); j <= cellY(y + radius); j++) {
+                for (int i = cellX(x - radius); i <= cellX(x + radius); i++) {
+                    for (int k = _head[(size_t)j * _nx + i]; k >= 0; k = _next[k]) {
+                        double dx = _px[k] - x, dy = _py[k] - y;
+                        if (dx * dx + dy * dy < radius * radius) return true;
+                    }
+                }
+            }
+            return false;
+        }
+};
+
+// Indice de (x, y) sur la courbe de Hilbert d'ordre 16 (ordre d'insertion et de numérotation)
+uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t n = 1u << 16;
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0, ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Abscisses de a à b espacées de h(t) : marche puis mise à l'échelle pour tomber sur b
+vector<double> march(double a, double b, const function<double(double)>& h) {
+    vector<double> t(1, a);
+    while (true) {
+        double step = h(t.back());
+        if (t.back() + step >= b - 0.5 * step) break;
+        t.push_back(t.back() + step);
+    }
+    double last = t.back() + h(t.back());
+    if (t.size() > 1 && b - t.back() < 0.5 * h(t.back())) last = b;
+    for (double& v : t) v = a + (v - a) * (b - a) / (last - a);
+    t.push_back(b);
+    return t;
+}
+
+struct Segment {
+    int a, b;       // sommets de la triangulation
+    int fiber;      // fibre de l'interface (-1 : bord du rectangle)
+    int partner;    // segment du bord opposé (maillage périodique, -1 sinon)
+};
+
+uint64_t edgeKey(int a, int b) {
+    return ((uint64_t)min(a, b) << 32) | (uint32_t)max(a, b);
+}
+
+// Segments rangés par cellule de leur milieu, cellules au moins aussi grandes que le plus long
+// demi-segment : un point ne peut être dans le cercle diamétral que d'un segment des 3 x 3
+// cellules autour de lui
+class SegmentGrid {
+    private:
+        double _x0, _y0, _cell;
+        int _nx, _ny;
+        vector<int> _head, _next;
+
+    public:
+        SegmentGrid(double x0, double y0, double x1, double y1, double cell, int nbSegments)
+            : _x0(x0), _y0(y0), _cell(cell), _next(nbSegments, -1) {
+            _nx = max(1, min(4096, (int)ceil((x1 - x0) / cell)));
+            _ny = max(1, min(4096, (int)ceil((y1 - y0) / cell)));
+            _cell = max(cell, max((x1 - x0) / _nx, (y1 - y0) / _ny));
+            _head.assign((size_t)_nx * _ny, -1);
+        }
+
+        int cellX(double v) const { return min(_nx - 1, max(0, (int)floor((v - _x0) / _cell))); }
+        int cellY(double v) const { return min(_ny - 1, max(0, (int)floor((v - _y0) / _cell))); }
+
+        void add(int s, double mx, double my) {
+            size_t c = (size_t)cellY(my) * _nx + cellX(mx);
+            _next[s] = _head[c];
+            _head[c] = s;
+        }
+
+        // Premier segment dont le cercle diamétral contient strictement (x, y), -1 sinon
+        int encroached(double x, double y, const vector<Segment>& segments, const Delaunay& dt) const {
+            for (int j = max(0, cellY(y) - 1); j <= min(_ny - 1, cellY(y) + 1); j++) {
+                for (int i = max(0, cellX(x) - 1); i <= min(_nx - 1, cellX(x) + 1); i++) {
+                    for (int s = _head[(size_t)j * _nx + i]; s >= 0; s = _next[s]) {
+                        const Segment& seg = segments[s];
+                        double ax = dt.x[seg.a] - x, ay = dt.y[seg.a] - y, bx = dt.x[seg.b] - x, by = dt.y[seg.b] - y;
+                        if (ax * bx + ay * by < 0.0) return s;
+                    }
+                }
+            }
+            return -1;
+        }
+};
+
+// Aire de la partie d'un disque contenue dans le rectangle : longueur des cordes verticales
+// dans [yMin, yMax] intégrée en x (point milieu, erreur relative ~1e-4)
+double circleBoxArea(const Fiber& f, double xMin, double yMin, double xMax, double yMax) {
+    double a = max(f.x - f.r, xMin), b = min(f.x + f.r, xMax);
+    if (f.r <= 0.0 || b <= a) return 0.0;
+    const int samples = 512;
+    double dx = (b - a) / samples, area = 0.0;
+    for (int i = 0; i < samples; i++) {
+        double u = a + (i + 0.5) * dx - f.x;
+        double h = sqrt(max(f.r * f.r - u * u, 0.0));
+        area += max(min(f.y + h, yMax) - max(f.y - h, yMin), 0.0) * dx;
+    }
+    return area;
+}
+
+}
+
+bool meshFiberRVE(Mesh& mesh, const vector<Fiber>& fibers, double xMin, double yMin, double xMax, double yMax,
+                  const MesherOptions& options, Material* matrix, Material* fiber, ostream& log) {
+    auto t0 = chrono::high_resolution_clock::now();
+    double W = xMax - xMin, H = yMax - yMin;
+    if (!(W > 0.0 && H > 0.0)) {
+        cerr << "Erreur : rectangle de maillage vide" << endl;
+        return false;
+    }
+
+    // Fibres entièrement dans le rectangle et sans recouvrement
+    vector<Fiber> kept;
+    int outside = 0, overlapping = 0;
+    for (const Fiber& f : fibers) {
+        if (f.r <= 0.0 || f.x - f.r <= xMin || f.x + f.r >= xMax || f.y - f.r <= yMin || f.y + f.r >= yMax) {
+            outside++;
+            continue;
+        }
+        bool overlap = false;
+        for (const Fiber& g : kept) {
+            double dx = f.x - g.x, dy = f.y - g.y, rr = f.r + g.r;
+            if (dx * dx + dy * dy <= rr * rr) {
+                overlap = true;
+                break;
+            }
+        }
+        if (overlap) overlapping++;
+        else kept.push_back(f);
+    }
+    // Aire de fibre perdue (partie de chaque fibre ignorée située dans le rectangle) rapportée
+    // à l'aire de fibre demandée : la fraction de fibre du VER est faussée d'autant
+    if (outside > 0 || overlapping > 0) {
+        double requested = 0.0, lost = 0.0;
+        for (const Fiber& f : fibers) requested += circleBoxArea(f, xMin, yMin, xMax, yMax);
+        for (const Fiber& f : kept) lost -= circleBoxArea(f, xMin, yMin, xMax, yMax);
+        lost += requested;
+        log << "Attention : " << outside << " fibres débordant du rectangle et " << overlapping
+             << " fibres chevauchant une autre ignorées (non découpées) : aire de fibre perdue " << lost << ", soit "
+             << (requested > 0.0 ? 100.0 * lost / requested : 0.0) << " % de l'aire demandée ; fraction de fibre "
+             << (requested - lost) / (W * H) << " au lieu de " << requested / (W * H) << endl;
+    }
+
+    // Tailles : hF aux interfaces, croissance linéaire avec la distance jusqu'à hMax
+    double rMean = 0.0, rMax = 0.0;
+    for (const Fiber& f : kept) {
+        rMean += f.r / kept.size();
+        rMax = max(rMax, f.r);
+    }
+    double hF = options.sizeInterface > 0.0 ? options.sizeInterface
+              : (kept.empty() ? max(W, H) / 20.0 : 2.0 * M_PI * rMean / 24.0);
+    double hMax = options.sizeMax > 0.0 ? max(options.sizeMax, hF) : 4.0 * hF;
+    double grading = options.grading > 0.0 ? options.grading : 0.3;
+    double reach = max((hMax - hF) / grading, hF);
+    FiberGrid fiberGrid(kept, xMin, yMin, xMax, yMax, max(reach, 2.0 * rMax));
+    auto size = [&](double px, double py, double& d, int& owner) {
+        d = fiberGrid.distance(px, py, reach, owner);
+        return min(hMax, hF + grading * d);
+    };
+
+    vector<double> px, py;
+    vector<int> owner;   // fibre contenant le point ou portant l'interface (-1 : matrice)
+    vector<Segment> segments;
+    auto addPoint = [&](double x, double y, int k) {
+        px.push_back(x);
+        py.push_back(y);
+        owner.push_back(k);
+        return (int)px.size() - 1;
+    };
+
+    // Interfaces : polygones réguliers inscrits
+    for (size_t k = 0; k < kept.size(); k++) {
+        const Fiber& f = kept[k];
+        int n = max(8, (int)ceil(2.0 * M_PI * f.r / hF));
+        int first = px.size();
+        for (int j = 0; j < n; j++) {
+            double theta = 2.0 * M_PI * j / n;
+            addPoint(f.x + f.r * cos(theta), f.y + f.r * sin(theta), k);
+        }
+        for (int j = 0; j < n; j++) {
+            Segment s = {first + j, first + (j + 1) % n, (int)k, -1};
+            segments.push_back(s);
+        }
+    }
+
+    // Bords : mêmes abscisses sur les côtés opposés, chaque côté coupé en son milieu (noeud
+    // à mi-hauteur pour les essais qui bloquent uy sur l'axe médian)
+    auto sideParams = [&](double a, double b, bool horizontal) {
+        auto h = [&](double t) {
+            double d;
+            int k;
+            return horizontal ? min(size(t, yMin, d, k), size(t, yMax, d, k))
+                              : min(size(xMin, t, d, k), size(xMax, t, d, k));
+        };
+        double mid = 0.5 * (a + b);
+        vector<double> t = march(a, mid, h), upper = march(mid, b, h);
+        t.insert(t.end(), upper.begin() + 1, upper.end());
+        return t;
+    };
+    vector<double> tx = sideParams(xMin, xMax, true), ty = sideParams(yMin, yMax, false);
+    int corner[4] = {addPoint(xMin, yMin, -1), addPoint(xMax, yMin, -1), addPoint(xMax, yMax, -1),
+                     addPoint(xMin, yMax, -1)};
+    vector<int> side[4];   // bas, droite, haut, gauche, dans le sens des x ou y croissants
+    side[0].push_back(corner[0]);
+    side[2].push_back(corner[3]);
+    for (size_t i = 1; i + 1 < tx.size(); i++) {
+        side[0].push_back(addPoint(tx[i], yMin, -1));
+        side[2].push_back(addPoint(tx[i], yMax, -1));
+    }
+    side[0].push_back(corner[1]);
+    side[2].push_back(corner[2]);
+    side[3].push_back(corner[0]);
+    side[1].push_back(corner[1]);
+    for (size_t i = 1; i + 1 < ty.size(); i++) {
+        side[3].push_back(addPoint(xMin, ty[i], -1));
+        side[1].push_back(addPoint(xMax, ty[i], -1));
+    }
+    side[3].push_back(corner[3]);
+    side[1].push_back(corner[2]);
+    for (int s = 0; s < 2; s++) {
+        // Côté s (bas, droite) et côté opposé s + 2 (haut, gauche)
+        const vector<int>& lower = side[s == 0 ? 0 : 3];
+        const vector<int>& upper = side[s == 0 ? 2 : 1];
+        for (size_t i = 0; i + 1 < lower.size(); i++) {
+            int first = segments.size();
+            Segment a = {lower[i], lower[i + 1], -1, options.periodic ? first + 1 : -1};
+            Segment b = {upper[i], upper[i + 1], -1, options.periodic ? first : -1};
+            segments.push_back(a);
+            segments.push_back(b);
+        }
+    }
+    int nbConstrained = px.size();
+
+    // Semis intérieur : réseaux triangulaires emboîtés de pas hF, 2 hF, 4 hF..., chacun
+    // retenu là où la taille visée est comprise entre son pas et le double
+    PointGrid accepted(px, py, xMin, yMin, xMax, yMax, hF);
+    for (int i = 0; i < (int)px.size(); i++) accepted.add(i);
+    for (double s = hF; ; s *= 2.0) {
+        bool coarsest = (2.0 * s > hMax);
+        double dy = s * sqrt(3.0) / 2.0;
+        for (int j = 0; yMin + (j + 0.5) * dy < yMax; j++) {
+            double y = yMin + (j + 0.5) * dy;
+            for (int i = 0; xMin + (i + 0.25 + 0.5 * (j & 1)) * s < xMax; i++) {
+                double x = xMin + (i + 0.25 + 0.5 * (j & 1)) * s;
+                double d;
+                int k;
+                double h = size(x, y, d, k);
+                if ((h >= 2.0 * s && !coarsest) || (h < s && s > hF)) continue;
+                if (d < 0.6 * s) continue;
+                if (min(min(x - xMin, xMax - x), min(y - yMin, yMax - y)) < 0.6 * s) continue;
+                if (accepted.near(x, y, 0.75 * s)) continue;
+                accepted.add(addPoint(x, y, k));
+            }
+        }
+        if (coarsest) break;
+    }
+
+    // Triangulation, points insérés dans l'ordre de la courbe de Hilbert
+    int nbPoints = px.size();
+    vector<pair<uint64_t, int>> order(nbPoints);
+    double scale = 65535.0 / max(W, H);
+    for (int i = 0; i < nbPoints; i++) {
+        order[i] = make_pair(hilbertIndex((uint32_t)((px[i] - xMin) * scale), (uint32_t)((py[i] - yMin) * scale)), i);
+    }
+    sort(order.begin(), order.end());
+
+    Delaunay dt(xMin, yMin, xMax, yMax);
+    vector<int> vertexOf(nbPoints, -1);
+    vector<int> vertexOwner(3, -1);
+    for (const auto& o : order) {
+        int i = o.second;
+        int v = dt.insert(px[i], py[i]);
+        if (v < 0) {
+            cerr << "Erreur : insertion du point (" << px[i] << ", " << py[i] << ") impossible" << endl;
+            return false;
+        }
+        if (v == (int)vertexOwner.size()) vertexOwner.push_back(owner[i]);
+        vertexOf[i] = v;
+    }
+    for (Segment& s : segments) {
+        s.a = vertexOf[s.a];
+        s.b = vertexOf[s.b];
+    }
+
+    // Segments absents de la triangulation : coupés en leur milieu (sur l'arc pour les
+    // interfaces), ainsi que leur vis-à-vis sur le bord opposé, jusqu'à les obtenir tous.
+    // Puis raffinement de Ruppert si options.minAngle > 0 : les segments empiétés (un sommet
+    // voisin dans leur cercle diamétral) sont coupés de même, et chaque triangle d'angle
+    // minimal inférieur à la borne reçoit le centre de son cercle circonscrit, sauf si ce
+    // centre empiète sur un segment, qui est alors coupé à la place. Les triangles dont la
+    // plus petite arête est sous hF / 20 (fibres presque en contact) ne sont pas raffinés.
+    int splits = 0, missing = 0, inserted = 0;
+    auto split = [&](int s) {
+        Segment seg = segments[s];
+        double mx = 0.5 * (dt.x[seg.a] + dt.x[seg.b]), my = 0.5 * (dt.y[seg.a] + dt.y[seg.b]);
+        if (seg.fiber >= 0) {
+            const Fiber& f = kept[seg.fiber];
+            double rho = sqrt((mx - f.x) * (mx - f.x) + (my - f.y) * (my - f.y));
+            mx = f.x + f.r * (mx - f.x) / rho;
+            my = f.y + f.r * (my - f.y) / rho;
+        }
+        int v = dt.insert(mx, my);
+        if (v < 0) return -1;
+        if (v == (int)vertexOwner.size()) vertexOwner.push_back(seg.fiber);
+        segments[s].b = v;
+        Segment upper = {v, seg.b, seg.fiber, -1};
+        segments.push_back(upper);
+        splits++;
+        return (int)segments.size() - 1;
+    };
+    auto missingSegments = [&]() {
+        unordered_set<uint64_t> edges;
+        edges.reserve(3 * dt.nbTriangles());
+        for (int t = 0; t < dt.nbTriangles(); t++) {
+            if (!dt.alive[t]) continue;
+            for (int i = 0; i < 3; i++) edges.insert(edgeKey(dt.tri[3 * t + i], dt.tri[3 * t + (i + 1) % 3]));
+        }
+        vector<int> absent;
+        for (int s = 0; s < (int)segments.size(); s++) {
+            if (!edges.count(edgeKey(segments[s].a, segments[s].b))) absent.push_back(s);
+        }
+        return absent;
+    };
+    bool refine = options.minAngle > 0.0;
+    double radiusRatio = refine ? 0.5 / sin(options.minAngle * M_PI / 180.0) : 0.0;  // R / arête minimale
+    double minEdge = 0.05 * hF;
+    for (int round = 0; round < (refine ? 256 : 64); round++) {
+        vector<int> toSplit = missingSegments();
+        missing = toSplit.size();
+        vector<char> done(segments.size(), 0);
+        int insertedBefore = inserted;
+
+        if (refine && missing == 0) {
+            unordered_map<uint64_t, int> segmentOf;
+            segmentOf.reserve(segments.size());
+            double cell = 0.0;
+            for (int s = 0; s < (int)segments.size(); s++) {
+                const Segment& seg = segments[s];
+                segmentOf[edgeKey(seg.a, seg.b)] = s;
+                cell = max(cell, 0.5 * hypot(dt.x[seg.a] - dt.x[seg.b], dt.y[seg.a] - dt.y[seg.b]));
+            }
+
+            // Segments empiétés par le sommet opposé d'un triangle voisin (Delaunay : si un
+            // sommet est dans le cercle diamétral, un sommet opposé l'est aussi)
+            for (int t = 0; t < dt.nbTriangles(); t++) {
+                if (!dt.alive[t]) continue;
+                for (int i = 0; i < 3; i++) {
+                    int c = dt.tri[3 * t + i], a = dt.tri[3 * t + (i + 1) % 3], b = dt.tri[3 * t + (i + 2) % 3];
+                    if (Delaunay::isSuper(c)) continue;
+                    unordered_map<uint64_t, int>::const_iterator it = segmentOf.find(edgeKey(a, b));
+                    if (it == segmentOf.end() || done[it->second]) continue;
+                    double ax = dt.x[a] - dt.x[c], ay = dt.y[a] - dt.y[c], bx = dt.x[b] - dt.x[c], by = dt.y[b] - dt.y[c];
+                    if (ax * bx + ay * by < 0.0) {
+                        done[it->second] = 1;
+                        toSplit.push_back(it->second);
+                    }
+                }
+            }
+
+            // Triangles de mauvaise qualité : centre du cercle circonscrit
+            if (toSplit.empty()) {
+                SegmentGrid grid(xMin, yMin, xMax, yMax, max(cell, 1e-6 * hF), segments.size());
+                for (int s = 0; s < (int)segments.size(); s++) {
+                    const Segment& seg = segments[s];
+                    grid.add(s, 0.5 * (dt.x[seg.a] + dt.x[seg.b]), 0.5 * (dt.y[seg.a] + dt.y[seg.b]));
+                }
+                struct Candidate { int t, v[3]; double x, y; };
+                vector<Candidate> bad;
+                for (int t = 0; t < dt.nbTriangles(); t++) {
+                    if (!dt.alive[t]) continue;
+                    const int* v = &dt.tri[3 * t];
+                    if (Delaunay::isSuper(v[0]) || Delaunay::isSuper(v[1]) || Delaunay::isSuper(v[2])) continue;
+                    double bx = dt.x[v[1]] - dt.x[v[0]], by = dt.y[v[1]] - dt.y[v[0]];
+                    double cx = dt.x[v[2]] - dt.x[v[0]], cy = dt.y[v[2]] - dt.y[v[0]];
+                    double D = 2.0 * (bx * cy - by * cx);
+                    if (!(D > 0.0)) continue;
+                    double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+                    double ux = (cy * b2 - by * c2) / D, uy = (bx * c2 - cx * b2) / D;
+                    double shortest = sqrt(min(min(b2, c2), (cx - bx) * (cx - bx) + (cy - by) * (cy - by)));
+                    if (shortest < minEdge || sqrt(ux * ux + uy * uy) <= radiusRatio * shortest) continue;
+                    Candidate candidate = {t, {v[0], v[1], v[2]}, dt.x[v[0]] + ux, dt.y[v[0]] + uy};
+                    bad.push_back(candidate);
+                }
+                for (const Candidate& c : bad) {
+                    // Triangle détruit par une insertion précédente de ce tour
+                    const int* v = &dt.tri[3 * c.t];
+                    if (!dt.alive[c.t] || v[0] != c.v[0] || v[1] != c.v[1] || v[2] != c.v[2]) continue;
+                    int s = grid.encroached(c.x, c.y, segments, dt);
+                    if (s >= 0) {
+                        if (!done[s]) toSplit.push_back(s);
+                        done[s] = 1;
+                        continue;
+                    }
+                    if (c.x <= xMin || c.x >= xMax || c.y <= yMin || c.y >= yMax) continue;
+                    double d;
+                    int k;
+                    size(c.x, c.y, d, k);
+                    int p = dt.insert(c.x, c.y);
+                    if (p < 0) continue;
+                    if (p == (int)vertexOwner.size()) vertexOwner.push_back(k);
+                    inserted++;
+                }
+            }
+            fill(done.begin(), done.end(), 0);
+        }
+        if (toSplit.empty() && inserted == insertedBefore) break;
+
+        for (int s : toSplit) {
+            if (done[s]) continue;
+            const Segment& seg = segments[s];
+            double len = hypot(dt.x[seg.a] - dt.x[seg.b], dt.y[seg.a] - dt.y[seg.b]);
+            if (len < 1e-6 * hF) continue;
+            int p = seg.partner;
+            done[s] = 1;
+            int upper = split(s);
+            if (p >= 0 && !done[p]) {
+                done[p] = 1;
+                int partnerUpper = split(p);
+                if (upper >= 0 && partnerUpper >= 0) {
+                    segments[upper].partner = partnerUpper;
+                    segments[partnerUpper].partner = upper;
+                }
+            }
+        }
+    }
+    missing = missingSegments().size();
+    if (missing > 0) {
+        log << "Attention : " << missing << " segments absents du maillage (interfaces trop proches ?)" << endl;
+    }
+
+    // Éléments : triangles réels dans le rectangle, fibre si leurs trois sommets
+    // appartiennent à la même fibre (les polygones d'interface sont convexes)
+    vector<pair<int, int>> elements;   // (plus petit sommet, triangle) pour la numérotation
+    for (int t = 0; t < dt.nbTriangles(); t++) {
+        if (!dt.alive[t]) continue;
+        const int* v = &dt.tri[3 * t];
+        if (Delaunay::isSuper(v[0]) || Delaunay::isSuper(v[1]) || Delaunay::isSuper(v[2])) continue;
+        double xc = (dt.x[v[0]] + dt.x[v[1]] + dt.x[v[2]]) / 3.0, yc = (dt.y[v[0]] + dt.y[v[1]] + dt.y[v[2]]) / 3.0;
+        if (xc < xMin || xc > xMax || yc < yMin || yc > yMax) continue;
+        elements.push_back(make_pair(min(v[0], min(v[1], v[2])), t));
+    }
+    sort(elements.begin(), elements.end());
+
+    // Remplissage du maillage : tag de noeud = sommet - 2 (les 3 premiers forment le super-triangle)
+    int nbVertices = dt.x.size() - 3;
+    mesh = Mesh();
+    mesh.reserve(nbVertices, elements.size());
+    for (int v = 3; v < (int)dt.x.size(); v++) mesh.addNode(v - 2, dt.x[v], dt.y[v]);
+    mesh.buildNodeIndex();
+    if (matrix == nullptr) cerr << "Attention : matériau non défini pour le tag 1" << endl;
+    int matrixIndex = mesh.addMaterial(1, matrix);
+    int fiberIndex = matrixIndex;
+    if (!kept.empty()) {
+        if (fiber == nullptr) cerr << "Attention : matériau non défini pour le tag 2" << endl;
+        fiberIndex = mesh.addMaterial(2, fiber);
+    }
+
+    double minAngle = M_PI, bound = options.minAngle * M_PI / 180.0;
+    int below = 0;
+    for (const auto& e : elements) {
+        const int* v = &dt.tri[3 * e.second];
+        bool inFiber = vertexOwner[v[0]] >= 0 && vertexOwner[v[0]] == vertexOwner[v[1]]
+                    && vertexOwner[v[0]] == vertexOwner[v[2]];
+        mesh.addElement(v[0] - 2, v[1] - 2, v[2] - 2, inFiber ? fiberIndex : matrixIndex);
+        double angle = M_PI;
+        for (int i = 0; i < 3; i++) {
+            int a = v[i], b = v[(i + 1) % 3], c = v[(i + 2) % 3];
+            double ux = dt.x[b] - dt.x[a], uy = dt.y[b] - dt.y[a];
+            double wx = dt.x[c] - dt.x[a], wy = dt.y[c] - dt.y[a];
+            angle = min(angle, abs(atan2(ux * wy - uy * wx, ux * wx + uy * wy)));
+        }
+        minAngle = min(minAngle, angle);
+        if (angle < bound) below++;
+    }
+    for (const Segment& s : segments) mesh.addEdge(s.a - 2, s.b - 2, s.fiber >= 0 ? 11 : 12);
+
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    log << "Maillage du VER : " << kept.size() << " fibres, " << mesh.nbNodes() << " noeuds ("
+        << nbConstrained << " sur les interfaces et les bords), " << mesh.nbElements() << " éléments en "
+        << elapsed.count() * 1e3 << " ms" << endl;
+    log << "  tailles " << hF << " (interfaces) à " << hMax << ", " << splits << " segments redécoupés, "
+        << inserted << " centres de cercles circonscrits insérés, angle minimal " << minAngle * 180.0 / M_PI
+        << " degrés" << endl;
+    if (below > 0) {
+        log << "Attention : " << below << " triangles sous l'angle minimal de " << options.minAngle
+            << " degrés (fibres presque en contact ?)" << endl;
+    }
+    return missing == 0;
+}
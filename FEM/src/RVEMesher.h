@@ -0,0 +1,41 @@
+#ifndef RVE_MESHER_H
+#define RVE_MESHER_H
+
+#include <vector>
+#include <iostream>
+#include "Mesh.h"
+#include "FiberLayout.h"
+
+// Maillage d'un VER fibres/matrice directement en mémoire, sans passer par Gmsh : les
+// interfaces (polygones inscrits dans les cercles) et les bords du rectangle sont discrétisés,
+// un semis de points gradué est ajouté (fin près des interfaces, grossier loin d'elles), puis
+// triangulé par Delaunay incrémental (Bowyer-Watson). Les segments absents de la triangulation
+// sont coupés en deux jusqu'à ce qu'ils y apparaissent tous (Delaunay conforme), puis les
+// triangles d'angle inférieur à minAngle sont raffinés par l'algorithme de Ruppert. Le maillage
+// obtenu suit les conventions de Preprocessing/maillage.py : éléments de tag 1 (matrice) et
+// 2 (fibres), arêtes de tag 11 (interfaces) et 12 (bord extérieur).
+
+struct MesherOptions {
+    double sizeInterface;  // longueur des arêtes sur les interfaces (<= 0 : périmètre moyen / 24)
+    double sizeMax;        // taille maximale des éléments (<= 0 : 4 sizeInterface)
+    double grading;        // croissance de la taille avec la distance aux interfaces (h = hF + g d)
+    bool periodic;         // bords opposés discrétisés à l'identique, y compris après découpage
+    double minAngle;       // angle minimal visé en degrés (raffinement de Ruppert, <= 0 : aucun)
+
+    MesherOptions() : sizeInterface(0.0), sizeMax(0.0), grading(0.3), periodic(false), minAngle(20.0) {}
+};
+
+// Maillage du rectangle [xMin, xMax] x [yMin, yMax] contenant les fibres. Les fibres qui
+// débordent du rectangle ou en chevauchent une autre sont ignorées, pas découpées : un
+// avertissement donne leur nombre, l'aire de fibre perdue et la fraction de fibre obtenue.
+// Les tests d'orientation et de cercle circonscrit sont en double avec une tolérance relative
+// (pas de prédicats exacts) et les points à moins de 1e-10 fois la taille du rectangle sont
+// confondus : des fibres qui se touchent presque, ou des détails plus fins que ~1e-8 du
+// rectangle, peuvent faire manquer des segments (retour false). Les avertissements (fibres
+// ignorées, segments manquants, triangles restés sous minAngle) sont écrits sur log.
+// Le maillage est vidé puis rempli comme par MeshReader (noeuds, éléments, arêtes) : il reste
+// à appeler initializeElements() et computeGeometry(). Retourne false en cas d'échec.
+bool meshFiberRVE(Mesh& mesh, const std::vector<Fiber>& fibers, double xMin, double yMin, double xMax, double yMax,
+                  const MesherOptions& options, Material* matrix, Material* fiber, std::ostream& log = std::cout);
+
+#endif
@@ -3,15 +3,22 @@
 #include <fstream>
 #include <cmath>
 #include <chrono>
+#include <algorithm>
+#include <limits>
 #include <Eigen/IterativeLinearSolvers>
+#include "Krylov.h"
+#include "Parallel.h"
+#include "MeshRefinement.h"
+#include "VTUWriter.h"
+#include "PostProcessor.h"
 
 using namespace std;
 using namespace Eigen;
 
 Solver::Solver(Mesh& mesh, double tolerance, int maxIterations)
-    : _mesh(mesh), _tol(tolerance), _maxIter(maxIterations) {
+    : _mesh(mesh), _bcMethod("lifting"), _tol(tolerance), _maxIter(maxIterations), _mode("assembled"), _linearSolver("cg"), _amgSmoother("chebyshev"), _matrixFormat("csr"), _precision("double"), _cgImplementation("eigen"), _factorized(false), _analyzeTime(0), _factorTime(0), _patternNnz(0), _log(&cout) {
     
-    int nbDofs = 2 * _mesh.nbNodes();
+    int nbDofs = _mesh.nbDofs();
     
     _U.resize(nbDofs);
     _U.setZero();
@@ -22,80 +29,496 @@ Solver::Solver(Mesh& mesh, double tolerance, int maxIterations)
     _K.resize(nbDofs, nbDofs);
 }
 
-void Solver::setDirichletBC(int nodeId, int dof, double value) {
-    int globalDof = 2 * (nodeId - 1) + dof;
-    _dirichletBCs[globalDof] = value;
+// Tag de noeud d'une CL : rejet (message) s'il n'existe pas, sinon dof() est sûr
+static bool checkBCNode(const Mesh& mesh, int nodeId) {
+    if (mesh.hasNode(nodeId)) return true;
+    cerr << "Erreur : noeud " << nodeId << " inexistant, condition aux limites rejetée" << endl;
+    return false;
 }
 
-void Solver::setNeumannBC(int nodeId, int dof, double value) {
-    int globalDof = 2 * (nodeId - 1) + dof;
-    _neumannBCs[globalDof] = value;
+bool Solver::setDirichletBC(int nodeId, int dof, double value) {
+    if (!checkBCNode(_mesh, nodeId)) return false;
+    _dirichletBCs[_mesh.dof(nodeId, dof)] = value;
+    return true;
+}
+
+bool Solver::setNeumannBC(int nodeId, int dof, double value) {
+    if (!checkBCNode(_mesh, nodeId)) return false;
+    _neumannBCs[_mesh.dof(nodeId, dof)] = value;
+    return true;
+}
+
+bool Solver::setPeriodicBC(int slaveId, int masterId, int dof, double offset) {
+    if (!checkBCNode(_mesh, slaveId) || !checkBCNode(_mesh, masterId)) return false;
+    _periodicBCs[_mesh.dof(slaveId, dof)] = make_pair(_mesh.dof(masterId, dof), offset);
+    return true;
 }
 
 void Solver::clearBCs() {
     _dirichletBCs.clear();
     _neumannBCs.clear();
+    _periodicBCs.clear();
+}
+
+void Solver::setSolverMode(const string& mode) {
+    if (mode != "assembled" && mode != "matrix_free") {
+        cerr << "Attention : mode de résolution inconnu '" << mode << "', utilisation de 'assembled'" << endl;
+        _mode = "assembled";
+        return;
+    }
+    _mode = mode;
+}
+
+void Solver::setLinearSolver(const string& solver) {
+    if (solver != "cg" && solver != "cholesky" && solver != "amg" && solver != "gmg") {
+        cerr << "Attention : solveur linéaire inconnu '" << solver << "', utilisation de 'cg'" << endl;
+        _linearSolver = "cg";
+        return;
+    }
+    _linearSolver = solver;
+}
+
+void Solver::setMatrixFormat(const string& format) {
+    if (format != "csr" && format != "bsr") {
+        cerr << "Attention : format de matrice inconnu '" << format << "', utilisation de 'csr'" << endl;
+        _matrixFormat = "csr";
+        return;
+    }
+    _matrixFormat = format;
+}
+
+void Solver::setPrecision(const string& precision) {
+    if (precision != "double" && precision != "mixed") {
+        cerr << "Attention : précision inconnue '" << precision << "', utilisation de 'double'" << endl;
+        _precision = "double";
+        return;
+    }
+    _precision = precision;
+}
+
+void Solver::setCGImplementation(const string& implementation) {
+    if (implementation != "eigen" && implementation != "fused" && implementation != "pipelined") {
+        cerr << "Attention : implémentation du gradient conjugué inconnue '" << implementation << "', utilisation de 'eigen'" << endl;
+        _cgImplementation = "eigen";
+        return;
+    }
+    _cgImplementation = implementation;
 }
 
 void Solver::assemble() {
-    vector<Triplet<double>> triplets;
+    if (isMatrixFree()) {
+        // Pas de matrice globale : seul l'opérateur élémentaire est construit
+        _op.reset(new ElasticityOperator(_mesh));
+        *_log << "Opérateur sans matrice : " << _op->rows() << " DDL, " << _mesh.nbElements() << " éléments"
+             << (_mesh.elementMatrices.empty() ? " (Ke recalculées)" : " (Ke en cache)") << endl;
+        printMemory();
+        return;
+    }
     
-    for (const auto& elem : _mesh.elements) {
-        if (elem.Ke.norm() < 1e-20) continue;
-        
-        vector<int> dofMap;
-        for (int node : elem.nodeIds) {
-            dofMap.push_back(2*(node-1));
-            dofMap.push_back(2*(node-1)+1);
+    if (isBlockSparse()) {
+        if (!_Kb || _Kb->rows() != _mesh.nbDofs()) {
+            _Kb.reset(new BlockSparseMatrix());
+            _Kb->symbolic(_mesh);
         }
-        
-        for (int i = 0; i < 6; i++) {
-            for (int j = 0; j < 6; j++) {
-                triplets.push_back(Triplet<double>(dofMap[i], dofMap[j], elem.Ke(i,j)));
+        _Kb->assemble(_mesh);
+        *_log << "Assemblage : Matrice par blocs 2x2 " << _Kb->rows() << "x" << _Kb->rows() << ", "
+             << _Kb->nbBlocks() << " blocs, " << _mesh.nbColors() << " couleurs, " << numThreads() << " threads" << endl;
+        printMemory();
+        return;
+    }
+    
+    if (_scatter.empty() || !_K.isCompressed() || _K.nonZeros() != _patternNnz) {
+        symbolicAssembly();
+    }
+    numericAssembly();
+    
+    *_log << "Assemblage : Matrice " << _K.rows() << "x" << _K.cols() << ", nnz = " << _K.nonZeros()
+         << ", " << _mesh.nbColors() << " couleurs, " << numThreads() << " threads" << endl;
+    printMemory();
+}
+
+void Solver::symbolicAssembly() {
+    int nn = _mesh.nbNodes();
+    int ne = _mesh.nbElements();
+    
+    if ((int)_mesh.nodeElementStart.size() != nn + 1) _mesh.buildNodeElements();
+    const vector<int>& nodeElemStart = _mesh.nodeElementStart;
+    const vector<int>& nodeElems = _mesh.nodeElements;
+    
+    // Voisins de chaque noeud (lui-même compris), triés
+    vector<int> adjStart(nn + 1, 0);
+    vector<int> adj;
+    adj.reserve(7 * nn);
+    vector<int> neighbours;
+    for (int i = 0; i < nn; i++) {
+        neighbours.clear();
+        neighbours.push_back(i);
+        for (int k = nodeElemStart[i]; k < nodeElemStart[i + 1]; k++) {
+            const int32_t* n = _mesh.elementNodes(nodeElems[k]);
+            neighbours.insert(neighbours.end(), n, n + 3);
+        }
+        sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        adj.insert(adj.end(), neighbours.begin(), neighbours.end());
+        adjStart[i + 1] = adj.size();
+    }
+    
+    // Structure de K : la colonne du DDL 2j+c contient les lignes 2k, 2k+1 de chaque voisin k de j
+    int ndof = _mesh.nbDofs();
+    Index nnz = 4 * (Index)adj.size();
+    _K.resize(ndof, ndof);
+    _K.resizeNonZeros(nnz);
+    
+    int* outer = _K.outerIndexPtr();
+    int* inner = _K.innerIndexPtr();
+    outer[0] = 0;
+    for (int j = 0; j < nn; j++) {
+        for (int c = 0; c < 2; c++) {
+            int col = 2*j + c;
+            int pos = outer[col];
+            for (int k = adjStart[j]; k < adjStart[j + 1]; k++) {
+                inner[pos++] = 2*adj[k];
+                inner[pos++] = 2*adj[k] + 1;
+            }
+            outer[col + 1] = pos;
+        }
+    }
+    std::fill(_K.valuePtr(), _K.valuePtr() + nnz, 0.0);
+    _patternNnz = nnz;
+    
+    // Table de dispersion élément -> position dans valuePtr()
+    _scatter.resize(36 * (size_t)ne);
+    for (int e = 0; e < ne; e++) {
+        const int32_t* n = _mesh.elementNodes(e);
+        for (int b = 0; b < 3; b++) {
+            const int* first = &adj[adjStart[n[b]]];
+            const int* last = &adj[adjStart[n[b] + 1]];
+            for (int a = 0; a < 3; a++) {
+                int offset = 2 * (lower_bound(first, last, n[a]) - first);
+                for (int c = 0; c < 2; c++) {
+                    for (int d = 0; d < 2; d++) {
+                        // Coefficient Ke(2a+d, 2b+c)
+                        _scatter[36*(size_t)e + 6*(2*a + d) + 2*b + c] = outer[2*n[b] + c] + offset + d;
+                    }
+                }
             }
         }
     }
+}
+
+void Solver::numericAssembly() {
+    double* values = _K.valuePtr();
+    std::fill(values, values + _K.nonZeros(), 0.0);
+    
+    if (_mesh.nbColors() == 0) _mesh.computeColoring();
     
-    _K.setFromTriplets(triplets.begin(), triplets.end());
-    cout << "Assemblage : Matrice " << _K.rows() << "x" << _K.cols() << ", nnz = " << _K.nonZeros() << endl;
+    // Les éléments d'une même couleur ne partagent aucun noeud : ils écrivent dans des
+    // coefficients distincts de K, sans atomique. L'ordre des sommes est fixé par les couleurs.
+    for (int c = 0; c < _mesh.nbColors(); c++) {
+        #pragma omp parallel for schedule(static)
+        for (int k = _mesh.colorStart[c]; k < _mesh.colorStart[c + 1]; k++) {
+            int e = _mesh.colorElements[k];
+            if (_mesh.elementArea[e] < 1e-12) continue;
+            
+            ElementMatrix Ke;
+            _mesh.elementStiffness(e, Ke);
+            
+            // Ke est stockée par colonnes : parcours ligne par ligne pour suivre _scatter
+            const int* slots = &_scatter[36*(size_t)e];
+            for (int i = 0; i < 6; i++) {
+                for (int j = 0; j < 6; j++) {
+                    values[slots[6*i + j]] += Ke(i, j);
+                }
+            }
+        }
+    }
+}
+
+void Solver::printMemory() const {
+    // Vecteurs U, F et les 4 vecteurs de travail du gradient conjugué
+    double vectors = 6.0 * _mesh.nbDofs() * sizeof(double);
+    if (isMatrixFree()) {
+        double op = _op ? _op->memoryUsage() : 0.0;
+        *_log << "Mémoire (sans matrice) : opérateur " << op / 1048576.0 << " Mo, vecteurs "
+             << vectors / 1048576.0 << " Mo" << endl;
+    } else if (isBlockSparse()) {
+        double k = (_Kb ? _Kb->memoryUsage() : 0) + (_Kbbc ? _Kbbc->memoryUsage() : 0);
+        double index = _Kb ? _Kb->indexBytes() : 0;
+        k += _mesh.elementMatrices.capacity() * sizeof(double) + (_Kb ? _Kb->scatter.capacity() * sizeof(int) : 0);
+        *_log << "Mémoire (blocs 2x2) : matrice " << k / 1048576.0 << " Mo (indices "
+             << index / 1048576.0 << " Mo), vecteurs " << vectors / 1048576.0 << " Mo" << endl;
+    } else {
+        double k = _K.nonZeros() * (sizeof(double) + sizeof(int)) + (_K.outerSize() + 1) * sizeof(int);
+        k += _Kbc.nonZeros() * (sizeof(double) + sizeof(int)) + (_Kbc.outerSize() + 1) * sizeof(int);
+        k += _mesh.elementMatrices.capacity() * sizeof(double) + _scatter.capacity() * sizeof(int);
+        *_log << "Mémoire (assemblée) : matrice " << k / 1048576.0 << " Mo, vecteurs "
+             << vectors / 1048576.0 << " Mo" << endl;
+    }
+}
+
+void Solver::setBCMethod(const string& method) {
+    if (method != "lifting" && method != "reduction") {
+        cerr << "Attention : méthode de CL inconnue '" << method << "', utilisation de 'lifting'" << endl;
+        _bcMethod = "lifting";
+        return;
+    }
+    _bcMethod = method;
 }
 
 void Solver::applyBC() {
     // Appliquer les forces (Neumann BC)
+    _F.setZero(_mesh.nbDofs());
     for (const auto& force : _neumannBCs) {
         int dof = force.first;
         double value = force.second;
         _F(dof) += value;
     }
     
-    // Appliquer les déplacements imposés (Dirichlet BC)
+    // Déplacements imposés (Dirichlet BC)
+    vector<char> constrained(_mesh.nbDofs(), 0);
+    _u0.setZero(_mesh.nbDofs());
     for (const auto& disp : _dirichletBCs) {
-        int dof = disp.first;
-        double value = disp.second;
+        constrained[disp.first] = 1;
+        _u0(disp.first) = disp.second;
+    }
+    
+    _factorized = false;
+    _dofMap.clear();
+    
+    if (!_periodicBCs.empty()) {
+        if (isMatrixFree() || isBlockSparse()) {
+            cerr << "Erreur : CL périodiques disponibles en mode assemblé, format csr uniquement" << endl;
+            return;
+        }
+        applyPeriodic(constrained);
+    } else if (isMatrixFree()) {
+        // Masquage des DDL imposés et relèvement des valeurs connues dans le second membre
+        VectorXd Ku0;
+        _op->applyFull(_u0, Ku0);
+        _rhs = _F - Ku0;
+        for (const auto& disp : _dirichletBCs) _rhs(disp.first) = disp.second;
+        
+        _op->setConstrained(constrained);
+        _U = _u0;
+    } else if (isBlockSparse()) {
+        // Relèvement sur une copie de la matrice par blocs (mêmes lignes/colonnes identité qu'en CSR)
+        if (_bcMethod == "reduction") {
+            cerr << "Attention : format bsr incompatible avec la réduction, utilisation du relèvement" << endl;
+        }
+        VectorXd Ku0;
+        _Kb->apply(_u0, Ku0);
+        _rhs = _F - Ku0;
+        for (const auto& disp : _dirichletBCs) _rhs(disp.first) = disp.second;
         
-        // Modifier la matrice K: mettre 1 sur la diagonale, 0 ailleurs dans la ligne/colonne
-        for (int j = 0; j < _K.cols(); ++j) {
-            if (j != dof) {
-                _K.coeffRef(dof, j) = 0.0;
-                _K.coeffRef(j, dof) = 0.0;
+        _Kbbc.reset(new BlockSparseMatrix(*_Kb));
+        _Kbbc->applyConstraints(constrained);
+        _freeDofs.clear();
+    } else if (_bcMethod == "reduction") {
+        applyReduction(constrained);
+    } else {
+        applyLifting(constrained);
+    }
+    
+    *_log << "CL : " << _dirichletBCs.size() << " déplacements imposés, " 
+         << _neumannBCs.size() << " forces appliquées";
+    if (!_periodicBCs.empty()) *_log << ", " << _periodicBCs.size() << " DDL périodiques éliminés";
+    *_log << endl;
+}
+
+void Solver::applyLifting(const vector<char>& constrained) {
+    // Copie de K (même structure) modifiée en un seul passage sur ses coefficients :
+    // les valeurs imposées passent au second membre, lignes et colonnes deviennent l'identité
+    _Kbc = _K;
+    _rhs = _F;
+    
+    const int* outer = _Kbc.outerIndexPtr();
+    const int* inner = _Kbc.innerIndexPtr();
+    double* values = _Kbc.valuePtr();
+    
+    for (int j = 0; j < _Kbc.outerSize(); j++) {
+        for (int p = outer[j]; p < outer[j + 1]; p++) {
+            int i = inner[p];
+            if (constrained[j]) {
+                if (i == j) {
+                    values[p] = 1.0;
+                } else {
+                    if (!constrained[i]) _rhs(i) -= values[p] * _u0(j);
+                    values[p] = 0.0;
+                }
+            } else if (constrained[i]) {
+                values[p] = 0.0;
             }
         }
-        _K.coeffRef(dof, dof) = 1.0;
-        _F(dof) = value;
     }
     
-    cout << "CL : " << _dirichletBCs.size() << " déplacements imposés, " 
-         << _neumannBCs.size() << " forces appliquées" << endl;
+    for (const auto& disp : _dirichletBCs) _rhs(disp.first) = disp.second;
+    _freeDofs.clear();
+}
+
+void Solver::applyReduction(const vector<char>& constrained) {
+    // Numérotation des DDL libres
+    int n = _K.rows();
+    vector<int> reduced(n, -1);
+    _freeDofs.clear();
+    for (int i = 0; i < n; i++) {
+        if (!constrained[i]) {
+            reduced[i] = _freeDofs.size();
+            _freeDofs.push_back(i);
+        }
+    }
+    int nf = _freeDofs.size();
+    
+    const int* outer = _K.outerIndexPtr();
+    const int* inner = _K.innerIndexPtr();
+    const double* values = _K.valuePtr();
+    
+    // Taille de chaque colonne réduite
+    _Kbc.resize(nf, nf);
+    Index nnz = 0;
+    for (int k = 0; k < nf; k++) {
+        int j = _freeDofs[k];
+        for (int p = outer[j]; p < outer[j + 1]; p++) {
+            if (!constrained[inner[p]]) nnz++;
+        }
+    }
+    _Kbc.resizeNonZeros(nnz);
+    
+    // K_ff et second membre F_f - K_fc u_c
+    int* kOuter = _Kbc.outerIndexPtr();
+    int* kInner = _Kbc.innerIndexPtr();
+    double* kValues = _Kbc.valuePtr();
+    _rhs.resize(nf);
+    for (int k = 0; k < nf; k++) _rhs(k) = _F(_freeDofs[k]);
+    
+    Index pos = 0;
+    kOuter[0] = 0;
+    for (int j = 0, k = 0; j < n; j++) {
+        if (constrained[j]) {
+            if (_u0(j) == 0.0) continue;
+            for (int p = outer[j]; p < outer[j + 1]; p++) {
+                if (!constrained[inner[p]]) _rhs(reduced[inner[p]]) -= values[p] * _u0(j);
+            }
+            continue;
+        }
+        for (int p = outer[j]; p < outer[j + 1]; p++) {
+            if (constrained[inner[p]]) continue;
+            kInner[pos] = reduced[inner[p]];
+            kValues[pos] = values[p];
+            pos++;
+        }
+        kOuter[++k] = pos;
+    }
+}
+
+void Solver::applyPeriodic(const vector<char>& constrained) {
+    // Numérotation réduite : une inconnue par DDL libre non esclave
+    int n = _K.rows();
+    _dofMap.assign(n, -1);
+    _freeDofs.clear();
+    for (int i = 0; i < n; i++) {
+        if (!constrained[i] && !_periodicBCs.count(i)) {
+            _dofMap[i] = _freeDofs.size();
+            _freeDofs.push_back(i);
+        }
+    }
+    
+    // Esclaves : inconnue du maître, et décalage dans le champ imposé (plus la valeur du maître
+    // si celui-ci est imposé)
+    for (const auto& link : _periodicBCs) {
+        int s = link.first, m = link.second.first;
+        if (constrained[s]) {
+            cerr << "Attention : DDL " << s << " à la fois imposé et esclave, périodicité ignorée" << endl;
+            continue;
+        }
+        if (_periodicBCs.count(m)) {
+            cerr << "Erreur : le maître du DDL " << s << " est lui-même esclave, périodicité ignorée" << endl;
+            continue;
+        }
+        _dofMap[s] = _dofMap[m];
+        _u0(s) = link.second.second + (constrained[m] ? _u0(m) : 0.0);
+    }
+    
+    // K réduite = T^T K T (somme des lignes et colonnes des esclaves sur celles des maîtres),
+    // second membre T^T (F - K u0)
+    int nf = _freeDofs.size();
+    VectorXd r = _F - _K * _u0;
+    _rhs.setZero(nf);
+    for (int i = 0; i < n; i++) {
+        if (_dofMap[i] >= 0) _rhs(_dofMap[i]) += r(i);
+    }
+    
+    vector<Triplet<double>> triplets;
+    triplets.reserve(_K.nonZeros());
+    for (int j = 0; j < _K.outerSize(); j++) {
+        if (_dofMap[j] < 0) continue;
+        for (SparseMatrix<double>::InnerIterator it(_K, j); it; ++it) {
+            if (_dofMap[it.row()] >= 0) triplets.push_back(Triplet<double>(_dofMap[it.row()], _dofMap[j], it.value()));
+        }
+    }
+    _Kbc.resize(nf, nf);
+    _Kbc.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void Solver::expandSolution(const VectorXd& x) {
+    if (!_dofMap.empty()) {
+        _U = _u0;
+        for (size_t i = 0; i < _dofMap.size(); i++) {
+            if (_dofMap[i] >= 0) _U(i) += x(_dofMap[i]);
+        }
+        return;
+    }
+    if (_freeDofs.empty()) {
+        _U = x;
+        return;
+    }
+    _U = _u0;
+    for (size_t k = 0; k < _freeDofs.size(); k++) _U(_freeDofs[k]) = x(k);
+}
+
+VectorXd Solver::computeReactions() const {
+    // R = K U - F sur le système complet (non nul sur les DDL imposés)
+    VectorXd KU;
+    if (isMatrixFree()) {
+        _op->applyFull(_U, KU);
+    } else if (isBlockSparse()) {
+        _Kb->apply(_U, KU);
+    } else {
+        KU = _K * _U;
+    }
+    return KU - _F;
+}
+
+void Solver::solve() {
+    if (isMatrixFree()) {
+        solveMatrixFree();
+    } else if (isBlockSparse()) {
+        if (_linearSolver != "cg") {
+            cerr << "Attention : format bsr disponible avec le gradient conjugué uniquement" << endl;
+        }
+        solveBlockCG();
+    } else if (_linearSolver == "cholesky") {
+        solveCholesky();
+    } else if (_linearSolver == "amg") {
+        solveAMG();
+    } else if (_linearSolver == "gmg") {
+        solveGMG();
+    } else if (_precision == "mixed") {
+        solveMixedPrecision();
+    } else if (_cgImplementation != "eigen") {
+        solveFusedCG();
+    } else {
+        solveConjugateGradient();
+    }
 }
 
 void Solver::solveConjugateGradient() {
-    cout << "Résolution..." << endl;
+    *_log << "Résolution..." << endl;
 
     // Gradient conjugué préconditionné avec Incomplete Cholesky
     ConjugateGradient<SparseMatrix<double>, Lower|Upper, IncompleteCholesky<double>> solver;
     solver.setTolerance(1e-12);
     solver.setMaxIterations(10000);
-    solver.compute(_K);
+    solver.compute(_Kbc);
     
     if (solver.info() != Success) {
         cerr << "Erreur : échec de l'initialisation du gradient conjugué préconditionné" << endl;
@@ -105,7 +528,7 @@ void Solver::solveConjugateGradient() {
     // lancer le chrono
     
     auto t0 = std::chrono::high_resolution_clock::now();
-    _U = solver.solve(_F);
+    VectorXd x = solver.solve(_rhs);
     auto t1 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = t1 - t0;
 
@@ -116,13 +539,454 @@ void Solver::solveConjugateGradient() {
         return;
     }
 
+    expandSolution(x);
+    
     // Afficher nombre d'itérations et temps
-    cout << "Gradient conjugué préconditionné: itérations = " << solver.iterations()
+    *_log << "Gradient conjugué préconditionné: itérations = " << solver.iterations()
          << ", erreur = " << solver.error()
          << ", temps = " << elapsed.count() << " s" << endl;
 
     
-    cout << "Résolution terminée" << endl;
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveMixedPrecision() {
+    *_log << "Résolution (précision mixte)..." << endl;
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    // Facteur Incomplete Cholesky calculé en double puis stocké en float : les descentes-
+    // remontées, plus de la moitié du temps d'une itération, lisent un tiers d'octets en moins.
+    // K, les vecteurs et la récurrence restent en double : une copie float de K perturbe
+    // l'opérateur et ralentit la convergence superlinéaire (50 % d'itérations en plus sur
+    // composite_simple raffiné), ce que les mises à jour fiables ne rattrapent pas.
+    auto t0 = Clock::now();
+    IncompleteCholesky<double> ic;
+    ic.compute(_Kbc);
+    if (ic.info() != Success) {
+        cerr << "Erreur : échec de l'initialisation de l'Incomplete Cholesky" << endl;
+        return;
+    }
+    FloatIncompleteCholesky precond(ic);
+    SparseMatrixOperator op(_Kbc);
+    auto t1 = Clock::now();
+    
+    const int maxIterations = 10000;
+    VectorXd x;
+    double error = 0.0;
+    int updates = 0;
+    int iterations = mixedPrecisionConjugateGradient(op, precond, _rhs, x, 1e-12, maxIterations, error, updates);
+    auto t2 = Clock::now();
+    
+    double setupTime = std::chrono::duration<double>(t1 - t0).count();
+    double solveTime = std::chrono::duration<double>(t2 - t1).count();
+    
+    if (iterations >= maxIterations && error >= 1e-12) {
+        cerr << "Erreur : le gradient conjugué en précision mixte n'a pas convergé" << endl;
+        cerr << "Itérations: " << iterations << ", erreur (résidu vrai): " << error << endl;
+        return;
+    }
+    
+    // Précision atteignable en double : arrondi du produit K x
+    double floor = std::numeric_limits<double>::epsilon() * (_Kbc.cwiseAbs() * x.cwiseAbs()).norm() / _rhs.norm();
+    
+    expandSolution(x);
+    
+    double factorFloat = precond.bytes();
+    double factorDouble = precond.doubleBytes();
+    *_log << "Gradient conjugué en précision mixte: itérations = " << iterations
+         << ", mises à jour du résidu = " << updates << ", erreur (résidu vrai) = " << error
+         << " (arrondi double : " << floor << "), préparation = " << setupTime << " s, résolution = "
+         << solveTime << " s" << endl;
+    *_log << "  facteur IC float : " << factorFloat / 1048576.0 << " Mo (double : "
+         << factorDouble / 1048576.0 << " Mo)" << endl;
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveFusedCG() {
+    bool pipelined = (_cgImplementation == "pipelined");
+    *_log << "Résolution (gradient conjugué " << (pipelined ? "pipeliné" : "fusionné") << ")..." << endl;
+    
+    // Préconditionneur de Jacobi : contrairement aux descentes-remontées de l'IC, il se fusionne
+    // dans les passages sur les vecteurs et se parallélise sans dépendance
+    VectorXd invDiag = _Kbc.diagonal();
+    for (Index i = 0; i < invDiag.size(); i++) {
+        invDiag(i) = invDiag(i) != 0.0 ? 1.0 / invDiag(i) : 1.0;
+    }
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    VectorXd x = VectorXd::Zero(_rhs.size());
+    double error = 0.0;
+    int iterations = pipelined
+        ? pipelinedConjugateGradient(_Kbc, invDiag, _rhs, x, 1e-12, 10000, error, _history)
+        : fusedConjugateGradient(_Kbc, invDiag, _rhs, x, 1e-12, 10000, error, _history);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = t1 - t0;
+    
+    if (error > 1e-12) {
+        cerr << "Erreur : le gradient conjugué n'a pas convergé" << endl;
+        cerr << "Itérations: " << iterations << ", erreur: " << error << endl;
+        cerr << "Temps de résolution: " << elapsed.count() << " s" << endl;
+        return;
+    }
+    
+    // Le résidu récursif dérive du résidu vrai, surtout pour la variante pipelinée
+    double bNorm = _rhs.norm();
+    double trueError = bNorm > 0.0 ? (_rhs - _Kbc * x).norm() / bNorm : 0.0;
+    expandSolution(x);
+    
+    *_log << "Gradient conjugué " << (pipelined ? "pipeliné" : "fusionné") << " (Jacobi): itérations = " << iterations
+         << ", erreur = " << error << ", résidu vrai = " << trueError
+         << ", temps = " << elapsed.count() << " s (" << _history.meanTime() * 1e6 << " µs/itération)" << endl;
+    
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveMatrixFree() {
+    *_log << "Résolution (sans matrice)..." << endl;
+    
+    // Gradient conjugué préconditionné par la diagonale de K
+    JacobiPreconditioner precond(_op->diagonal());
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    double error = 0.0;
+    int iterations = conjugateGradient(*_op, precond, _rhs, _U, 1e-12, 10000, error);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = t1 - t0;
+    
+    if (error > 1e-12) {
+        cerr << "Erreur : le gradient conjugué sans matrice n'a pas convergé" << endl;
+        cerr << "Itérations: " << iterations << ", erreur: " << error << endl;
+        cerr << "Temps de résolution: " << elapsed.count() << " s" << endl;
+        return;
+    }
+    
+    *_log << "Gradient conjugué sans matrice (Jacobi): itérations = " << iterations
+         << ", erreur = " << error
+         << ", temps = " << elapsed.count() << " s" << endl;
+    
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveBlockCG() {
+    *_log << "Résolution (blocs 2x2)..." << endl;
+    
+    // Gradient conjugué préconditionné par les inverses des blocs diagonaux
+    BlockJacobiPreconditioner precond(*_Kbbc);
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    double error = 0.0;
+    int iterations = conjugateGradient(*_Kbbc, precond, _rhs, _U, 1e-12, 10000, error);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = t1 - t0;
+    
+    if (error > 1e-12) {
+        cerr << "Erreur : le gradient conjugué par blocs 2x2 n'a pas convergé" << endl;
+        cerr << "Itérations: " << iterations << ", erreur: " << error << endl;
+        cerr << "Temps de résolution: " << elapsed.count() << " s" << endl;
+        return;
+    }
+    
+    *_log << "Gradient conjugué BSR (Jacobi par blocs): itérations = " << iterations
+         << ", erreur = " << error
+         << ", temps = " << elapsed.count() << " s" << endl;
+    
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveCholesky() {
+    *_log << "Résolution (Cholesky creux)..." << endl;
+    typedef std::chrono::high_resolution_clock Clock;
+    
+#ifdef FEM_USE_CHOLMOD
+    // Factorisation supernodale (CHOLMOD) pour les grands systèmes
+    if (_Kbc.rows() > 50000) {
+        auto t0 = Clock::now();
+        _cholmod.reset(new CholmodSupernodalLLT<SparseMatrix<double>, Lower>());
+        _cholmod->compute(_Kbc);
+        auto t1 = Clock::now();
+        if (_cholmod->info() != Success) {
+            cerr << "Erreur : échec de la factorisation de Cholesky (CHOLMOD)" << endl;
+            return;
+        }
+        VectorXd x = _cholmod->solve(_rhs);
+        auto t2 = Clock::now();
+        expandSolution(x);
+        
+        *_log << "Cholesky supernodal (CHOLMOD): factorisation = " << std::chrono::duration<double>(t1 - t0).count()
+             << " s, descente-remontée = " << std::chrono::duration<double>(t2 - t1).count() << " s" << endl;
+        *_log << "Résolution terminée" << endl;
+        return;
+    }
+#endif
+    
+    if (!factorCholesky()) {
+        cerr << "Erreur : échec de la factorisation LDLt (matrice non définie positive ?)" << endl;
+        return;
+    }
+    
+    auto t0 = Clock::now();
+    VectorXd x = _ldlt->solve(_rhs);
+    auto t1 = Clock::now();
+    expandSolution(x);
+    
+    // Remplissage : nnz(L) comparé au triangle inférieur de K
+    Index nnzL = _ldlt->matrixL().nestedExpression().nonZeros();
+    Index nnzK = (_Kbc.nonZeros() + _Kbc.rows()) / 2;
+    double memory = nnzL * (sizeof(double) + sizeof(int)) + _Kbc.rows() * (sizeof(double) + 3 * sizeof(int));
+    
+    *_log << "Cholesky LDLt (AMD): analyse = " << _analyzeTime << " s, factorisation = " << _factorTime
+         << " s, descente-remontée = " << std::chrono::duration<double>(t1 - t0).count() << " s" << endl;
+    *_log << "  nnz(L) = " << nnzL << " (remplissage x" << (double)nnzL / nnzK << "), mémoire facteur = "
+         << memory / 1048576.0 << " Mo" << endl;
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveAMG() {
+    *_log << "Résolution (gradient conjugué + AMG)..." << endl;
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    // Noeud et modes rigides de chaque inconnue de _Kbc (2 translations + rotation autour du centre)
+    int n = _Kbc.rows();
+    vector<int> dofNode(n);
+    MatrixXd B(n, 3);
+    double xc = 0.5 * (_mesh.xMin + _mesh.xMax), yc = 0.5 * (_mesh.yMin + _mesh.yMax);
+    for (int i = 0; i < n; i++) {
+        int g = _freeDofs.empty() ? i : _freeDofs[i];
+        int slot = g / 2;
+        dofNode[i] = slot;
+        double x = _mesh.nodeX[slot] - xc, y = _mesh.nodeY[slot] - yc;
+        if (g % 2 == 0) B.row(i) << 1.0, 0.0, -y;
+        else B.row(i) << 0.0, 1.0, x;
+    }
+    
+    ConjugateGradient<SparseMatrix<double>, Lower|Upper, AMGPreconditioner> solver;
+    solver.setTolerance(1e-12);
+    solver.setMaxIterations(10000);
+    solver.preconditioner().setNearNullspace(dofNode, B);
+    solver.preconditioner().setSmoother(_amgSmoother);
+    
+    auto t0 = Clock::now();
+    solver.compute(_Kbc);
+    auto t1 = Clock::now();
+    if (solver.info() != Success) {
+        cerr << "Erreur : échec de la construction de la hiérarchie AMG" << endl;
+        return;
+    }
+    
+    VectorXd x = solver.solve(_rhs);
+    auto t2 = Clock::now();
+    double setupTime = std::chrono::duration<double>(t1 - t0).count();
+    double solveTime = std::chrono::duration<double>(t2 - t1).count();
+    
+    if (solver.info() != Success) {
+        cerr << "Erreur : le gradient conjugué préconditionné par AMG n'a pas convergé" << endl;
+        cerr << "Itérations: " << solver.iterations() << ", erreur: " << solver.error() << endl;
+        return;
+    }
+    
+    expandSolution(x);
+    
+    solver.preconditioner().printHierarchy("AMG", *_log);
+    *_log << "Gradient conjugué + AMG: itérations = " << solver.iterations()
+         << ", erreur = " << solver.error()
+         << ", construction = " << setupTime << " s, résolution = " << solveTime << " s" << endl;
+    *_log << "Résolution terminée" << endl;
+}
+
+void Solver::solveGMG() {
+    if (_prolongations.empty()) {
+        cerr << "Attention : solveur gmg sans maillages emboîtés (refine = 0), utilisation de amg" << endl;
+        solveAMG();
+        return;
+    }
+    *_log << "Résolution (gradient conjugué + multigrille géométrique)..." << endl;
+    typedef std::chrono::high_resolution_clock Clock;
+    
+    // Prolongements sur les DDL, du plus fin au plus grossier. Le plus fin est restreint
+    // aux inconnues de _Kbc : lignes des DDL imposés annulées (relèvement) ou supprimées (réduction).
+    vector<SparseMatrix<double>> P;
+    for (int l = _prolongations.size() - 1; l >= 0; l--) P.push_back(dofProlongation(_prolongations[l]));
+    
+    int n = _Kbc.rows();
+    vector<Triplet<double>> select;
+    select.reserve(n);
+    for (int i = 0; i < n; i++) {
+        int g = _freeDofs.empty() ? i : _freeDofs[i];
+        if (_freeDofs.empty() && _dirichletBCs.count(g)) continue;
+        select.push_back(Triplet<double>(i, g, 1.0));
+    }
+    SparseMatrix<double> S(n, P[0].rows());
+    S.setFromTriplets(select.begin(), select.end());
+    P[0] = S * P[0];
+    
+    ConjugateGradient<SparseMatrix<double>, Lower|Upper, GeometricMultigrid> solver;
+    solver.setTolerance(1e-12);
+    solver.setMaxIterations(10000);
+    solver.preconditioner().setProlongations(P);
+    solver.preconditioner().setSmoother(_amgSmoother);
+    
+    auto t0 = Clock::now();
+    solver.compute(_Kbc);
+    auto t1 = Clock::now();
+    if (solver.info() != Success) {
+        cerr << "Erreur : échec de la construction de la hiérarchie multigrille" << endl;
+        return;
+    }
+    
+    VectorXd x = solver.solve(_rhs);
+    auto t2 = Clock::now();
+    double setupTime = std::chrono::duration<double>(t1 - t0).count();
+    double solveTime = std::chrono::duration<double>(t2 - t1).count();
+    
+    if (solver.info() != Success) {
+        cerr << "Erreur : le gradient conjugué préconditionné par multigrille n'a pas convergé" << endl;
+        cerr << "Itérations: " << solver.iterations() << ", erreur: " << solver.error() << endl;
+        return;
+    }
+    
+    expandSolution(x);
+    
+    solver.preconditioner().printHierarchy("GMG", *_log);
+    *_log << "Gradient conjugué + GMG: itérations = " << solver.iterations()
+         << ", erreur = " << solver.error()
+         << ", construction = " << setupTime << " s, résolution = " << solveTime << " s" << endl;
+    *_log << "Résolution terminée" << endl;
+}
+
+bool Solver::factorCholesky() {
+    // LDLt simplicial avec renumérotation AMD pour limiter le remplissage.
+    // L'analyse symbolique n'est refaite que si la structure change.
+    typedef std::chrono::high_resolution_clock Clock;
+    auto t0 = Clock::now();
+    if (!_ldlt || _ldlt->rows() != _Kbc.rows()) {
+        _ldlt.reset(new SimplicialLDLT<SparseMatrix<double>, Lower, AMDOrdering<int>>());
+        _ldlt->analyzePattern(_Kbc);
+    }
+    auto t1 = Clock::now();
+    _ldlt->factorize(_Kbc);
+    auto t2 = Clock::now();
+    _analyzeTime = std::chrono::duration<double>(t1 - t0).count();
+    _factorTime = std::chrono::duration<double>(t2 - t1).count();
+    _factorized = (_ldlt->info() == Success);
+    return _factorized;
+}
+
+MatrixXd Solver::solveMultiple(const MatrixXd& F, const MatrixXd& U0) {
+    int m = F.cols();
+    *_log << "Résolution de " << m << " cas de charge..." << endl;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    
+    // Valeurs imposées restreintes aux DDL de Dirichlet
+    MatrixXd Uc = MatrixXd::Zero(F.rows(), m);
+    for (const auto& disp : _dirichletBCs) Uc.row(disp.first) = U0.row(disp.first);
+    for (const auto& link : _periodicBCs) {
+        if (_dofMap.empty() || _dofMap[link.first] != _dofMap[link.second.first]) continue;
+        Uc.row(link.first) = U0.row(link.first);
+        if (_dirichletBCs.count(link.second.first)) Uc.row(link.first) += Uc.row(link.second.first);
+    }
+    
+    // Seconds membres relevés : F - K Uc
+    MatrixXd rhs = F - applyStiffness(Uc);
+    MatrixXd B;
+    if (!_dofMap.empty()) {
+        B = MatrixXd::Zero(_freeDofs.size(), m);
+        for (size_t i = 0; i < _dofMap.size(); i++) {
+            if (_dofMap[i] >= 0) B.row(_dofMap[i]) += rhs.row(i);
+        }
+    } else if (isMatrixFree() || _freeDofs.empty()) {
+        B = rhs;
+        for (const auto& disp : _dirichletBCs) B.row(disp.first) = Uc.row(disp.first);
+    } else {
+        B.resize(_freeDofs.size(), m);
+        for (size_t k = 0; k < _freeDofs.size(); k++) B.row(k) = rhs.row(_freeDofs[k]);
+    }
+    
+    MatrixXd X;
+    string method;
+    int iterations = 0;
+    if (isMatrixFree()) {
+        // Préconditionneur de Jacobi construit une fois, une résolution par colonne
+        method = "gradient conjugué sans matrice";
+        JacobiPreconditioner precond(_op->diagonal());
+        X = Uc;
+        for (int k = 0; k < m; k++) {
+            VectorXd x = X.col(k);
+            double error = 0.0;
+            iterations += conjugateGradient(*_op, precond, VectorXd(B.col(k)), x, 1e-12, 10000, error);
+            X.col(k) = x;
+        }
+    } else if (isBlockSparse()) {
+        method = "gradient conjugué BSR";
+        BlockJacobiPreconditioner precond(*_Kbbc);
+        X = Uc;
+        for (int k = 0; k < m; k++) {
+            VectorXd x = X.col(k);
+            double error = 0.0;
+            iterations += conjugateGradient(*_Kbbc, precond, VectorXd(B.col(k)), x, 1e-12, 10000, error);
+            X.col(k) = x;
+        }
+    } else if (_linearSolver == "cholesky") {
+        // Une factorisation, m descentes-remontées
+        method = "Cholesky LDLt";
+        if (!_factorized && !factorCholesky()) {
+            cerr << "Erreur : échec de la factorisation LDLt" << endl;
+            return Uc;
+        }
+        X = _ldlt->solve(B);
+    } else {
+        // Gradient conjugué par blocs avec un préconditionneur Incomplete Cholesky commun
+        method = "gradient conjugué par blocs";
+        if (!_factorized) {
+            _ic.reset(new IncompleteCholesky<double>());
+            _ic->compute(_Kbc);
+            _factorized = (_ic->info() == Success);
+        }
+        VectorXd errors;
+        iterations = blockConjugateGradient(_Kbc, *_ic, B, X, 1e-12, 10000, errors);
+        if (iterations < 0) {
+            // Bloc dégénéré : résolutions successives avec le même préconditionneur
+            cerr << "Attention : gradient conjugué par blocs dégénéré, résolution colonne par colonne" << endl;
+            iterations = 0;
+            X.resize(B.rows(), m);
+            for (int k = 0; k < m; k++) {
+                MatrixXd xk;
+                iterations += blockConjugateGradient(_Kbc, *_ic, MatrixXd(B.col(k)), xk, 1e-12, 10000, errors);
+                X.col(k) = xk;
+            }
+        }
+    }
+    
+    MatrixXd U;
+    if (!_dofMap.empty()) {
+        U = Uc;
+        for (size_t i = 0; i < _dofMap.size(); i++) {
+            if (_dofMap[i] >= 0) U.row(i) += X.row(_dofMap[i]);
+        }
+    } else if (isMatrixFree() || _freeDofs.empty()) {
+        U = X;
+    } else {
+        U = Uc;
+        for (size_t k = 0; k < _freeDofs.size(); k++) U.row(_freeDofs[k]) = X.row(k);
+    }
+    
+    auto t1 = std::chrono::high_resolution_clock::now();
+    *_log << "Résolution multiple (" << method << "): " << m << " cas";
+    if (iterations > 0) *_log << ", itérations = " << iterations;
+    *_log << ", temps = " << std::chrono::duration<double>(t1 - t0).count() << " s" << endl;
+    return U;
+}
+
+MatrixXd Solver::applyStiffness(const MatrixXd& U) const {
+    if (!isMatrixFree() && !isBlockSparse()) return _K * U;
+    
+    MatrixXd KU(U.rows(), U.cols());
+    VectorXd y;
+    for (int k = 0; k < U.cols(); k++) {
+        if (isBlockSparse()) _Kb->apply(U.col(k), y);
+        else _op->applyFull(U.col(k), y);
+        KU.col(k) = y;
+    }
+    return KU;
 }
 
 void Solver::saveResults(const string& filename) const {
@@ -136,19 +1000,90 @@ void Solver::saveResults(const string& filename) const {
     file << "# Résultats de la simulation FEM\n";
     file << "# NodeID X Y Ux Uy Unorm\n";
     
-    for (const auto& node : _mesh.nodes) {
-        double ux = _U(2*(node.id-1));
-        double uy = _U(2*(node.id-1)+1);
+    for (int i = 0; i < _mesh.nbNodes(); i++) {
+        double ux = _U(2*i);
+        double uy = _U(2*i+1);
         double unorm = sqrt(ux*ux + uy*uy);
-        file << node.id << " " << node.coords.x() << " " << node.coords.y() 
+        file << _mesh.slotToTag[i] << " " << _mesh.nodeX[i] << " " << _mesh.nodeY[i] 
              << " " << ux << " " << uy << " " << unorm << "\n";
     }
     
     file.close();
-    cout << "Résultats sauvegardés dans " << filename << endl;
+    *_log << "Résultats sauvegardés dans " << filename << endl;
+}
+
+void Solver::saveConvergence(const string& filename) const {
+    ofstream file(filename);
+    
+    if (!file.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << filename << endl;
+        return;
+    }
+    
+    file << "# Historique de convergence du gradient conjugué (" << _cgImplementation << ")\n";
+    file << "# Iteration Residu Temps(s)\n";
+    for (size_t k = 0; k < _history.residuals.size(); k++) {
+        file << k + 1 << " " << _history.residuals[k] << " " << _history.times[k] << "\n";
+    }
+    
+    file.close();
+    *_log << "Convergence sauvegardée dans " << filename << endl;
+}
+
+void Solver::saveVTU(const string& filename, int nbPieces) const {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    int nn = _mesh.nbNodes();
+    int ne = _mesh.nbElements();
+    
+    vector<double> displacement(3 * (size_t)nn, 0.0);
+    for (int i = 0; i < nn; i++) {
+        displacement[3*i] = _U(2*i);
+        displacement[3*i + 1] = _U(2*i + 1);
+    }
+    PostProcessor post(_mesh);
+    post.compute(_U);
+    post.recoverNodalFields();
+    
+    // Composantes xx, yy, xy entrelacées pour VTK
+    vector<double> strain(3 * (size_t)ne), stress(3 * (size_t)ne), nodalStress(3 * (size_t)nn);
+    for (int e = 0; e < ne; e++) {
+        strain[3*e] = post.strainXX[e];
+        strain[3*e + 1] = post.strainYY[e];
+        strain[3*e + 2] = post.strainXY[e];
+        stress[3*e] = post.stressXX[e];
+        stress[3*e + 1] = post.stressYY[e];
+        stress[3*e + 2] = post.stressXY[e];
+    }
+    for (int i = 0; i < nn; i++) {
+        nodalStress[3*i] = post.nodalStressXX[i];
+        nodalStress[3*i + 1] = post.nodalStressYY[i];
+        nodalStress[3*i + 2] = post.nodalStressXY[i];
+    }
+    vector<int> tags(ne);
+    for (int e = 0; e < ne; e++) tags[e] = _mesh.elementTag(e);
+    
+    VTUWriter writer(_mesh);
+    writer.addPointData("U", 3, displacement.data());
+    writer.addPointData("ContrainteNoeuds", 3, nodalStress.data());
+    writer.addPointData("VonMisesNoeuds", 1, post.nodalVonMises.data());
+    writer.addCellData("Materiau", tags);
+    writer.addCellData("Deformation", 3, strain.data());
+    writer.addCellData("Contrainte", 3, stress.data());
+    writer.addCellData("VonMises", 1, post.vonMises.data());
+    
+    bool ok = (nbPieces > 1) ? writer.writePieces(filename, nbPieces) : writer.write(filename);
+    if (!ok) {
+        cerr << "Erreur : échec de l'écriture de " << filename << endl;
+        return;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - t0;
+    *_log << "Fichier VTU sauvegardé: " << filename;
+    if (nbPieces > 1) *_log << " (" << nbPieces << " morceaux)";
+    *_log << " en " << elapsed.count() * 1e3 << " ms" << endl;
 }
 
 void Solver::saveVTK(const string& filename) const {
+    auto t0 = std::chrono::high_resolution_clock::now();
     ofstream file(filename);
     
     if (!file.is_open()) {
@@ -164,15 +1099,16 @@ void Solver::saveVTK(const string& filename) const {
     
     // Points
     file << "POINTS " << _mesh.nbNodes() << " float\n";
-    for (const auto& node : _mesh.nodes) {
-        file << node.coords.x() << " " << node.coords.y() << " 0.0\n";
+    for (int i = 0; i < _mesh.nbNodes(); i++) {
+        file << _mesh.nodeX[i] << " " << _mesh.nodeY[i] << " 0.0\n";
     }
     file << "\n";
     
     // Cellules (triangles)
     file << "CELLS " << _mesh.nbElements() << " " << (4 * _mesh.nbElements()) << "\n";
-    for (const auto& elem : _mesh.elements) {
-        file << "3 " << (elem.nodeIds[0]-1) << " " << (elem.nodeIds[1]-1) << " " << (elem.nodeIds[2]-1) << "\n";
+    for (int e = 0; e < _mesh.nbElements(); e++) {
+        const int32_t* nodes = _mesh.elementNodes(e);
+        file << "3 " << nodes[0] << " " << nodes[1] << " " << nodes[2] << "\n";
     }
     file << "\n";
     
@@ -188,10 +1124,11 @@ void Solver::saveVTK(const string& filename) const {
     
     // Vecteur déplacement
     file << "VECTORS U float\n";
-    for (const auto& node : _mesh.nodes) {
-        file << _U(2*(node.id-1)) << " " << _U(2*(node.id-1)+1) << " 0.0\n";
+    for (int i = 0; i < _mesh.nbNodes(); i++) {
+        file << _U(2*i) << " " << _U(2*i+1) << " 0.0\n";
     }
     
     file.close();
-    cout << "Fichier VTK sauvegardé: " << filename << endl;
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - t0;
+    *_log << "Fichier VTK sauvegardé: " << filename << " en " << elapsed.count() * 1e3 << " ms" << endl;
 }
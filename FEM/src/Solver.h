@@ -3,44 +3,165 @@
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/IterativeLinearSolvers>
+#ifdef FEM_USE_CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
+#include <iostream>
 #include "Mesh.h"
 #include "Material.h"
+#include "ElasticityOperator.h"
+#include "AMG.h"
+#include "Multigrid.h"
+#include "BlockSparseMatrix.h"
+#include "FusedCG.h"
 
 class Solver {
-    // Classe permettant de résoudre le système global KU=F avec la méthode du gradient conjugué.
+    // Classe permettant de résoudre le système global KU=F (gradient conjugué ou Cholesky creux).
     // Elle assemble également la matrice de rigidité globale K à partir des matrices élémentaires Ke (propre aux éléments)
     // Et applique les conditions aux limites sur le système.
 
     private:
         Mesh& _mesh;
         Eigen::VectorXd _U;
-        Eigen::SparseMatrix<double> _K;
-        Eigen::VectorXd _F;
+        Eigen::SparseMatrix<double> _K;      // rigidité assemblée, conservée intacte (réactions)
+        Eigen::VectorXd _F;                  // efforts extérieurs
+        
+        // Système contraint par les CL de Dirichlet
+        // "lifting"   : même taille que K, lignes/colonnes imposées remplacées par l'identité
+        // "reduction" : système réduit aux seuls DDL libres
+        std::string _bcMethod;
+        Eigen::SparseMatrix<double> _Kbc;
+        Eigen::VectorXd _rhs;
+        Eigen::VectorXd _u0;                 // valeurs imposées (0 sur les DDL libres)
+        std::vector<int> _freeDofs;          // indice réduit -> DDL global
         
         double _tol;
         int _maxIter;
         
+        // Mode de résolution : "assembled" (K globale) ou "matrix_free" (K·u élément par élément)
+        std::string _mode;
+        std::unique_ptr<ElasticityOperator> _op;
+        
+        // Solveur linéaire du mode assemblé : "cg" (gradient conjugué), "cholesky" (LDLt creux)
+        // "amg" ou "gmg" (gradient conjugué préconditionné par multigrille algébrique ou géométrique)
+        std::string _linearSolver;
+        std::string _amgSmoother;
+        // Format de la matrice assemblée : "csr" (Eigen) ou "bsr" (blocs 2x2 nodaux, gradient
+        // conjugué + Jacobi par blocs). En "bsr", K n'existe qu'en blocs et les CL sont relevées.
+        std::string _matrixFormat;
+        std::unique_ptr<BlockSparseMatrix> _Kb, _Kbbc;
+        
+        // Précision du gradient conjugué : "double" ou "mixed" (facteur IC stocké en float,
+        // K et vecteurs en double, résidu vrai remplacé à chaque décade : mises à jour fiables)
+        std::string _precision;
+        
+        // Implémentation du gradient conjugué (solver = cg, précision double) : "eigen"
+        // (ConjugateGradient + IC), "fused" ou "pipelined" (Jacobi, une seule région parallèle)
+        std::string _cgImplementation;
+        ConvergenceHistory _history;
+        
+        // Prolongements nodaux des maillages emboîtés, du plus grossier au plus fin (solveur "gmg")
+        std::vector<Eigen::SparseMatrix<double>> _prolongations;
+        std::unique_ptr<Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower, Eigen::AMDOrdering<int>>> _ldlt;
+#ifdef FEM_USE_CHOLMOD
+        std::unique_ptr<Eigen::CholmodSupernodalLLT<Eigen::SparseMatrix<double>, Eigen::Lower>> _cholmod;
+#endif
+        // Préconditionneur du gradient conjugué par blocs, conservé tant que _Kbc ne change pas
+        std::unique_ptr<Eigen::IncompleteCholesky<double>> _ic;
+        bool _factorized;  // _ldlt ou _ic à jour pour _Kbc
+        double _analyzeTime, _factorTime;
+        
+        bool factorCholesky();
+        
+        // Assemblage symbolique : structure de K calculée une fois à partir de la connectivité,
+        // puis position dans _K.valuePtr() de chacun des 36 coefficients de chaque Ke
+        std::vector<int> _scatter;
+        Eigen::Index _patternNnz;
+        
         // Conditions aux limites
         std::map<int, double> _dirichletBCs; // globalDof -> prescribed displacement
         std::map<int, double> _neumannBCs; // globalDof -> applied force
         
+        // Périodicité : DDL esclave -> (DDL maître, décalage), u_esclave = u_maître + décalage.
+        // Les esclaves sont éliminés : chaque DDL global pointe vers l'inconnue réduite de son
+        // maître (-1 si imposé), K réduite = T^T K T
+        std::map<int, std::pair<int, double>> _periodicBCs;
+        std::vector<int> _dofMap;
+        
+        // Messages de résolution (std::cout par défaut)
+        std::ostream* _log;
+        
     public:
         Solver(Mesh& mesh, double tolerance = 1e-6, int maxIterations = 1000);
 
+        void setSolverMode(const std::string& mode);
+        void setBCMethod(const std::string& method);
+        void setLinearSolver(const std::string& solver);
+        void setAMGSmoother(const std::string& smoother) { _amgSmoother = smoother; }
+        void setProlongations(const std::vector<Eigen::SparseMatrix<double>>& prolongations) { _prolongations = prolongations; }
+        void setMatrixFormat(const std::string& format);
+        void setPrecision(const std::string& precision);
+        void setCGImplementation(const std::string& implementation);
+        // Flux des messages (nullptr : std::cout), par exemple un tampon propre à chaque thread
+        void setLog(std::ostream* log) { _log = log ? log : &std::cout; }
+        bool isMatrixFree() const { return _mode == "matrix_free"; }
+        bool isBlockSparse() const { return !isMatrixFree() && _matrixFormat == "bsr"; }
+        
         void assemble();
+        void symbolicAssembly();
+        void numericAssembly();
         void applyBC();
+        void applyLifting(const std::vector<char>& constrained);
+        void applyReduction(const std::vector<char>& constrained);
+        void applyPeriodic(const std::vector<char>& constrained);
+        void expandSolution(const Eigen::VectorXd& x);
+        void solve();
         void solveConjugateGradient(); 
+        void solveMixedPrecision();
+        void solveFusedCG();
+        void solveMatrixFree();
+        void solveCholesky();
+        void solveAMG();
+        void solveGMG();
+        void solveBlockCG();
+        
+        // Plusieurs cas de charge sur le même système. Chaque colonne de F contient des efforts
+        // extérieurs, chaque colonne de U0 les valeurs imposées sur les DDL déclarés par setDirichletBC
+        // et les décalages des DDL esclaves déclarés par setPeriodicBC (applyBC doit avoir été appelé).
+        // La factorisation ou le préconditionneur n'est calculé qu'une fois. Retourne les
+        // déplacements, une colonne par cas.
+        Eigen::MatrixXd solveMultiple(const Eigen::MatrixXd& F, const Eigen::MatrixXd& U0);
+        void printMemory() const;
         
-        // Méthodes pour définir les CL
-        void setDirichletBC(int nodeId, int dof, double value);
-        void setNeumannBC(int nodeId, int dof, double value);
+        // Méthodes pour définir les CL. Retournent false (message sur cerr, CL rejetée) si un
+        // tag de noeud n'existe pas dans le maillage.
+        bool setDirichletBC(int nodeId, int dof, double value);
+        bool setNeumannBC(int nodeId, int dof, double value);
+        // u(slaveId) = u(masterId) + offset sur la composante dof (mode assemblé, format csr).
+        // Le maître ne doit pas être lui-même esclave.
+        bool setPeriodicBC(int slaveId, int masterId, int dof, double offset);
         void clearBCs();
         
         Eigen::VectorXd getU() const { return _U; }
+        Eigen::VectorXd computeReactions() const;
+        Eigen::MatrixXd applyStiffness(const Eigen::MatrixXd& U) const;  // K U sur le système complet
         void saveResults(const std::string& filename) const;
         void saveVTK(const std::string& filename) const;
+        
+        // Sortie VTU binaire : déplacements, contrainte et von Mises lissés aux noeuds, tag de
+        // matériau, déformation, contrainte et von Mises par élément (PostProcessor).
+        // nbPieces > 1 : morceaux écrits en parallèle + index .pvtu
+        void saveVTU(const std::string& filename, int nbPieces = 1) const;
+        
+        // Historique du dernier gradient conjugué fusionné ou pipeliné (vide sinon)
+        const ConvergenceHistory& convergenceHistory() const { return _history; }
+        void saveConvergence(const std::string& filename) const;
 };
 
 #endif
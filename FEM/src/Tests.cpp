@@ -3,42 +3,318 @@
 #include "Material.h"
 #include "Solver.h"
 #include "MeshReader.h"
+#include "MeshRefinement.h"
+#include "BlockSparseMatrix.h"
+#include "PostProcessor.h"
+#include "PeriodicBC.h"
+#include "Parallel.h"
+#include "MeshCache.h"
+#include "FiberLayout.h"
+#include "RVEMesher.h"
+#include "FiberDetector.h"
+#include "FFTHomogenization.h"
+#include "PixelGridSolver.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <memory>
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 
 using namespace std;
 
-void runTractionTest(const string& meshFile, const Config& config) {
-    cout << "=== Test de Traction Simple ===" << endl;
-    cout << "Maillage: " << meshFile << endl;
+// Flux des messages du thread courant (std::cout par défaut) et cache de maillages partagé
+static thread_local ostream* testOutput = nullptr;
+static MeshCache* sharedMeshes = nullptr;
+
+static ostream& out() {
+    return testOutput ? *testOutput : cout;
+}
+
+void setTestOutput(ostream* output) {
+    testOutput = output;
+}
+
+void setMeshCache(MeshCache* cache) {
+    sharedMeshes = cache;
+}
+
+static DetectorOptions detectorOptions(const Config& config) {
+    DetectorOptions options;
+    options.blurSigma = config.detectBlur;
+    options.minRadius = config.detectMinRadius;
+    options.maxRadius = config.detectMaxRadius;
+    options.minDist = config.detectMinDist;
+    options.edgeThreshold = config.detectEdgeThreshold;
+    options.voteThreshold = config.detectVoteThreshold;
+    return options;
+}
+
+// Détection dans une image, validée sur config.detectReference s'il est fourni : centres à
+// moins de 0.2 rayon des cercles de référence. Retourne false (message sur cerr) si la
+// fraction retrouvée est inférieure à config.detectMinRecall.
+static bool detectFibersChecked(const GrayImage& image, const Config& config, vector<Fiber>& fibers) {
+    fibers = detectFibers(image, detectorOptions(config), out());
+    if (config.detectReference.empty()) return true;
+    vector<Fiber> reference = readFibers(config.detectReference);
+    if (reference.empty()) {
+        cerr << "Erreur : aucun cercle de référence lu dans " << config.detectReference << endl;
+        return false;
+    }
+    double recall = detectionRecall(fibers, reference, 0.2);
+    out() << "Validation : " << 100.0 * recall << " % des " << reference.size() << " cercles de "
+          << config.detectReference << " retrouvés (minimum " << 100.0 * config.detectMinRecall << " %)" << endl;
+    if (recall < config.detectMinRecall) {
+        cerr << "Erreur : détection insuffisante sur l'image de référence, ajuster les paramètres detect_*" << endl;
+        return false;
+    }
+    return true;
+}
+
+// Fibres détectées dans config.meshImage ou lues dans config.meshCircles, axe y des images
+// inversé (comme Preprocessing/maillage.py), et rectangle englobant élargi de la marge.
+// Retourne false (message sur cerr) si aucune fibre n'est disponible.
+static bool loadFibers(const Config& config, vector<Fiber>& fibers, double& xmin, double& ymin, double& xmax, double& ymax) {
+    if (!config.meshImage.empty()) {
+        GrayImage image;
+        if (!readImage(config.meshImage, image) || !detectFibersChecked(image, config, fibers)) return false;
+    } else {
+        fibers = readFibers(config.meshCircles);
+    }
+    if (fibers.empty()) {
+        cerr << "Erreur : aucune fibre lue dans " << (config.meshImage.empty() ? config.meshCircles : config.meshImage) << endl;
+        return false;
+    }
+    flipFiberAxis(fibers);
+    xmin = ymin = 1e300;
+    xmax = ymax = -1e300;
+    for (const Fiber& f : fibers) {
+        xmin = min(xmin, f.x - f.r);
+        xmax = max(xmax, f.x + f.r);
+        ymin = min(ymin, f.y - f.r);
+        ymax = max(ymax, f.y + f.r);
+    }
+    double m = config.meshMargin;
+    xmin -= m;
+    ymin -= m;
+    xmax += m;
+    ymax += m;
+    return true;
+}
+
+// Maillage généré à partir des fibres de loadFibers. Retourne false (message sur cerr) en cas d'échec.
+static bool generateMesh(Mesh& mesh, const Config& config, const map<int, Material*>& materials) {
+    vector<Fiber> fibers;
+    double xmin, ymin, xmax, ymax;
+    if (!loadFibers(config, fibers, xmin, ymin, xmax, ymax)) return false;
+
+    MesherOptions options;
+    options.sizeInterface = config.meshSizeInterface;
+    options.sizeMax = config.meshSizeMax;
+    options.grading = config.meshGrading;
+    options.minAngle = config.meshMinAngle;
+    options.periodic = config.meshPeriodic || config.homogenizationBC == "periodic";
+    auto material = [&](int tag) {
+        map<int, Material*>::const_iterator it = materials.find(tag);
+        return it != materials.end() ? it->second : nullptr;
+    };
+    return meshFiberRVE(mesh, fibers, xmin, ymin, xmax, ymax, options, material(1), material(2), out());
+}
+
+// Lecture ou génération du maillage (ou copie depuis le cache partagé) puis refine raffinements uniformes,
+// prolongements des niveaux dans prolongations. Le maillage reste à initialiser (initializeElements,
+// computeGeometry). Retourne false (message sur cerr) si le maillage n'a pu être lu ou généré.
+static bool loadMesh(Mesh& mesh, const string& meshFile, int refine, const Config& config,
+                     const map<int, Material*>& materials, vector<Eigen::SparseMatrix<double>>& prolongations) {
+    if (!config.meshImage.empty() || !config.meshCircles.empty()) {
+        if (!generateMesh(mesh, config, materials)) return false;
+        prolongations = refineUniform(mesh, refine, out());
+        return true;
+    }
+    if (sharedMeshes) {
+        bool hit = false;
+        if (!sharedMeshes->get(meshFile, refine, config.meshCache, materials, mesh, prolongations, hit, out())) return false;
+        if (hit) out() << "Maillage repris du cache partagé" << endl;
+        return true;
+    }
+    
+    MeshReader reader(&mesh);
+    reader.setLog(&out());
+    reader.setSnapshotCache(config.meshCache);
+    for (const auto& m : materials) reader.setMaterial(m.first, m.second);
+    if (!reader.readGmshFile(meshFile)) return false;
+    prolongations = refineUniform(mesh, refine, out());
+    return true;
+}
+
+// Image de phases des solveurs sur pixels : micrographie seuillée, cercles pixellisés ou
+// maillage pixellisé, aux dimensions adaptées au solveur (sizing). stiffness reçoit la matrice
+// C de chaque phase, fiberPhase l'indice de la phase fibre (-1 si absente). Retourne false
+// (message sur cerr) en cas d'échec.
+static bool buildPhaseMap(const string& meshFile, const Config& config, PixelSizing sizing, Material& matrix,
+                          Material& fiber, PhaseMap& phases, vector<Eigen::Matrix3d>& stiffness, int& fiberPhase) {
+    stiffness = {matrix.getC(), fiber.getC()};
+    fiberPhase = 1;
+    if (config.fftPhases == "threshold") {
+        if (config.meshImage.empty()) {
+            cerr << "Erreur : fft_phases = threshold nécessite mesh_image" << endl;
+            return false;
+        }
+        GrayImage image;
+        if (!readImage(config.meshImage, image)) return false;
+        int threshold;
+        phases = thresholdImage(image, config.fftThreshold, config.fftFiberDark, &threshold, sizing);
+        out() << "Seuillage de l'image au niveau " << threshold << endl;
+    } else if (!config.meshImage.empty() || !config.meshCircles.empty()) {
+        vector<Fiber> fibers;
+        double xmin, ymin, xmax, ymax;
+        if (!loadFibers(config, fibers, xmin, ymin, xmax, ymax)) return false;
+        phases = rasterizeFibers(fibers, xmin, ymin, xmax, ymax, config.fftResolution, sizing);
+    } else {
+        Mesh mesh;
+        vector<Eigen::SparseMatrix<double>> prolongations;
+        if (!loadMesh(mesh, meshFile, 0, config, {{1, &matrix}, {2, &fiber}}, prolongations)) return false;
+        mesh.initializeElements();
+        mesh.computeGeometry();
+        phases = rasterizeMesh(mesh, config.fftResolution, sizing);
+        stiffness.clear();
+        fiberPhase = -1;
+        for (size_t p = 0; p < mesh.materials.size(); p++) {
+            stiffness.push_back(mesh.materials[p]->getC());
+            if (mesh.materials[p] == &fiber) fiberPhase = p;
+        }
+    }
+    return true;
+}
+
+// Tenseur de rigidité effectif et constantes de l'ingénieur (homogénéisation)
+static void effectiveProperties(const Eigen::Matrix3d& C_eff, TestResults& results) {
+    Eigen::Matrix3d S_eff = C_eff.inverse();
+    
+    out() << "\n=== Tenseur de rigidité effectif (Voigt, GPa) ===" << endl;
+    out() << C_eff / 1e9 << endl;
+    
+    out() << "\n=== Propriétés effectives du composite ===" << endl;
+    out() << "  E_x effectif : " << 1.0 / S_eff(0, 0) / 1e9 << " GPa" << endl;
+    out() << "  E_y effectif : " << 1.0 / S_eff(1, 1) / 1e9 << " GPa" << endl;
+    out() << "  G_xy effectif : " << 1.0 / S_eff(2, 2) / 1e9 << " GPa" << endl;
+    out() << "  ν_xy effectif : " << -S_eff(0, 1) / S_eff(0, 0) << endl;
+    
+    results["E_x"] = 1.0 / S_eff(0, 0);
+    results["E_y"] = 1.0 / S_eff(1, 1);
+    results["G_xy"] = 1.0 / S_eff(2, 2);
+    results["nu_xy"] = -S_eff(0, 1) / S_eff(0, 0);
+}
+
+// Champs de résultats pour la visualisation, au format choisi dans la configuration
+static void saveFields(const Solver& solver, const Config& config) {
+    string base = config.outputDir + "/results_" + config.outputFilePrefix;
+    if (config.outputFormat == "vtu") {
+        solver.saveVTU(base + (config.outputPieces > 1 ? ".pvtu" : ".vtu"), config.outputPieces);
+    } else {
+        if (config.outputFormat != "vtk") {
+            cerr << "Attention : format de sortie inconnu '" << config.outputFormat << "', utilisation de 'vtk'" << endl;
+        }
+        solver.saveVTK(base + ".vtk");
+    }
+}
+
+// Essai de traction du composite : encastrement à gauche (ux = 0, uy = 0 sur l'axe médian),
+// effort totalForce réparti à droite au prorata de la longueur attribuée à chaque noeud
+static void applyCompositeLoads(Solver& solver, const Mesh& mesh, double totalForce) {
+    for (int id : mesh.leftNodes) solver.setDirichletBC(id, 0, 0.0);
+    for (int id : mesh.findNodesAtY((mesh.yMin + mesh.yMax) / 2.0)) solver.setDirichletBC(id, 1, 0.0);
+    
+    // Force répartie à droite
+    vector<pair<int, double>> rightNodesY;
+    for (int id : mesh.rightNodes) {
+        rightNodesY.push_back({id, mesh.nodeCoords(mesh.nodeSlot(id)).y()});
+    }
+    sort(rightNodesY.begin(), rightNodesY.end(), 
+         [](const pair<int,double>& a, const pair<int,double>& b) { return a.second < b.second; });
+    
+    for (size_t i = 0; i < rightNodesY.size(); i++) {
+        double len;
+        if (i == 0) {
+            len = (rightNodesY[1].second - rightNodesY[0].second) / 2.0;
+        } else if (i == rightNodesY.size() - 1) {
+            len = (rightNodesY[i].second - rightNodesY[i-1].second) / 2.0;
+        } else {
+            len = (rightNodesY[i+1].second - rightNodesY[i-1].second) / 2.0;
+        }
+        solver.setNeumannBC(rightNodesY[i].first, 0, totalForce * len / mesh.height());
+    }
+}
+
+// Réponse moyenne de l'essai : allongement du bord droit, contraction des bords haut et bas,
+// module et coefficient de Poisson apparents (épaisseur unité)
+struct CompositeResponse {
+    double ux, uy;
+    double epsilonX, epsilonY;
+    double E_eff, nu_eff;
+};
+
+static CompositeResponse compositeResponse(const Mesh& mesh, const Eigen::VectorXd& U, double totalForce) {
+    auto calcDisp = [&](const vector<int>& nodes, int dof) {
+        double sum = 0;
+        for (int id : nodes) sum += U(mesh.dof(id, dof));
+        return sum / nodes.size();
+    };
+    
+    CompositeResponse r;
+    r.ux = calcDisp(mesh.rightNodes, 0);
+    r.uy = (abs(calcDisp(mesh.topNodes, 1)) + abs(calcDisp(mesh.bottomNodes, 1))) / 2.0;
+    r.epsilonX = r.ux / mesh.width();
+    r.epsilonY = -r.uy / (mesh.height() / 2.0);
+    r.E_eff = (totalForce / mesh.height()) / r.epsilonX;
+    r.nu_eff = -r.epsilonY / r.epsilonX;
+    return r;
+}
+
+TestResults runTractionTest(const string& meshFile, const Config& config) {
+    out() << "=== Test de Traction Simple ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
     
     Material material(config.E, config.nu, config.rho);
     
     Mesh mesh;
-    MeshReader reader(&mesh);
-    reader.setMaterial(1, &material);
-    reader.readGmshFile(meshFile);
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &material}}, prolongations)) return results;
+    mesh.keepElementMatrices = config.elementMatrixCache;
     mesh.initializeElements();
     mesh.computeGeometry();
     
-    cout << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
-    cout << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
+    out() << "Mémoire maillage: " << mesh.memoryUsage() / 1024.0 << " Ko" << endl;
+    out() << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
     
     // Résolution
     Solver solver(mesh);
+    solver.setLog(&out());
+    solver.setSolverMode(config.solverMode);
+    solver.setBCMethod(config.bcMethod);
+    solver.setLinearSolver(config.linearSolver);
+    solver.setAMGSmoother(config.amgSmoother);
+    solver.setProlongations(prolongations);
+    solver.setMatrixFormat(config.matrixFormat);
+    solver.setPrecision(config.precision);
+    solver.setCGImplementation(config.cgImplementation);
     solver.assemble();
     
     // CL: encastrement à gauche, force à droite
     for (int id : mesh.leftNodes) solver.setDirichletBC(id, 0, 0.0);
-    for (int id : mesh.findNodesAtY(mesh.yMax / 2.0)) solver.setDirichletBC(id, 1, 0.0);
+    for (int id : mesh.findNodesAtY((mesh.yMin + mesh.yMax) / 2.0)) solver.setDirichletBC(id, 1, 0.0);
     
     // Force répartie à droite
     vector<pair<int, double>> rightNodesY;
     for (int id : mesh.rightNodes) {
-        rightNodesY.push_back({id, mesh.getNode(id).coords.y()});
+        rightNodesY.push_back({id, mesh.nodeCoords(mesh.nodeSlot(id)).y()});
     }
     sort(rightNodesY.begin(), rightNodesY.end(), 
          [](const pair<int,double>& a, const pair<int,double>& b) { return a.second < b.second; });
@@ -57,15 +333,22 @@ void runTractionTest(const string& meshFile, const Config& config) {
     }
     
     solver.applyBC();
-    solver.solveConjugateGradient();
+    solver.solve();
     solver.saveResults(config.outputDir + "/displacement_" + config.outputFilePrefix + ".txt");
-    solver.saveVTK(config.outputDir + "/results_" + config.outputFilePrefix + ".vtk");
+    saveFields(solver, config);
+    if (!solver.convergenceHistory().residuals.empty()) {
+        solver.saveConvergence(config.outputDir + "/convergence_" + config.outputFilePrefix + ".txt");
+    }
     
     // Validation avec résultats théoriques
     Eigen::VectorXd U = solver.getU();
+    Eigen::VectorXd R = solver.computeReactions();
+    double reactionX = 0;
+    for (int id : mesh.leftNodes) reactionX += R(mesh.dof(id, 0));
+    
     auto calcDisp = [&](const vector<int>& nodes, int dof) {
         double sum = 0;
-        for (int id : nodes) sum += U(2*(id-1) + dof);
+        for (int id : nodes) sum += U(mesh.dof(id, dof));
         return sum / nodes.size();
     };
     
@@ -77,30 +360,48 @@ void runTractionTest(const string& meshFile, const Config& config) {
     double ux_theo = totalForce * L / (A * config.E);
     double uy_theo = config.nu * totalForce * mesh.height() / (2.0 * A * config.E);
     
-    cout << "\n=== Résultats ===" << endl;
-    cout << "Allongement x: " << ux << " m (théo: " << ux_theo << ", erreur: " 
-         << abs(ux-ux_theo)/ux_theo*100 << "%)" << endl;
-    cout << "Contraction y: " << uy << " m (théo: " << uy_theo << ", erreur: " 
-         << abs(uy-uy_theo)/uy_theo*100 << "%)" << endl;
+    out() << "\n=== Résultats ===" << endl;
+    out() << "Allongement x: " << ux << " m (théo: " << ux_theo << ", erreur: " 
+           << abs(ux-ux_theo)/ux_theo*100 << "%)" << endl;
+    out() << "Contraction y: " << uy << " m (théo: " << uy_theo << ", erreur: " 
+           << abs(uy-uy_theo)/uy_theo*100 << "%)" << endl;
+    out() << "Réaction à gauche x: " << reactionX << " N (force appliquée: " << totalForce << " N)" << endl;
+    
+    results["ux"] = ux;
+    results["uy"] = uy;
+    results["ux_theo"] = ux_theo;
+    results["reaction_x"] = reactionX;
+    return results;
 }
 
-void runFlexionTest(const string& meshFile, const Config& config) {
-    cout << "=== Test de Flexion (force ponctuelle) ===" << endl;
-    cout << "Maillage: " << meshFile << endl;
+TestResults runFlexionTest(const string& meshFile, const Config& config) {
+    out() << "=== Test de Flexion (force ponctuelle) ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
     
     Material material(config.E, config.nu, config.rho);
     
     Mesh mesh;
-    MeshReader reader(&mesh);
-    reader.setMaterial(1, &material);
-    reader.readGmshFile(meshFile);
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &material}}, prolongations)) return results;
+    mesh.keepElementMatrices = config.elementMatrixCache;
     mesh.initializeElements();
     mesh.computeGeometry();
     
-    cout << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
-    cout << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
+    out() << "Mémoire maillage: " << mesh.memoryUsage() / 1024.0 << " Ko" << endl;
+    out() << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
     
     Solver solver(mesh);
+    solver.setLog(&out());
+    solver.setSolverMode(config.solverMode);
+    solver.setBCMethod(config.bcMethod);
+    solver.setLinearSolver(config.linearSolver);
+    solver.setAMGSmoother(config.amgSmoother);
+    solver.setProlongations(prolongations);
+    solver.setMatrixFormat(config.matrixFormat);
+    solver.setPrecision(config.precision);
+    solver.setCGImplementation(config.cgImplementation);
     solver.assemble();
     
     // Encastrement complet à gauche
@@ -111,11 +412,11 @@ void runFlexionTest(const string& meshFile, const Config& config) {
     
     // Force ponctuelle à l'extrémité droite (au milieu en hauteur)
     int nodeForce = -1;
-    double targetY = mesh.yMax / 2.0;
+    double targetY = (mesh.yMin + mesh.yMax) / 2.0;
     double minDist = 1e10;
     
     for (int id : mesh.rightNodes) {
-        double dist = abs(mesh.getNode(id).coords.y() - targetY);
+        double dist = abs(mesh.nodeCoords(mesh.nodeSlot(id)).y() - targetY);
         if (dist < minDist) {
             minDist = dist;
             nodeForce = id;
@@ -126,13 +427,16 @@ void runFlexionTest(const string& meshFile, const Config& config) {
     solver.setNeumannBC(nodeForce, 1, F);
     
     solver.applyBC();
-    solver.solveConjugateGradient();
+    solver.solve();
     solver.saveResults(config.outputDir + "/displacement_" + config.outputFilePrefix + ".txt");
-    solver.saveVTK(config.outputDir + "/results_" + config.outputFilePrefix + ".vtk");
+    saveFields(solver, config);
+    if (!solver.convergenceHistory().residuals.empty()) {
+        solver.saveConvergence(config.outputDir + "/convergence_" + config.outputFilePrefix + ".txt");
+    }
     
     // Flèche au point d'application de la force
     Eigen::VectorXd U = solver.getU();
-    double fleche = abs(U(2*(nodeForce-1) + 1));
+    double fleche = abs(U(mesh.dof(nodeForce, 1)));
     
     // Flèche théorique poutre encastrée avec force ponctuelle à l'extrémité:
     // ymax = (F × L³) / (3 × E × I)
@@ -141,15 +445,20 @@ void runFlexionTest(const string& meshFile, const Config& config) {
     double I = (1.0 * h * h * h) / 12.0;
     double fleche_theo = (abs(F) * L * L * L) / (3.0 * config.E * I);
     
-    cout << "\n=== Résultats ===" << endl;
-    cout << "Flèche à l'extrémité: " << fleche << " m" << endl;
-    cout << "Flèche théorique: " << fleche_theo << " m" << endl;
-    cout << "Erreur relative: " << abs(fleche - fleche_theo) / fleche_theo * 100 << "%" << endl;
+    out() << "\n=== Résultats ===" << endl;
+    out() << "Flèche à l'extrémité: " << fleche << " m" << endl;
+    out() << "Flèche théorique: " << fleche_theo << " m" << endl;
+    out() << "Erreur relative: " << abs(fleche - fleche_theo) / fleche_theo * 100 << "%" << endl;
+    
+    results["fleche"] = fleche;
+    results["fleche_theo"] = fleche_theo;
+    return results;
 }
 
-void runCompositeTest(const string& meshFile, const Config& config) {
-    cout << "=== Test Composite (matrice + fibre) ===" << endl;
-    cout << "Maillage: " << meshFile << endl;
+TestResults runCompositeTest(const string& meshFile, const Config& config) {
+    out() << "=== Test Composite (matrice + fibre) ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
     
     // Créer les deux matériaux
     Material matrix(config.E, config.nu, config.rho);
@@ -157,90 +466,684 @@ void runCompositeTest(const string& meshFile, const Config& config) {
     
     // Charger le maillage
     Mesh mesh;
-    MeshReader reader(&mesh);
-    reader.setMaterial(1, &matrix);  // Matériau 1 = matrice
-    reader.setMaterial(2, &fiber);   // Matériau 2 = fibre
-    reader.readGmshFile(meshFile);
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &matrix}, {2, &fiber}}, prolongations)) return results;
+    mesh.keepElementMatrices = config.elementMatrixCache;
     mesh.initializeElements();
     mesh.computeGeometry();
     
-    cout << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
-    cout << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
+    out() << "Mémoire maillage: " << mesh.memoryUsage() / 1024.0 << " Ko" << endl;
+    out() << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
     
     // Résolution
     Solver solver(mesh);
+    solver.setLog(&out());
+    solver.setSolverMode(config.solverMode);
+    solver.setBCMethod(config.bcMethod);
+    solver.setLinearSolver(config.linearSolver);
+    solver.setAMGSmoother(config.amgSmoother);
+    solver.setProlongations(prolongations);
+    solver.setMatrixFormat(config.matrixFormat);
+    solver.setPrecision(config.precision);
+    solver.setCGImplementation(config.cgImplementation);
     solver.assemble();
     
     // Conditions aux limites: encastrement à gauche, force à droite
-    for (int id : mesh.leftNodes) solver.setDirichletBC(id, 0, 0.0);
-    for (int id : mesh.findNodesAtY(mesh.yMax / 2.0)) solver.setDirichletBC(id, 1, 0.0);
+    double totalForce = config.forceValue;
+    applyCompositeLoads(solver, mesh, totalForce);
     
-    // Force répartie à droite
-    vector<pair<int, double>> rightNodesY;
-    for (int id : mesh.rightNodes) {
-        rightNodesY.push_back({id, mesh.getNode(id).coords.y()});
+    solver.applyBC();
+    solver.solve();
+    solver.saveResults(config.outputDir + "/displacement_" + config.outputFilePrefix + ".txt");
+    saveFields(solver, config);
+    if (!solver.convergenceHistory().residuals.empty()) {
+        solver.saveConvergence(config.outputDir + "/convergence_" + config.outputFilePrefix + ".txt");
     }
-    sort(rightNodesY.begin(), rightNodesY.end(), 
-         [](const pair<int,double>& a, const pair<int,double>& b) { return a.second < b.second; });
     
-    double totalForce = config.forceValue;
-    for (size_t i = 0; i < rightNodesY.size(); i++) {
-        double len;
-        if (i == 0) {
-            len = (rightNodesY[1].second - rightNodesY[0].second) / 2.0;
-        } else if (i == rightNodesY.size() - 1) {
-            len = (rightNodesY[i].second - rightNodesY[i-1].second) / 2.0;
-        } else {
-            len = (rightNodesY[i+1].second - rightNodesY[i-1].second) / 2.0;
+    // Résultats
+    Eigen::VectorXd U = solver.getU();
+    Eigen::VectorXd R = solver.computeReactions();
+    double reactionX = 0;
+    for (int id : mesh.leftNodes) reactionX += R(mesh.dof(id, 0));
+    
+    CompositeResponse response = compositeResponse(mesh, U, totalForce);
+    double ux = response.ux, uy = response.uy;
+    double epsilon_x = response.epsilonX, epsilon_y = response.epsilonY;
+    double E_eff = response.E_eff, nu_eff = response.nu_eff;
+    
+    out() << "\n=== Résultats ===" << endl;
+    out() << "Déplacements :" << endl;
+    out() << "  Allongement moyen x : " << ux << " m (" << epsilon_x*100 << "%)" << endl;
+    out() << "  Contraction moyenne y : " << uy << " m (" << epsilon_y*100 << "%)" << endl;
+    out() << "  Réaction à gauche x : " << reactionX << " N" << endl;
+    
+    out() << "\n=== Propriétés effectives du composite ===" << endl;
+    out() << "  Module de Young effectif (E_eff) : " << E_eff/1e9 << " GPa" << endl;
+    out() << "  Coefficient de Poisson effectif (ν_eff) : " << nu_eff << endl;
+    
+    // Comparaison avec la matrice pure
+    out() << "\nComparaison avec matrice pure :" << endl;
+    out() << "  E_eff/E_matrix: " << E_eff/config.E << " (rigidification)" << endl;
+    out() << "  ν_eff - ν_matrix: " << (nu_eff - config.nu) << endl;
+    
+    results["E_eff"] = E_eff;
+    results["nu_eff"] = nu_eff;
+    return results;
+}
+
+TestResults runHomogenizationTest(const string& meshFile, const Config& config) {
+    out() << "=== Homogénéisation (3 cas de charge) ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
+    
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
+    
+    Mesh mesh;
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &matrix}, {2, &fiber}}, prolongations)) return results;
+    mesh.keepElementMatrices = config.elementMatrixCache;
+    mesh.initializeElements();
+    mesh.computeGeometry();
+    
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
+    out() << "Dimensions: " << mesh.width() << " x " << mesh.height() << " m\n" << endl;
+    
+    Solver solver(mesh);
+    solver.setLog(&out());
+    solver.setSolverMode(config.solverMode);
+    solver.setBCMethod(config.bcMethod);
+    solver.setLinearSolver(config.linearSolver);
+    solver.setAMGSmoother(config.amgSmoother);
+    solver.setProlongations(prolongations);
+    solver.setMatrixFormat(config.matrixFormat);
+    solver.setPrecision(config.precision);
+    solver.setCGImplementation(config.cgImplementation);
+    solver.assemble();
+    
+    // Trois déformations macroscopiques (notation de Voigt, glissement γ12)
+    double eps = 1e-3;
+    int n = mesh.nbDofs();
+    Eigen::MatrixXd F = Eigen::MatrixXd::Zero(n, 3);
+    Eigen::MatrixXd U0 = Eigen::MatrixXd::Zero(n, 3);
+    Eigen::Matrix3d C_eff;
+    
+    if (config.homogenizationBC == "periodic") {
+        // Fluctuations périodiques : u(esclave) = u(maître) + E (x_esclave - x_maître),
+        // coin de référence bloqué. Les décalages de chaque cas sont passés dans U0.
+        if (solver.isMatrixFree() || solver.isBlockSparse()) {
+            cerr << "Erreur : CL périodiques disponibles en mode assemblé, format csr uniquement" << endl;
+            return results;
         }
-        solver.setNeumannBC(rightNodesY[i].first, 0, totalForce * len / mesh.height());
+        PeriodicPairs pairs = findPeriodicPairs(mesh);
+        if (pairs.corner < 0) return results;
+        solver.setDirichletBC(pairs.corner, 0, 0.0);
+        solver.setDirichletBC(pairs.corner, 1, 0.0);
+        for (const PeriodicLink& link : pairs.links) {
+            solver.setPeriodicBC(link.slave, link.master, 0, 0.0);
+            solver.setPeriodicBC(link.slave, link.master, 1, 0.0);
+        }
+        solver.applyBC();
+        
+        for (int k = 0; k < 3; k++) {
+            Eigen::Vector3d E = Eigen::Vector3d::Zero();
+            E(k) = eps;
+            for (const PeriodicLink& link : pairs.links) {
+                U0(mesh.dof(link.slave, 0), k) = periodicOffset(link, 0, E);
+                U0(mesh.dof(link.slave, 1), k) = periodicOffset(link, 1, E);
+            }
+        }
+        out() << "Périodicité : " << pairs.links.size() << " couples de noeuds" << endl;
+        
+        // Contrainte moyenne : moyenne volumique des contraintes élémentaires
+        Eigen::MatrixXd U = solver.solveMultiple(F, U0);
+        PostProcessor post(mesh);
+        for (int k = 0; k < 3; k++) {
+            post.compute(U.col(k));
+            Eigen::Vector3d sigma(post.average(post.stressXX), post.average(post.stressYY), post.average(post.stressXY));
+            C_eff.col(k) = sigma / eps;
+        }
+    } else {
+        // Déplacements affines imposés sur tout le bord : u = E x (conditions homogènes au contour)
+        vector<int> boundary;
+        for (const vector<int>* side : {&mesh.leftNodes, &mesh.rightNodes, &mesh.bottomNodes, &mesh.topNodes}) {
+            boundary.insert(boundary.end(), side->begin(), side->end());
+        }
+        sort(boundary.begin(), boundary.end());
+        boundary.erase(unique(boundary.begin(), boundary.end()), boundary.end());
+        
+        for (int id : boundary) {
+            solver.setDirichletBC(id, 0, 0.0);
+            solver.setDirichletBC(id, 1, 0.0);
+        }
+        solver.applyBC();
+        
+        for (int id : boundary) {
+            int slot = mesh.nodeSlot(id);
+            double x = mesh.nodeX[slot] - mesh.xMin;
+            double y = mesh.nodeY[slot] - mesh.yMin;
+            U0(2*slot, 0) = eps * x;
+            U0(2*slot+1, 1) = eps * y;
+            U0(2*slot, 2) = 0.5 * eps * y;
+            U0(2*slot+1, 2) = 0.5 * eps * x;
+        }
+        
+        Eigen::MatrixXd U = solver.solveMultiple(F, U0);
+        Eigen::MatrixXd R = solver.applyStiffness(U) - F;
+        
+        // Contrainte moyenne à partir des réactions au bord : sigma = (1/A) somme R ⊗ x
+        double A = mesh.width() * mesh.height();
+        for (int k = 0; k < 3; k++) {
+            Eigen::Vector3d sigma = Eigen::Vector3d::Zero();
+            for (int id : boundary) {
+                int slot = mesh.nodeSlot(id);
+                double x = mesh.nodeX[slot] - mesh.xMin;
+                double y = mesh.nodeY[slot] - mesh.yMin;
+                double rx = R(2*slot, k), ry = R(2*slot+1, k);
+                sigma(0) += rx * x;
+                sigma(1) += ry * y;
+                sigma(2) += 0.5 * (rx * y + ry * x);
+            }
+            C_eff.col(k) = sigma / (A * eps);
+        }
+    }
+    
+    effectiveProperties(C_eff, results);
+    return results;
+}
+
+TestResults runFFTHomogenization(const string& meshFile, const Config& config) {
+    out() << "=== Homogénéisation spectrale (FFT, Lippmann-Schwinger) ===" << endl;
+    out() << "Géométrie: " << meshFile << endl;
+    TestResults results;
+    
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
+    
+    PhaseMap phases;
+    vector<Eigen::Matrix3d> stiffness;
+    int fiberPhase;
+    if (!buildPhaseMap(meshFile, config, PixelSizing::FFT, matrix, fiber, phases, stiffness, fiberPhase)) return results;
+    out() << "Pixels: " << phases.width << " x " << phases.height << ", fraction de fibre: " << phases.fraction(fiberPhase)
+          << "\n" << endl;
+    
+    FFTHomogenization fft(phases, stiffness);
+    fft.setLog(&out());
+    fft.setTolerance(config.fftTolerance);
+    fft.setMaxIterations(config.fftMaxIterations);
+    auto t0 = chrono::high_resolution_clock::now();
+    Eigen::Matrix3d C_eff = fft.effectiveStiffness();
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    out() << "3 cas de charge : " << fft.totalIterations() << " itérations, " << elapsed.count() << " s" << endl;
+    effectiveProperties(C_eff, results);
+    results["fraction"] = phases.fraction(fiberPhase);
+    results["iterations"] = fft.totalIterations();
+    
+    // Essai de traction éléments finis sur la même géométrie (bord gauche encastré : module
+    // apparent, légèrement différent du module périodique)
+    if (config.fftCrossCheck && config.fftPhases == "geometry") {
+        out() << "\n=== Comparaison à l'essai composite (éléments finis) ===" << endl;
+        TestResults fem = runCompositeTest(meshFile, config);
+        if (fem.count("E_eff")) {
+            out() << "\n  E_x FFT : " << results["E_x"] / 1e9 << " GPa, E_eff éléments finis : " << fem["E_eff"] / 1e9
+                  << " GPa (écart " << 100.0 * (results["E_x"] - fem["E_eff"]) / fem["E_eff"] << " %)" << endl;
+            results["E_eff_fem"] = fem["E_eff"];
+        }
+    }
+    return results;
+}
+
+TestResults runPixelGridTest(const string& meshFile, const Config& config) {
+    out() << "=== Homogénéisation sur grille de pixels (Q4, périodique) ===" << endl;
+    out() << "Géométrie: " << meshFile << endl;
+    TestResults results;
+    
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
+    PhaseMap phases;
+    vector<Eigen::Matrix3d> stiffness;
+    int fiberPhase;
+    if (!buildPhaseMap(meshFile, config, PixelSizing::MULTIGRID, matrix, fiber, phases, stiffness, fiberPhase)) {
+        return results;
     }
+    out() << "Pixels: " << phases.width << " x " << phases.height << ", fraction de fibre: " << phases.fraction(fiberPhase)
+          << endl;
     
+    auto t0 = chrono::high_resolution_clock::now();
+    PixelGridSolver solver(phases, stiffness);
+    if (!solver.isValid()) return results;
+    solver.setLog(&out());
+    solver.setTolerance(config.pixelTolerance);
+    solver.setMaxIterations(config.pixelMaxIterations);
+    chrono::duration<double> setup = chrono::high_resolution_clock::now() - t0;
+    solver.printHierarchy(out());
+    double dofs = solver.nbDofs();
+    out() << "DDL: " << solver.nbDofs() << ", mémoire : opérateur " << solver.operatorMemory() / dofs
+          << " octets/DDL, multigrille " << solver.workMemory() / dofs << " octets/DDL, préparation "
+          << setup.count() << " s\n" << endl;
+    
+    t0 = chrono::high_resolution_clock::now();
+    Eigen::Matrix3d C_eff = solver.effectiveStiffness();
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    out() << "3 cas de charge : " << solver.totalIterations() << " itérations, " << elapsed.count() << " s" << endl;
+    effectiveProperties(C_eff, results);
+    results["fraction"] = phases.fraction(fiberPhase);
+    results["iterations"] = solver.totalIterations();
+    return results;
+}
+
+TestResults runBenchmark(const string& meshFile, const Config& config) {
+    out() << "=== Benchmark d'assemblage ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
+    
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
+    
+    Mesh mesh;
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &matrix}, {2, &fiber}}, prolongations)) return results;
+    mesh.keepElementMatrices = config.elementMatrixCache;
+    mesh.initializeElements();
+    mesh.computeGeometry();
+    
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
+    out() << "Mémoire maillage: " << mesh.memoryUsage() / 1024.0 << " Ko\n" << endl;
+    
+    int repeat = max(1, config.benchmarkRepeat);
+    typedef chrono::high_resolution_clock Clock;
+    auto seconds = [](Clock::time_point a, Clock::time_point b) {
+        return chrono::duration<double>(b - a).count();
+    };
+    
+    // Référence : assemblage par triplets + setFromTriplets
+    auto t0 = Clock::now();
+    Eigen::SparseMatrix<double> Kref(mesh.nbDofs(), mesh.nbDofs());
+    for (int r = 0; r < repeat; r++) {
+        vector<Eigen::Triplet<double>> triplets;
+        triplets.reserve(36 * mesh.nbElements());
+        ElementMatrix Ke;
+        for (int e = 0; e < mesh.nbElements(); e++) {
+            mesh.elementStiffness(e, Ke);
+            const int32_t* n = mesh.elementNodes(e);
+            for (int i = 0; i < 6; i++) {
+                for (int j = 0; j < 6; j++) {
+                    triplets.push_back(Eigen::Triplet<double>(2*n[i/2] + i%2, 2*n[j/2] + j%2, Ke(i, j)));
+                }
+            }
+        }
+        Kref.setFromTriplets(triplets.begin(), triplets.end());
+    }
+    auto t1 = Clock::now();
+    
+    // Assemblage symbolique (une fois) puis numérique (répété)
+    Solver solver(mesh);
+    solver.setLog(&out());
+    auto t2 = Clock::now();
+    solver.symbolicAssembly();
+    auto t3 = Clock::now();
+    for (int r = 0; r < repeat; r++) solver.numericAssembly();
+    auto t4 = Clock::now();
+    
+    // Changement de paramètre : seules les valeurs sont recalculées
+    fiber.E *= 1.5;
+    if (config.elementMatrixCache) mesh.initializeElements();
+    auto t5 = Clock::now();
+    solver.numericAssembly();
+    auto t6 = Clock::now();
+    
+    out() << "=== Résultats (" << repeat << " répétitions) ===" << endl;
+    out() << "  Triplets + setFromTriplets : " << seconds(t0, t1) / repeat * 1e3 << " ms / assemblage" << endl;
+    out() << "  Symbolique (une fois)      : " << seconds(t2, t3) * 1e3 << " ms" << endl;
+    out() << "  Numérique (dispersion)     : " << seconds(t3, t4) / repeat * 1e3 << " ms / assemblage" << endl;
+    out() << "  Réassemblage (E_fiber x1.5): " << seconds(t5, t6) * 1e3 << " ms" << endl;
+    out() << "  Accélération numérique     : " << seconds(t0, t1) / max(seconds(t3, t4), 1e-12) << "x" << endl;
+    
+    // Produit matrice-vecteur : CSR (Eigen) contre blocs 2x2, sur le matériau de Kref
+    fiber.E /= 1.5;
+    if (config.elementMatrixCache) mesh.initializeElements();
+    BlockSparseMatrix Kb;
+    Kb.symbolic(mesh);
+    Kb.assemble(mesh);
+    Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(mesh.nbDofs(), 0.0, 1.0), yCsr, yBsr;
+    int products = 20 * repeat;
+    auto t7 = Clock::now();
+    for (int r = 0; r < products; r++) yCsr.noalias() = Kref * x;
+    auto t8 = Clock::now();
+    for (int r = 0; r < products; r++) Kb.apply(x, yBsr);
+    auto t9 = Clock::now();
+    
+    double flops = 2.0 * Kref.nonZeros();
+    double csrIndex = (Kref.nonZeros() + Kref.outerSize() + 1) * sizeof(int);
+    out() << "\n=== Produit matrice-vecteur (" << products << " produits) ===" << endl;
+    out() << "  CSR : " << seconds(t7, t8) / products * 1e3 << " ms, "
+           << flops * products / seconds(t7, t8) * 1e-9 << " GFlop/s, indices " << csrIndex / 1024.0 << " Ko" << endl;
+    out() << "  BSR : " << seconds(t8, t9) / products * 1e3 << " ms, "
+           << flops * products / seconds(t8, t9) * 1e-9 << " GFlop/s, indices " << Kb.indexBytes() / 1024.0 << " Ko"
+           << (BlockSparseMatrix::usesAVX2() ? " (AVX2)" : "") << endl;
+    out() << "  Écart relatif BSR/CSR : " << (yBsr - yCsr).norm() / yCsr.norm() << endl;
+    
+    // Gradient conjugué double contre précision mixte : encastrement à gauche, traction à droite
+    out() << "\n=== Gradient conjugué : double / précision mixte ===" << endl;
+    solver.numericAssembly();
+    for (int id : mesh.leftNodes) {
+        solver.setDirichletBC(id, 0, 0.0);
+        solver.setDirichletBC(id, 1, 0.0);
+    }
+    for (int id : mesh.rightNodes) solver.setNeumannBC(id, 0, config.forceValue / mesh.rightNodes.size());
     solver.applyBC();
+    
+    auto t10 = Clock::now();
     solver.solveConjugateGradient();
-    solver.saveResults(config.outputDir + "/displacement_" + config.outputFilePrefix + ".txt");
-    solver.saveVTK(config.outputDir + "/results_" + config.outputFilePrefix + ".vtk");
+    auto t11 = Clock::now();
+    Eigen::VectorXd Udouble = solver.getU();
+    solver.solveMixedPrecision();
+    auto t12 = Clock::now();
+    Eigen::VectorXd Umixed = solver.getU();
     
-    // Résultats
-    Eigen::VectorXd U = solver.getU();
-    auto calcDisp = [&](const vector<int>& nodes, int dof) {
-        double sum = 0;
-        for (int id : nodes) sum += U(2*(id-1) + dof);
-        return sum / nodes.size();
-    };
+    out() << "  Double : " << seconds(t10, t11) * 1e3 << " ms, mixte : " << seconds(t11, t12) * 1e3 << " ms" << endl;
+    out() << "  Écart relatif sur U : " << (Umixed - Udouble).norm() / Udouble.norm() << endl;
     
-    double ux = calcDisp(mesh.rightNodes, 0);
-    double uy = (abs(calcDisp(mesh.topNodes, 1)) + abs(calcDisp(mesh.bottomNodes, 1))) / 2.0;
+    results["assemblage_triplets_s"] = seconds(t0, t1) / repeat;
+    results["assemblage_numerique_s"] = seconds(t3, t4) / repeat;
+    results["cg_double_s"] = seconds(t10, t11);
+    results["cg_mixte_s"] = seconds(t11, t12);
+    return results;
+}
+
+// Valeur du paramètre balayé affectée au matériau correspondant
+static void setSweepValue(Material& matrix, Material& fiber, const string& parameter, double value) {
+    if (parameter == "Young_modulus") matrix.E = value;
+    else if (parameter == "Poisson_ratio") matrix.nu = value;
+    else if (parameter == "Young_modulus_fiber") fiber.E = value;
+    else if (parameter == "Poisson_ratio_fiber") fiber.nu = value;
+}
+
+TestResults runSweep(const string& meshFile, const Config& config) {
+    out() << "=== Balayage paramétrique (essai composite) : " << config.sweepParameter << " ===" << endl;
+    out() << "Maillage: " << meshFile << endl;
+    TestResults results;
+    if (config.testType != "composite") {
+        cerr << "Attention : le balayage utilise l'essai composite (test_type = " << config.testType << " ignoré)" << endl;
+    }
     
-    // Calcul des propriétés effectives
-    double L = mesh.width();
-    double H = mesh.height();
-    double A = H;  // épaisseur unité
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
     
-    // Déformations moyennes
-    double epsilon_x = ux / L;
-    double epsilon_y = -uy / (H/2.0);
+    // Maillage lu une seule fois ; les Ke dépendent du matériau et ne sont pas conservées
+    Mesh mesh;
+    vector<Eigen::SparseMatrix<double>> prolongations;
+    if (!loadMesh(mesh, meshFile, config.refine, config, {{1, &matrix}, {2, &fiber}}, prolongations)) return results;
+    if (config.elementMatrixCache) cerr << "Attention : cache Ke désactivé pour le balayage" << endl;
+    mesh.keepElementMatrices = false;
+    mesh.initializeElements();
+    mesh.computeGeometry();
+    mesh.buildNodeElements();
+    mesh.computeColoring();
     
-    // Contrainte appliquée
-    double sigma_x = totalForce / A; 
+    out() << "Noeuds: " << mesh.nbNodes() << ", Eléments: " << mesh.nbElements() << endl;
     
-    // Propriétés effectives homogénéisées
-    double E_eff = sigma_x / epsilon_x;            // Module de Young effectif
-    double nu_eff = -epsilon_y / epsilon_x;        // Coefficient de Poisson effectif
+    int n = config.sweepCount;
+    vector<double> values(n), E_eff(n), nu_eff(n), elapsed(n);
+    vector<int> worker(n);
+    vector<string> logs(n);
+    for (int k = 0; k < n; k++) values[k] = config.sweepValue(k);
     
-    cout << "\n=== Résultats ===" << endl;
-    cout << "Déplacements :" << endl;
-    cout << "  Allongement moyen x : " << ux << " m (" << epsilon_x*100 << "%)" << endl;
-    cout << "  Contraction moyenne y : " << uy << " m (" << epsilon_y*100 << "%)" << endl;
+    typedef chrono::high_resolution_clock Clock;
+    auto t0 = Clock::now();
+    int workers = 1;
     
-    cout << "\n=== Propriétés effectives du composite ===" << endl;
-    cout << "  Module de Young effectif (E_eff) : " << E_eff/1e9 << " GPa" << endl;
-    cout << "  Coefficient de Poisson effectif (ν_eff) : " << nu_eff << endl;
+    // Un état par thread, construit une fois : copie du maillage liée à ses propres matériaux
+    // et solveur dont la structure de K, la table de dispersion et l'analyse symbolique de
+    // Cholesky sont conservées d'un point à l'autre. Seules les valeurs sont recalculées.
+    // Les points sont distribués dynamiquement ; les messages du solveur vont dans un tampon
+    // propre au thread, recopié ensuite dans le journal dans l'ordre des points.
+    #pragma omp parallel
+    {
+        #pragma omp single
+        workers = teamSize();
+        
+        Material localMatrix(matrix), localFiber(fiber);
+        Mesh local(mesh);
+        for (size_t i = 0; i < local.materials.size(); i++) {
+            if (local.materials[i] == &matrix) local.materials[i] = &localMatrix;
+            else if (local.materials[i] == &fiber) local.materials[i] = &localFiber;
+        }
+        
+        ostringstream log;
+        Solver solver(local);
+        solver.setLog(&log);
+        solver.setSolverMode(config.solverMode);
+        solver.setBCMethod(config.bcMethod);
+        solver.setLinearSolver(config.linearSolver);
+        solver.setAMGSmoother(config.amgSmoother);
+        solver.setProlongations(prolongations);
+        solver.setMatrixFormat(config.matrixFormat);
+        solver.setPrecision(config.precision);
+        solver.setCGImplementation(config.cgImplementation);
+        applyCompositeLoads(solver, local, config.forceValue);
+        
+        #pragma omp for schedule(dynamic, 1)
+        for (int k = 0; k < n; k++) {
+            auto t1 = Clock::now();
+            setSweepValue(localMatrix, localFiber, config.sweepParameter, values[k]);
+            solver.assemble();
+            solver.applyBC();
+            solver.solve();
+            CompositeResponse response = compositeResponse(local, solver.getU(), config.forceValue);
+            E_eff[k] = response.E_eff;
+            nu_eff[k] = response.nu_eff;
+            elapsed[k] = chrono::duration<double>(Clock::now() - t1).count();
+            worker[k] = threadId();
+            logs[k] = log.str();
+            log.str("");
+        }
+    }
+    double total = chrono::duration<double>(Clock::now() - t0).count();
     
-    // Comparaison avec la matrice pure
-    cout << "\nComparaison avec matrice pure :" << endl;
-    cout << "  E_eff/E_matrix: " << E_eff/config.E << " (rigidification)" << endl;
-    cout << "  ν_eff - ν_matrix: " << (nu_eff - config.nu) << endl;
+    // Tableau consolidé
+    string base = config.outputDir + "/sweep_" + config.outputFilePrefix;
+    ofstream table(base + ".txt");
+    ofstream journal(base + ".log");
+    if (!table.is_open() || !journal.is_open()) {
+        cerr << "Attention : impossible d'écrire " << base << ".txt/.log" << endl;
+    }
+    table << "# " << config.sweepParameter << " E_eff(Pa) nu_eff temps(s)" << endl;
+    
+    out() << "\n=== Résultats du balayage ===" << endl;
+    out() << "  " << config.sweepParameter << " | E_eff (GPa) | ν_eff | temps (ms) | thread" << endl;
+    double sum = 0.0;
+    for (int k = 0; k < n; k++) {
+        out() << "  " << values[k] << " | " << E_eff[k] / 1e9 << " | " << nu_eff[k] << " | "
+               << elapsed[k] * 1e3 << " | " << worker[k] << endl;
+        table << values[k] << " " << E_eff[k] << " " << nu_eff[k] << " " << elapsed[k] << endl;
+        journal << "=== Point " << k << " : " << config.sweepParameter << " = " << values[k] << " ===\n" << logs[k];
+        sum += elapsed[k];
+    }
+    out() << "  " << n << " points en " << total << " s sur " << workers << " threads (somme des points : "
+           << sum << " s)" << endl;
+    out() << "Tableau : " << base << ".txt, journal du solveur : " << base << ".log" << endl;
+    
+    results["points"] = n;
+    results["temps_s"] = total;
+    return results;
+}
 
+// Quantile à 97,5 % de la loi de Student à dof degrés de liberté : table jusqu'à 10, puis
+// développement de Cornish-Fisher autour de la loi normale (erreur < 0,1 %)
+static double student975(int dof) {
+    static const double table[10] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228};
+    if (dof <= 10) return table[max(dof, 1) - 1];
+    double z = 1.959964, z3 = z * z * z, z5 = z3 * z * z;
+    double d = dof;
+    return z + (z3 + z) / (4.0 * d) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * d * d);
 }
 
+// Moyenne et variance courantes (algorithme de Welford)
+struct RunningStats {
+    int n;
+    double mean, m2;
+    RunningStats() : n(0), mean(0.0), m2(0.0) {}
+    void add(double x) {
+        n++;
+        double delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
+    // Demi-largeur de l'intervalle de confiance à 95 % sur la moyenne
+    double halfWidth() const { return n < 2 ? 0.0 : student975(n - 1) * sqrt(m2 / (n - 1) / n); }
+};
+
+// Une réalisation de l'ensemble : VER unité maillé par meshFiberRVE (interfaces conformes,
+// mêmes tailles que mesh_size_* ; la topologie change d'une réalisation à l'autre), puis essai
+// de traction composite. fraction reçoit la fraction surfacique de fibre du maillage.
+// Retourne false si le maillage échoue.
+static bool ensembleRealization(const vector<Fiber>& fibers, Material& matrix, Material& fiber, const Config& config,
+                                double& E_eff, double& nu_eff, double& fraction) {
+    ostringstream log;
+    MesherOptions options;
+    options.sizeInterface = config.meshSizeInterface;
+    options.sizeMax = config.meshSizeMax;
+    options.grading = config.meshGrading;
+    options.minAngle = config.meshMinAngle;
+    Mesh mesh;
+    if (!meshFiberRVE(mesh, fibers, 0.0, 0.0, 1.0, 1.0, options, &matrix, &fiber, log)) return false;
+    mesh.initializeElements();
+    mesh.computeGeometry();
+    
+    double fiberArea = 0.0, total = 0.0;
+    for (int e = 0; e < mesh.nbElements(); e++) {
+        total += mesh.elementArea[e];
+        if (mesh.materials[mesh.elementMaterial[e]] == &fiber) fiberArea += mesh.elementArea[e];
+    }
+    fraction = total > 0.0 ? fiberArea / total : 0.0;
+    
+    Solver solver(mesh);
+    solver.setLog(&log);
+    solver.setSolverMode(config.solverMode);
+    solver.setBCMethod(config.bcMethod);
+    solver.setLinearSolver(config.linearSolver);
+    solver.setAMGSmoother(config.amgSmoother);
+    solver.setMatrixFormat(config.matrixFormat);
+    solver.setPrecision(config.precision);
+    solver.setCGImplementation(config.cgImplementation);
+    solver.assemble();
+    applyCompositeLoads(solver, mesh, config.forceValue);
+    solver.applyBC();
+    solver.solve();
+    CompositeResponse response = compositeResponse(mesh, solver.getU(), config.forceValue);
+    E_eff = response.E_eff;
+    nu_eff = response.nu_eff;
+    return true;
+}
+
+TestResults runEnsemble(const Config& config) {
+    out() << "=== Ensemble de VER aléatoires (essai composite) ===" << endl;
+    TestResults results;
+    
+    vector<vector<Fiber>> layouts;
+    int maxCount = config.ensembleMax;
+    if (!config.ensembleLayouts.empty()) {
+        layouts = loadFiberLayouts(config.ensembleLayouts);
+        if (layouts.empty()) return results;
+        maxCount = min(maxCount, (int)layouts.size());
+        out() << "Arrangements lus : " << layouts.size() << " dans " << config.ensembleLayouts << endl;
+    }
+    
+    Material matrix(config.E, config.nu, config.rho);
+    Material fiber(config.E_fiber, config.nu_fiber, config.rho_fiber);
+    
+    // Réalisations calculées par vagues d'une par thread ; les statistiques sont mises à jour
+    // dans l'ordre des indices et l'arrêt est décidé réalisation par réalisation, si bien que
+    // le résultat ne dépend pas du nombre de threads (les réalisations d'une vague au-delà du
+    // point d'arrêt sont ignorées)
+    int threads = numThreads();
+    vector<char> meshed(maxCount);
+    vector<double> E_eff(maxCount), nu_eff(maxCount), fraction(maxCount);
+    vector<int> fiberCount(maxCount);
+    RunningStats statsE, statsNu;
+    int used = 0;
+    bool converged = false;
+    
+    string base = config.outputDir + "/ensemble_" + config.outputFilePrefix;
+    ofstream table(base + ".txt");
+    table << "# realisation fibres fraction E_eff(Pa) nu_eff moyenne_E ic95_E moyenne_nu ic95_nu" << endl;
+    out() << "  k | fibres | Vf | E_eff (GPa) | ν_eff | moyenne E ± IC95 | moyenne ν ± IC95" << endl;
+    
+    auto t0 = chrono::high_resolution_clock::now();
+    for (int next = 0; next < maxCount && !converged; next += threads) {
+        int last = min(next + threads, maxCount);
+        
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int k = next; k < last; k++) {
+            vector<Fiber> fibers = layouts.empty()
+                ? randomFiberLayout(config.fiberFraction, config.fiberRadius, config.fiberGap, config.ensembleSeed + (uint64_t)k)
+                : layouts[k];
+            fiberCount[k] = fibers.size();
+            meshed[k] = ensembleRealization(fibers, matrix, fiber, config, E_eff[k], nu_eff[k], fraction[k]);
+        }
+        
+        for (int k = next; k < last && !converged; k++) {
+            if (!meshed[k]) {
+                cerr << "Erreur : maillage de la réalisation " << k << " impossible, arrêt de l'ensemble" << endl;
+                return results;
+            }
+            statsE.add(E_eff[k]);
+            statsNu.add(nu_eff[k]);
+            used = k + 1;
+            double hE = statsE.halfWidth(), hNu = statsNu.halfWidth();
+            out() << "  " << k << " | " << fiberCount[k] << " | " << fraction[k] << " | " << E_eff[k] / 1e9 << " | "
+                  << nu_eff[k] << " | " << statsE.mean / 1e9 << " ± " << hE / 1e9 << " | "
+                  << statsNu.mean << " ± " << hNu << endl;
+            table << k << " " << fiberCount[k] << " " << fraction[k] << " " << E_eff[k] << " " << nu_eff[k] << " "
+                  << statsE.mean << " " << hE << " " << statsNu.mean << " " << hNu << endl;
+            converged = used >= config.ensembleMin && hE <= config.ensembleTolerance * abs(statsE.mean)
+                        && hNu <= config.ensembleTolerance * abs(statsNu.mean);
+        }
+    }
+    chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - t0;
+    
+    double hE = statsE.halfWidth(), hNu = statsNu.halfWidth();
+    out() << "\n=== Propriétés effectives de l'ensemble ===" << endl;
+    out() << "  Réalisations : " << used << (converged ? " (intervalle de confiance atteint)" : " (maximum atteint)")
+          << ", " << elapsed.count() << " s sur " << threads << " threads" << endl;
+    out() << "  E_eff : " << statsE.mean / 1e9 << " ± " << hE / 1e9 << " GPa (IC 95 %, "
+          << 100.0 * hE / abs(statsE.mean) << " %)" << endl;
+    out() << "  ν_eff : " << statsNu.mean << " ± " << hNu << " (IC 95 %, " << 100.0 * hNu / abs(statsNu.mean) << " %)" << endl;
+    out() << "  Écart-type entre réalisations : E " << sqrt(statsE.m2 / max(used - 1, 1)) / 1e9 << " GPa, ν "
+          << sqrt(statsNu.m2 / max(used - 1, 1)) << endl;
+    out() << "Tableau : " << base << ".txt" << endl;
+    
+    results["realisations"] = used;
+    results["E_eff"] = statsE.mean;
+    results["E_eff_ic95"] = hE;
+    results["nu_eff"] = statsNu.mean;
+    results["nu_eff_ic95"] = hNu;
+    return results;
+}
+
+TestResults runTest(const Config& config) {
+    // Maillage généré : l'image ou le fichier de cercles tient lieu de fichier de maillage dans les messages
+    const string& meshFile = !config.meshImage.empty() ? config.meshImage
+                           : (config.meshCircles.empty() ? config.meshFile : config.meshCircles);
+    if (config.sweepCount > 0) return runSweep(meshFile, config);
+    if (config.testType == "flexion") return runFlexionTest(meshFile, config);
+    if (config.testType == "composite") return runCompositeTest(meshFile, config);
+    if (config.testType == "homogenization") return runHomogenizationTest(meshFile, config);
+    if (config.testType == "fft") return runFFTHomogenization(meshFile, config);
+    if (config.testType == "pixel") return runPixelGridTest(meshFile, config);
+    if (config.testType == "ensemble") return runEnsemble(config);
+    if (config.testType == "benchmark") return runBenchmark(meshFile, config);
+    return runTractionTest(meshFile, config);
+}
+
+int runDetection(const string& imageFile, const string& circlesFile, const Config& config) {
+    GrayImage image;
+    if (!readImage(imageFile, image)) return 1;
+    vector<Fiber> fibers;
+    if (!detectFibersChecked(image, config, fibers)) return 1;
+    if (!writeFibers(circlesFile, fibers)) return 1;
+    out() << "Paramètres des cercles (x y r, en pixels) écrits dans " << circlesFile << endl;
+    return 0;
+}
@@ -3,10 +3,45 @@
 
 #include "Config.h"
 #include <string>
+#include <map>
+#include <iostream>
+
+class MeshCache;
+
+// Résultats scalaires d'un test (nom -> valeur), repris dans le résumé du mode batch
+typedef std::map<std::string, double> TestResults;
 
 // Fonctions de test pour différents cas de charge
-void runTractionTest(const std::string& meshFile, const Config& config);
-void runCompositeTest(const std::string& meshFile, const Config& config);
-void runFlexionTest(const std::string& meshFile, const Config& config);
+TestResults runTractionTest(const std::string& meshFile, const Config& config);
+TestResults runCompositeTest(const std::string& meshFile, const Config& config);
+TestResults runFlexionTest(const std::string& meshFile, const Config& config);
+TestResults runHomogenizationTest(const std::string& meshFile, const Config& config);
+// Homogénéisation spectrale sur une image de phases (test_type = fft), conditions périodiques ;
+// fft_cross_check : essai composite éléments finis sur la même géométrie
+TestResults runFFTHomogenization(const std::string& meshFile, const Config& config);
+// Même image de phases résolue par éléments finis Q4 sur la grille de pixels (test_type = pixel),
+// préconditionneur multigrille, conditions périodiques
+TestResults runPixelGridTest(const std::string& meshFile, const Config& config);
+TestResults runBenchmark(const std::string& meshFile, const Config& config);
+
+// Balayage d'un paramètre matériau sur l'essai composite (config.sweepCount > 0)
+TestResults runSweep(const std::string& meshFile, const Config& config);
+
+// Ensemble de VER à arrangements de fibres aléatoires (test_type = ensemble) : moyennes et
+// intervalles de confiance de E_eff et nu_eff, arrêt dès la précision demandée atteinte
+TestResults runEnsemble(const Config& config);
+
+// Détection des fibres d'une micrographie (paramètres detect_* de config), écrites au format
+// cercles.txt. Retourne 0 en cas de succès.
+int runDetection(const std::string& imageFile, const std::string& circlesFile, const Config& config);
+
+// Test choisi par la configuration (balayage, puis test_type)
+TestResults runTest(const Config& config);
+
+// Messages des tests exécutés par le thread courant (nullptr : std::cout)
+void setTestOutput(std::ostream* output);
+
+// Cache de maillages partagé par tous les threads (nullptr : chaque test lit son fichier)
+void setMeshCache(MeshCache* cache);
 
 #endif
@@ -0,0 +1,216 @@
+#include "VTUWriter.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const char* byteOrder() {
+    const uint16_t one = 1;
+    return *reinterpret_cast<const char*>(&one) ? "LittleEndian" : "BigEndian";
+}
+
+// Tableau de la section appended : taille en octets (UInt64) puis données
+template <typename T>
+void appendArray(vector<char>& buffer, const vector<T>& values) {
+    uint64_t bytes = values.size() * sizeof(T);
+    const char* size = reinterpret_cast<const char*>(&bytes);
+    buffer.insert(buffer.end(), size, size + sizeof(bytes));
+    const char* data = reinterpret_cast<const char*>(values.data());
+    buffer.insert(buffer.end(), data, data + bytes);
+}
+
+void dataArray(ostringstream& xml, const string& type, const string& name, int components, size_t offset) {
+    xml << "        <DataArray type=\"" << type << "\"";
+    if (!name.empty()) xml << " Name=\"" << name << "\"";
+    xml << " NumberOfComponents=\"" << components << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+}
+
+string pieceName(const string& base, int k) {
+    return base + "_" + to_string(k) + ".vtu";
+}
+
+}
+
+void VTUWriter::addPointData(const string& name, int components, const double* values) {
+    Field f;
+    f.name = name;
+    f.components = components;
+    f.values.assign(values, values + (size_t)components * _mesh.nbNodes());
+    _pointData.push_back(f);
+}
+
+void VTUWriter::addCellData(const string& name, int components, const double* values) {
+    Field f;
+    f.name = name;
+    f.components = components;
+    f.values.assign(values, values + (size_t)components * _mesh.nbElements());
+    _cellData.push_back(f);
+}
+
+void VTUWriter::addCellData(const string& name, const vector<int>& values) {
+    Field f;
+    f.name = name;
+    f.components = 1;
+    f.integers.assign(values.begin(), values.end());
+    _cellData.push_back(f);
+}
+
+bool VTUWriter::writePiece(const string& filename, int firstElement, int lastElement) const {
+    int ne = lastElement - firstElement;
+    bool whole = (firstElement == 0 && lastElement == _mesh.nbElements());
+
+    // Noeuds du morceau, numérotés dans l'ordre des slots
+    vector<int> nodes;
+    vector<int> localIndex;
+    if (whole) {
+        nodes.resize(_mesh.nbNodes());
+        for (int i = 0; i < _mesh.nbNodes(); i++) nodes[i] = i;
+    } else {
+        localIndex.assign(_mesh.nbNodes(), -1);
+        for (int e = firstElement; e < lastElement; e++) {
+            const int32_t* n = _mesh.elementNodes(e);
+            for (int a = 0; a < 3; a++) localIndex[n[a]] = 0;
+        }
+        for (int i = 0; i < _mesh.nbNodes(); i++) {
+            if (localIndex[i] >= 0) {
+                localIndex[i] = nodes.size();
+                nodes.push_back(i);
+            }
+        }
+    }
+    int nn = nodes.size();
+
+    vector<float> points(3 * (size_t)nn);
+    for (int k = 0; k < nn; k++) {
+        points[3*k] = _mesh.nodeX[nodes[k]];
+        points[3*k + 1] = _mesh.nodeY[nodes[k]];
+        points[3*k + 2] = 0.0f;
+    }
+    vector<int32_t> connectivity(3 * (size_t)ne), offsets(ne);
+    vector<uint8_t> types(ne, 5);  // VTK_TRIANGLE
+    for (int e = 0; e < ne; e++) {
+        const int32_t* n = _mesh.elementNodes(firstElement + e);
+        for (int a = 0; a < 3; a++) connectivity[3*e + a] = whole ? n[a] : localIndex[n[a]];
+        offsets[e] = 3 * (e + 1);
+    }
+
+    // Section appended et en-tête XML construits ensemble (décalages en octets)
+    vector<char> appended;
+    ostringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << byteOrder() << "\" header_type=\"UInt64\">\n"
+        << "  <UnstructuredGrid>\n"
+        << "    <Piece NumberOfPoints=\"" << nn << "\" NumberOfCells=\"" << ne << "\">\n";
+
+    xml << "      <PointData>\n";
+    for (const Field& f : _pointData) {
+        dataArray(xml, "Float32", f.name, f.components, appended.size());
+        vector<float> values(f.components * (size_t)nn);
+        for (int k = 0; k < nn; k++) {
+            memcpy(&values[f.components * (size_t)k], &f.values[f.components * (size_t)nodes[k]], f.components * sizeof(float));
+        }
+        appendArray(appended, values);
+    }
+    xml << "      </PointData>\n";
+
+    xml << "      <CellData>\n";
+    for (const Field& f : _cellData) {
+        if (!f.integers.empty()) {
+            dataArray(xml, "Int32", f.name, 1, appended.size());
+            appendArray(appended, vector<int32_t>(f.integers.begin() + firstElement, f.integers.begin() + lastElement));
+        } else {
+            dataArray(xml, "Float32", f.name, f.components, appended.size());
+            appendArray(appended, vector<float>(f.values.begin() + f.components * (size_t)firstElement,
+                                                f.values.begin() + f.components * (size_t)lastElement));
+        }
+    }
+    xml << "      </CellData>\n";
+
+    xml << "      <Points>\n";
+    dataArray(xml, "Float32", "", 3, appended.size());
+    appendArray(appended, points);
+    xml << "      </Points>\n";
+
+    xml << "      <Cells>\n";
+    dataArray(xml, "Int32", "connectivity", 1, appended.size());
+    appendArray(appended, connectivity);
+    dataArray(xml, "Int32", "offsets", 1, appended.size());
+    appendArray(appended, offsets);
+    dataArray(xml, "UInt8", "types", 1, appended.size());
+    appendArray(appended, types);
+    xml << "      </Cells>\n";
+
+    xml << "    </Piece>\n"
+        << "  </UnstructuredGrid>\n"
+        << "  <AppendedData encoding=\"raw\">\n_";
+
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << filename << endl;
+        return false;
+    }
+    string header = xml.str();
+    file.write(header.data(), header.size());
+    file.write(appended.data(), appended.size());
+    file << "\n  </AppendedData>\n</VTKFile>\n";
+    return (bool)file;
+}
+
+bool VTUWriter::write(const string& filename) const {
+    return writePiece(filename, 0, _mesh.nbElements());
+}
+
+bool VTUWriter::writePieces(const string& filename, int nbPieces) const {
+    int ne = _mesh.nbElements();
+    nbPieces = max(1, min(nbPieces, ne));
+
+    // Chemin des morceaux et nom relatif référencé par l'index
+    string base = filename;
+    size_t dot = base.rfind('.');
+    size_t slash = base.find_last_of('/');
+    if (dot != string::npos && (slash == string::npos || dot > slash)) base = base.substr(0, dot);
+    string relative = (slash == string::npos) ? base : base.substr(slash + 1);
+
+    bool ok = true;
+    #pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+    for (int k = 0; k < nbPieces; k++) {
+        int first = (int)((long long)ne * k / nbPieces);
+        int last = (int)((long long)ne * (k + 1) / nbPieces);
+        ok = writePiece(pieceName(base, k), first, last) && ok;
+    }
+    if (!ok) return false;
+
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Erreur : impossible d'ouvrir " << filename << endl;
+        return false;
+    }
+    file << "<?xml version=\"1.0\"?>\n"
+         << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byteOrder() << "\" header_type=\"UInt64\">\n"
+         << "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+         << "    <PPointData>\n";
+    for (const Field& f : _pointData) {
+        file << "      <PDataArray type=\"Float32\" Name=\"" << f.name << "\" NumberOfComponents=\"" << f.components << "\"/>\n";
+    }
+    file << "    </PPointData>\n"
+         << "    <PCellData>\n";
+    for (const Field& f : _cellData) {
+        file << "      <PDataArray type=\"" << (f.integers.empty() ? "Float32" : "Int32") << "\" Name=\"" << f.name
+             << "\" NumberOfComponents=\"" << f.components << "\"/>\n";
+    }
+    file << "    </PCellData>\n"
+         << "    <PPoints>\n"
+         << "      <PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n"
+         << "    </PPoints>\n";
+    for (int k = 0; k < nbPieces; k++) {
+        file << "    <Piece Source=\"" << pieceName(relative, k) << "\"/>\n";
+    }
+    file << "  </PUnstructuredGrid>\n"
+         << "</VTKFile>\n";
+    return (bool)file;
+}
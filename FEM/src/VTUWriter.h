@@ -0,0 +1,45 @@
+#ifndef VTU_WRITER_H
+#define VTU_WRITER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Mesh.h"
+
+class VTUWriter {
+    // Sortie VTK XML (UnstructuredGrid) : en-tête XML puis tous les tableaux en binaire brut
+    // dans une section "appended", écrits en un seul bloc. Les réels sont en Float32 (comme
+    // la sortie VTK historique), les indices en Int32.
+    // En plusieurs morceaux, les éléments sont découpés en plages contiguës : chaque morceau
+    // contient ses éléments et les noeuds qu'ils utilisent (renumérotés), les fichiers sont
+    // écrits en parallèle et indexés par un .pvtu.
+
+    private:
+        struct Field {
+            std::string name;
+            int components;
+            std::vector<float> values;
+            std::vector<int32_t> integers;  // champ entier si non vide
+        };
+
+        const Mesh& _mesh;
+        std::vector<Field> _pointData, _cellData;
+
+        bool writePiece(const std::string& filename, int firstElement, int lastElement) const;
+
+    public:
+        explicit VTUWriter(const Mesh& mesh) : _mesh(mesh) {}
+
+        // Valeurs rangées par noeud (slot) ou par élément, components valeurs consécutives
+        void addPointData(const std::string& name, int components, const double* values);
+        void addCellData(const std::string& name, int components, const double* values);
+        void addCellData(const std::string& name, const std::vector<int>& values);
+
+        // Fichier .vtu unique
+        bool write(const std::string& filename) const;
+
+        // filename : index .pvtu ; morceaux <base>_<k>.vtu dans le même répertoire
+        bool writePieces(const std::string& filename, int nbPieces) const;
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "Config.h"
 #include "Tests.h"
+#include "Batch.h"
+#include "Parallel.h"
 #include <iostream>
 
 using namespace std;
@@ -7,25 +9,42 @@ using namespace std;
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         cerr << "Usage: " << argv[0] << " <config_file.txt>" << endl;
+        cerr << "       " << argv[0] << " --batch <jobs.txt> [resume.jsonl]" << endl;
+        cerr << "       " << argv[0] << " --detect <image.png> [cercles.txt] [config_file.txt]" << endl;
         cerr << "  Exemple: " << argv[0] << " ../config/traction_config.txt" << endl;
         return 1;
     }
     
+    // Mode batch : une configuration par ligne du fichier de jobs
+    if (string(argv[1]) == "--batch") {
+        if (argc < 3) {
+            cerr << "Erreur : fichier de jobs manquant après --batch" << endl;
+            return 1;
+        }
+        return runBatch(argv[2], argc > 3 ? argv[3] : "batch_summary.jsonl") == 0 ? 0 : 1;
+    }
+    
+    // Détection des fibres d'une image, paramètres detect_* de la configuration éventuelle
+    if (string(argv[1]) == "--detect") {
+        if (argc < 3) {
+            cerr << "Erreur : image manquante après --detect" << endl;
+            return 1;
+        }
+        Config config;
+        if (argc > 4) config.loadFromFile(argv[4]);
+        return runDetection(argv[2], argc > 3 ? argv[3] : "cercles.txt", config);
+    }
+    
     string configFile = argv[1];
     
     // Charger la config
     Config config;
     config.loadFromFile(configFile);
     config.print();
+    setNumThreads(config.numThreads);
     
     // Exécuter le test approprié
-    if (config.testType == "flexion") {
-        runFlexionTest(config.meshFile, config);
-    } else if (config.testType == "composite") {
-        runCompositeTest(config.meshFile, config);
-    } else {
-        runTractionTest(config.meshFile, config);
-    }
+    runTest(config);
     
     return 0;
 }